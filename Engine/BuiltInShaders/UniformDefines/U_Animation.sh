@@ -0,0 +1,4 @@
+#define BONE_PALETTE_MAP_SLOT 4
+
+// Texels per row of the bone palette texture. A 3x4 bone matrix takes 3 texels, so it is a multiple of 3.
+#define BONE_PALETTE_TEXTURE_WIDTH 768
\ No newline at end of file
@@ -18,4 +18,9 @@ vec2  a_texcoord0        : TEXCOORD0;
 vec4  a_color0           : COLOR0;
 vec4  a_color1           : COLOR1;
 ivec4 a_indices          : BLENDINDICES;
-vec4  a_weight           : BLENDWEIGHT;
\ No newline at end of file
+vec4  a_weight           : BLENDWEIGHT;
+
+vec4  i_data0            : TEXCOORD7;
+vec4  i_data1            : TEXCOORD6;
+vec4  i_data2            : TEXCOORD5;
+vec4  i_data3            : TEXCOORD4;
\ No newline at end of file
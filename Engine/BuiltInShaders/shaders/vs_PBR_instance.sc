@@ -0,0 +1,34 @@
+$input a_position, a_normal, a_tangent, a_texcoord0, i_data0, i_data1, i_data2, i_data3
+$output v_worldPos, v_normal, v_texcoord0, v_TBN
+
+#include "../common/common.sh"
+
+void main()
+{
+	// World matrix columns come from the instance data buffer.
+	mat4 model = mtxFromCols(i_data0, i_data1, i_data2, i_data3);
+	vec4 worldPos = mul(model, vec4(a_position, 1.0));
+	gl_Position = mul(u_viewProj, worldPos);
+
+	v_worldPos = worldPos.xyz;
+
+	// There is no per instance inverse transpose matrix. The cofactor matrix is the inverse transpose
+	// scaled by the determinant, so normals only need a sign fix for mirrored instances.
+	vec3 axisX = i_data0.xyz;
+	vec3 axisY = i_data1.xyz;
+	vec3 axisZ = i_data2.xyz;
+	mat3 cofactor = mtxFromCols(cross(axisY, axisZ), cross(axisZ, axisX), cross(axisX, axisY));
+	float handedness = sign(dot(axisX, cross(axisY, axisZ)));
+
+	v_normal     = normalize(mul(cofactor, a_normal) * handedness);
+	vec3 tangent = normalize(mul(model, vec4(a_tangent, 0.0)).xyz);
+
+	// re-orthogonalize T with respect to N
+	tangent        = normalize(tangent - dot(tangent, v_normal) * v_normal);
+	vec3 biTangent = normalize(cross(v_normal, tangent));
+
+	// TBN
+	v_TBN = mtxFromCols(tangent, biTangent, v_normal);
+
+	v_texcoord0 = a_texcoord0;
+}
@@ -2,15 +2,31 @@ $input a_position, a_indices, a_weight
 $output v_worldPos
 
 #include "../common/common.sh"
+#include "../UniformDefines/U_Animation.sh"
 
-uniform mat4 u_boneMatrices[128];
+SAMPLER2D(s_texBonePalette, BONE_PALETTE_MAP_SLOT);
+
+// x : first texel of the draw's bone matrices, y : 1 / texture width, z : 1 / texture height.
+uniform vec4 u_bonePalette;
+
+mat4 GetBoneMatrix(float boneIndex)
+{
+	// Rows of a bone matrix are in the same texture row.
+	float texelIndex = u_bonePalette.x + boneIndex * 3.0;
+	float row = floor(texelIndex / float(BONE_PALETTE_TEXTURE_WIDTH));
+	vec2 uv = (vec2(texelIndex - row * float(BONE_PALETTE_TEXTURE_WIDTH), row) + 0.5) * u_bonePalette.yz;
+	vec4 row0 = texture2DLod(s_texBonePalette, uv, 0.0);
+	vec4 row1 = texture2DLod(s_texBonePalette, uv + vec2(u_bonePalette.y, 0.0), 0.0);
+	vec4 row2 = texture2DLod(s_texBonePalette, uv + vec2(2.0 * u_bonePalette.y, 0.0), 0.0);
+	return mtxFromRows(row0, row1, row2, vec4(0.0, 0.0, 0.0, 1.0));
+}
 
 void main()
 {
-	mat4 boneTransform = u_boneMatrices[a_indices[0]] * a_weight[0];
-	boneTransform += u_boneMatrices[a_indices[1]] * a_weight[1];
-	boneTransform += u_boneMatrices[a_indices[2]] * a_weight[2];
-	boneTransform += u_boneMatrices[a_indices[3]] * a_weight[3];
+	mat4 boneTransform = GetBoneMatrix(float(a_indices[0])) * a_weight[0];
+	boneTransform += GetBoneMatrix(float(a_indices[1])) * a_weight[1];
+	boneTransform += GetBoneMatrix(float(a_indices[2])) * a_weight[2];
+	boneTransform += GetBoneMatrix(float(a_indices[3])) * a_weight[3];
 	
 	vec4 localPosition = mul(boneTransform, vec4(a_position, 1.0));
 	gl_Position = mul(u_modelViewProj, localPosition);
@@ -57,9 +57,8 @@ void ECWorldConsumer::Execute(const cd::SceneDatabase* pSceneDatabase)
 		CD_WARN("[ECWorldConsumer] No valid meshes in the consumed SceneDatabase.");
 	}
 
-	auto ParseMesh = [&](cd::MeshID meshID, const cd::Transform& tranform)
+	auto ParseMesh = [&](engine::Entity meshEntity, cd::MeshID meshID, const cd::Transform& tranform)
 	{
-		engine::Entity meshEntity = m_pSceneWorld->GetWorld()->CreateEntity();
 		AddTransform(meshEntity, tranform);
 
 		const auto& mesh = pSceneDatabase->GetMesh(meshID.Data());
@@ -80,14 +79,13 @@ void ECWorldConsumer::Execute(const cd::SceneDatabase* pSceneDatabase)
 
 			// TODO : Use a standalone .cdanim file to play animation.
 			// Currently, we assume that imported SkinMesh will play animation automatically for testing.
-			AddAnimation(meshEntity, pSceneDatabase->GetAnimation(0), pSceneDatabase);
+			AddAnimation(meshEntity, mesh, pSceneDatabase->GetAnimation(0), pSceneDatabase);
 			AddMaterial(meshEntity, nullptr, pMaterialType, pSceneDatabase);
 		}
 	};
 
-	auto ParseMeshWithMorphs = [&](cd::MeshID meshID, const cd::Transform& tranform, const std::vector<cd::Morph>& morphs)
+	auto ParseMeshWithMorphs = [&](engine::Entity meshEntity, cd::MeshID meshID, const cd::Transform& tranform, const std::vector<cd::Morph>& morphs)
 	{
-		engine::Entity meshEntity = m_pSceneWorld->GetWorld()->CreateEntity();
 		AddTransform(meshEntity, tranform);
 
 		const auto& mesh = pSceneDatabase->GetMesh(meshID.Data());
@@ -108,7 +106,7 @@ void ECWorldConsumer::Execute(const cd::SceneDatabase* pSceneDatabase)
 
 			// TODO : Use a standalone .cdanim file to play animation.
 			// Currently, we assume that imported SkinMesh will play animation automatically for testing.
-			AddAnimation(meshEntity, pSceneDatabase->GetAnimation(0), pSceneDatabase);
+			AddAnimation(meshEntity, mesh, pSceneDatabase->GetAnimation(0), pSceneDatabase);
 			AddMaterial(meshEntity, nullptr, pMaterialType, pSceneDatabase);
 		}
 	};
@@ -119,25 +117,19 @@ void ECWorldConsumer::Execute(const cd::SceneDatabase* pSceneDatabase)
 	// 3. Node hierarchy.
 	// Another case is that we want to skip Node/Mesh which alreay parsed previously.
 	std::set<uint32_t> parsedMeshIDs;
+	std::vector<cd::MeshID> meshIDs;
 	for (const auto& mesh : pSceneDatabase->GetMeshes())
 	{
 		if (m_meshMinID > mesh.GetID().Data())
 		{
 			continue;
 		}
-		
-		if(pSceneDatabase->GetMorphCount())
-		{
-			ParseMeshWithMorphs(mesh.GetID(), cd::Transform::Identity(), pSceneDatabase->GetMorphs());
-			parsedMeshIDs.insert(mesh.GetID().Data());
-		}
-		else 
-		{
-			ParseMesh(mesh.GetID(), cd::Transform::Identity());
-			parsedMeshIDs.insert(mesh.GetID().Data());
-		}
+
+		meshIDs.push_back(mesh.GetID());
+		parsedMeshIDs.insert(mesh.GetID().Data());
 	}
 
+	std::vector<std::pair<cd::MeshID, const cd::Node*>> nodeMeshIDs;
 	for (const auto& node : pSceneDatabase->GetNodes())
 	{
 		if (m_nodeMinID > node.GetID().Data())
@@ -152,21 +144,42 @@ void ECWorldConsumer::Execute(const cd::SceneDatabase* pSceneDatabase)
 				continue;
 			}
 
-			ParseMesh(meshID, node.GetTransform());
+			nodeMeshIDs.emplace_back(meshID, &node);
+		}
+	}
+
+	// Reserve all entities in one shot.
+	std::vector<engine::Entity> entities = m_pSceneWorld->GetWorld()->CreateEntities(meshIDs.size() + nodeMeshIDs.size() +
+		pSceneDatabase->GetCameraCount() + pSceneDatabase->GetLightCount());
+	auto entityIt = entities.begin();
+
+	for (cd::MeshID meshID : meshIDs)
+	{
+		if(pSceneDatabase->GetMorphCount())
+		{
+			ParseMeshWithMorphs(*entityIt++, meshID, cd::Transform::Identity(), pSceneDatabase->GetMorphs());
+		}
+		else 
+		{
+			ParseMesh(*entityIt++, meshID, cd::Transform::Identity());
 		}
 	}
 
+	for (const auto& [meshID, pNode] : nodeMeshIDs)
+	{
+		ParseMesh(*entityIt++, meshID, pNode->GetTransform());
+	}
+
 	for (const auto& camera : pSceneDatabase->GetCameras())
 	{
-		engine::Entity cameraEntity = m_pSceneWorld->GetWorld()->CreateEntity();
-		AddCamera(cameraEntity, camera);
+		AddCamera(*entityIt++, camera);
 	}
 
 	for (const auto& light : pSceneDatabase->GetLights())
 	{
-		engine::Entity lightEntity = m_pSceneWorld->GetWorld()->CreateEntity();
-		AddLight(lightEntity, light);
+		AddLight(*entityIt++, light);
 	}
+	assert(entityIt == entities.end());
 }
 
 void ECWorldConsumer::AddCamera(engine::Entity entity, const cd::Camera& camera)
@@ -243,7 +256,7 @@ void ECWorldConsumer::AddSkinMesh(engine::Entity entity, const cd::Mesh& mesh, c
 	AddStaticMesh(entity, mesh, vertexFormat);
 }
 
-void ECWorldConsumer::AddAnimation(engine::Entity entity, const cd::Animation& animation, const cd::SceneDatabase* pSceneDatabase)
+void ECWorldConsumer::AddAnimation(engine::Entity entity, const cd::Mesh& mesh, const cd::Animation& animation, const cd::SceneDatabase* pSceneDatabase)
 {
 	engine::World* pWorld = m_pSceneWorld->GetWorld();
 	engine::AnimationComponent& animationComponent = pWorld->CreateComponent<engine::AnimationComponent>(entity);
@@ -252,8 +265,15 @@ void ECWorldConsumer::AddAnimation(engine::Entity entity, const cd::Animation& a
 	animationComponent.SetDuration(animation.GetDuration());
 	animationComponent.SetTicksPerSecond(animation.GetTicksPerSecnod());
 
-	bgfx::UniformHandle boneMatricesUniform = bgfx::createUniform("u_boneMatrices", bgfx::UniformType::Mat4, 128);
-	animationComponent.SetBoneMatricesUniform(boneMatricesUniform.idx);
+	std::shared_ptr<const engine::AnimationClip>& pClip = m_animationClips[&animation];
+	if (!pClip)
+	{
+		const auto& tracks = pSceneDatabase->GetTracks();
+		pClip = std::make_shared<const engine::AnimationClip>(engine::AnimationClip::Compress(tracks.data(),
+			static_cast<uint32_t>(tracks.size()), animation.GetDuration()));
+	}
+	animationComponent.Build(pSceneDatabase, pClip);
+	animationComponent.BuildSkinning(mesh);
 }
 
 void ECWorldConsumer::AddMaterial(engine::Entity entity, const cd::Material* pMaterial, engine::MaterialType* pMaterialType, const cd::SceneDatabase* pSceneDatabase)
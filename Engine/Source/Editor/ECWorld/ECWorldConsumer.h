@@ -33,6 +33,7 @@ class VertexFormat;
 namespace engine
 {
 
+class AnimationClip;
 class MaterialComponent;
 class MaterialType;
 class RenderContext;
@@ -64,7 +65,7 @@ private:
 	void AddTransform(engine::Entity entity, const cd::Transform& transform);
 	void AddStaticMesh(engine::Entity entity, const cd::Mesh& mesh, const cd::VertexFormat& vertexFormat);
 	void AddSkinMesh(engine::Entity entity, const cd::Mesh& mesh, const cd::VertexFormat& vertexFormat);
-	void AddAnimation(engine::Entity entity, const cd::Animation& animation, const cd::SceneDatabase* pSceneDatabase);
+	void AddAnimation(engine::Entity entity, const cd::Mesh& mesh, const cd::Animation& animation, const cd::SceneDatabase* pSceneDatabase);
 	void AddMaterial(engine::Entity entity, const cd::Material* pMaterial, engine::MaterialType* pMaterialType, const cd::SceneDatabase* pSceneDatabase);
 	void AddMorphs(engine::Entity entity, const std::vector<cd::Morph>& morphs, const cd::Mesh* pMesh);
 
@@ -72,6 +73,9 @@ private:
 	engine::MaterialType* m_pDefaultMaterialType = nullptr;
 	engine::SceneWorld* m_pSceneWorld = nullptr;
 
+	// Skin meshes playing the same animation share its compressed clip.
+	std::map<const cd::Animation*, std::shared_ptr<const engine::AnimationClip>> m_animationClips;
+
 	uint32_t m_nodeMinID;
 	uint32_t m_meshMinID;
 };
@@ -14,7 +14,6 @@
 #include "Rendering/AABBRenderer.h"
 #include "Rendering/AnimationRenderer.h"
 #include "Rendering/BlendShapeRenderer.h"
-#include "Rendering/BlitRenderTargetPass.h"
 #ifdef ENABLE_DDGI
 #include "Rendering/DDGIRenderer.h"
 #endif
@@ -25,6 +24,7 @@
 #include "Rendering/BloomRenderer.h"
 #include "Rendering/PostProcessRenderer.h"
 #include "Rendering/RenderContext.h"
+#include "Rendering/RenderGraph.h"
 #include "Rendering/SkeletonRenderer.h"
 #include "Rendering/SkyboxRenderer.h"
 #include "Rendering/TerrainRenderer.h"
@@ -361,7 +361,7 @@ void EditorApp::InitRenderContext(engine::GraphicsBackend backend, void* hwnd)
 
 	engine::Path::SetGraphicsBackend(backend);
 	m_pRenderContext = std::make_unique<engine::RenderContext>();
-	m_pRenderContext->Init(backend, hwnd);
+	m_pRenderContext->Init(backend, hwnd, m_initArgs.submitThreadCount);
 	engine::Renderer::SetRenderContext(m_pRenderContext.get());
 }
 
@@ -373,92 +373,107 @@ void EditorApp::InitEditorRenderers()
 void EditorApp::InitEngineRenderers()
 {
 	constexpr engine::StringCrc sceneViewRenderTargetName("SceneRenderTarget");
+	constexpr engine::StringCrc sceneColor = engine::RenderGraph::SceneColor;
+	constexpr engine::StringCrc sceneEmissive = engine::RenderGraph::SceneEmissive;
+	constexpr engine::StringCrc sceneDepth = engine::RenderGraph::SceneDepth;
 	std::vector<engine::AttachmentDescriptor> attachmentDesc = {
-		{.textureFormat = engine::TextureFormat::RGBA32F },
-		{.textureFormat = engine::TextureFormat::RGBA32F },
+		{.textureFormat = engine::TextureFormat::RGBA16F },
+		{.textureFormat = engine::TextureFormat::R11G11B10F },
 		{.textureFormat = engine::TextureFormat::D32F },
 	};
 
 	// The init size doesn't make sense. It will resize by SceneView.
-	engine::RenderTarget* pSceneRenderTarget = m_pRenderContext->CreateRenderTarget(sceneViewRenderTargetName, 1, 1, std::move(attachmentDesc));
+	// Post processing passes swap its two scene colors to read the previous result.
+	engine::RenderTarget* pSceneRenderTarget = m_pRenderContext->CreateRenderTarget(sceneViewRenderTargetName, 1, 1, std::move(attachmentDesc), true);
+
+	m_pEngineRenderGraph = std::make_unique<engine::RenderGraph>(m_pRenderContext.get());
+
+	// SceneView shows the scene color, so passes drawing to it are kept.
+	m_pEngineRenderGraph->MarkOutput(sceneColor);
 
 	auto pSkyboxRenderer = std::make_unique<engine::SkyboxRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	m_pIBLSkyRenderer = pSkyboxRenderer.get();
 	pSkyboxRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pSkyboxRenderer));
+	AddEngineRenderer(cd::MoveTemp(pSkyboxRenderer), {}, { sceneColor, sceneEmissive, sceneDepth });
 
 	if (IsAtmosphericScatteringEnable())
 	{
 		auto pPBRSkyRenderer = std::make_unique<engine::PBRSkyRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 		m_pPBRSkyRenderer = pPBRSkyRenderer.get();
 		pPBRSkyRenderer->SetSceneWorld(m_pSceneWorld.get());
-		AddEngineRenderer(cd::MoveTemp(pPBRSkyRenderer));
+		AddEngineRenderer(cd::MoveTemp(pPBRSkyRenderer), {}, { sceneColor, sceneEmissive, sceneDepth });
 	}
 
 	auto pSceneRenderer = std::make_unique<engine::WorldRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	m_pSceneRenderer = pSceneRenderer.get();
 	pSceneRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pSceneRenderer));
+	AddEngineRenderer(cd::MoveTemp(pSceneRenderer), { sceneDepth }, { sceneColor, sceneEmissive, sceneDepth });
 
 	auto pBlendShapeRenderer = std::make_unique<engine::BlendShapeRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	pBlendShapeRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pBlendShapeRenderer));
+	AddEngineRenderer(cd::MoveTemp(pBlendShapeRenderer), { sceneDepth }, { sceneColor, sceneEmissive, sceneDepth });
 
 	auto pTerrainRenderer = std::make_unique<engine::TerrainRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	m_pTerrainRenderer = pTerrainRenderer.get();
 	pTerrainRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pTerrainRenderer));
+	AddEngineRenderer(cd::MoveTemp(pTerrainRenderer), { sceneDepth }, { sceneColor, sceneDepth });
 
 	auto pSkeletonRenderer = std::make_unique<engine::SkeletonRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	pSkeletonRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pSkeletonRenderer));
+	AddEngineRenderer(cd::MoveTemp(pSkeletonRenderer), { sceneDepth }, { sceneColor, sceneDepth });
 
 	auto pAnimationRenderer = std::make_unique<engine::AnimationRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	pAnimationRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pAnimationRenderer));
+	AddEngineRenderer(cd::MoveTemp(pAnimationRenderer), { sceneDepth }, { sceneColor, sceneDepth });
 
 	auto pWhiteModelRenderer = std::make_unique<engine::WhiteModelRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	m_pWhiteModelRenderer = pWhiteModelRenderer.get();
 	pWhiteModelRenderer->SetSceneWorld(m_pSceneWorld.get());
 	pWhiteModelRenderer->SetEnable(false);
-	AddEngineRenderer(cd::MoveTemp(pWhiteModelRenderer));
+	AddEngineRenderer(cd::MoveTemp(pWhiteModelRenderer), { sceneDepth }, { sceneColor, sceneDepth });
 
 	auto pParticlerenderer = std::make_unique<engine::ParticleRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	pParticlerenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pParticlerenderer));
+	AddEngineRenderer(cd::MoveTemp(pParticlerenderer), { sceneDepth }, { sceneColor, sceneDepth });
 
 #ifdef ENABLE_DDGI
 	auto pDDGIRenderer = std::make_unique<engine::DDGIRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	pDDGIRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pDDGIRenderer));
+	AddEngineRenderer(cd::MoveTemp(pDDGIRenderer), { sceneDepth }, { sceneColor, sceneDepth });
 #endif
 
 	auto pAABBRenderer = std::make_unique<engine::AABBRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	m_pAABBRenderer = pAABBRenderer.get();
 	pAABBRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pAABBRenderer));
+	AddEngineRenderer(cd::MoveTemp(pAABBRenderer), { sceneDepth }, { sceneColor, sceneDepth });
 
 	auto pWireframeRenderer = std::make_unique<engine::WireframeRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	m_pWireframeRenderer = pWireframeRenderer.get();
 	pWireframeRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pWireframeRenderer));
+	AddEngineRenderer(cd::MoveTemp(pWireframeRenderer), { sceneDepth }, { sceneColor, sceneDepth });
 
-	auto pBlitRTRenderPass = std::make_unique<engine::BlitRenderTargetPass>(m_pRenderContext->CreateView(), pSceneRenderTarget);
-	AddEngineRenderer(cd::MoveTemp(pBlitRTRenderPass));
+	// Bloom's sample chain only exists while bloom is live.
+	std::vector<engine::StringCrc> bloomWrites{ sceneColor };
+	for (uint8_t level = 0; level < TEX_CHAIN_LEN; ++level)
+	{
+		m_pEngineRenderGraph->CreateFrameBuffer(engine::BloomRenderer::SampleChainNames[level], sceneViewRenderTargetName, level,
+			engine::BloomRenderer::BloomChainFormat, engine::BloomRenderer::BloomChainFlags);
+		bloomWrites.push_back(engine::BloomRenderer::SampleChainNames[level]);
+	}
 
 	auto pBloomRenderer = std::make_unique<engine::BloomRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	pBloomRenderer->SetSceneWorld(m_pSceneWorld.get());
 	pBloomRenderer->SetEnable(false);
-	AddEngineRenderer(cd::MoveTemp(pBloomRenderer));
+	AddEngineRenderer(cd::MoveTemp(pBloomRenderer), { sceneColor, sceneEmissive }, bloomWrites);
 
 	// We can debug vertex/material/texture information by just output that to screen as fragmentColor.
 	// But postprocess will bring unnecessary confusion. 
 	auto pPostProcessRenderer = std::make_unique<engine::PostProcessRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	pPostProcessRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pPostProcessRenderer));
+	AddEngineRenderer(cd::MoveTemp(pPostProcessRenderer), { sceneColor }, { sceneColor });
 
 	// Note that if you don't want to use ImGuiRenderer for engine, you should also disable EngineImGuiContext.
-	AddEngineRenderer(std::make_unique<engine::ImGuiRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget));
+	AddEngineRenderer(std::make_unique<engine::ImGuiRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget), {}, { sceneColor });
 }
 
 bool EditorApp::IsAtmosphericScatteringEnable() const
@@ -503,10 +518,10 @@ void EditorApp::AddEditorRenderer(std::unique_ptr<engine::Renderer> pRenderer)
 	m_pEditorRenderers.emplace_back(cd::MoveTemp(pRenderer));
 }
 
-void EditorApp::AddEngineRenderer(std::unique_ptr<engine::Renderer> pRenderer)
+void EditorApp::AddEngineRenderer(std::unique_ptr<engine::Renderer> pRenderer,
+	const std::vector<engine::StringCrc>& reads, const std::vector<engine::StringCrc>& writes)
 {
-	pRenderer->Init();
-	m_pEngineRenderers.emplace_back(cd::MoveTemp(pRenderer));
+	m_pEngineRenderGraph->AddPass(cd::MoveTemp(pRenderer), reads, writes);
 }
 
 bool EditorApp::Update(float deltaTime)
@@ -588,23 +603,20 @@ bool EditorApp::Update(float deltaTime)
 			engine::TransformComponent* pCameraTransformComponent = m_pSceneWorld->GetTransformComponent(m_pSceneWorld->GetMainCameraEntity());
 			cd::Vec3f camPos = pCameraTransformComponent->GetTransform().GetTranslation();
 
-			pTerrainComponent->ScreenSpaceSmooth(screenSpaceX, screenSpaceY, pMainCameraComponent->GetProjectionMatrix().Inverse(),
+			// Record the change so that renderers upload the new elevation.
+			m_pSceneWorld->ModifyTerrainComponent(m_pSceneWorld->GetSelectedEntity())->ScreenSpaceSmooth(screenSpaceX, screenSpaceY, pMainCameraComponent->GetProjectionMatrix().Inverse(),
 				pMainCameraComponent->GetViewMatrix().Inverse(), camPos);
 		}
 
+		// Camera is final here so renderers and the profiler share the same visible entities.
+		m_pSceneWorld->UpdateVisibility();
+		m_pSceneWorld->UpdateAnimation(deltaTime);
+		m_pRenderContext->GetFrameConstants().Update(m_pSceneWorld.get());
+
 		m_pEngineImGuiContext->SetWindowPosOffset(m_pSceneView->GetWindowPosX(), m_pSceneView->GetWindowPosY());
 		m_pEngineImGuiContext->Update(deltaTime);
 
-		for (std::unique_ptr<engine::Renderer>& pRenderer : m_pEngineRenderers)
-		{
-			if (pRenderer->IsEnable())
-			{
-				const float* pViewMatrix = pMainCameraComponent->GetViewMatrix().Begin();
-				const float* pProjectionMatrix = pMainCameraComponent->GetProjectionMatrix().Begin();
-				pRenderer->UpdateView(pViewMatrix, pProjectionMatrix);
-				pRenderer->Render(deltaTime);
-			}
-		}
+		m_pEngineRenderGraph->Execute(deltaTime, pMainCameraComponent->GetViewMatrix().Begin(), pMainCameraComponent->GetProjectionMatrix().Begin());
 	}
 
 	m_pRenderContext->EndFrame();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Application/IApplication.h"
+#include "Core/StringCrc.h"
 
 #include <memory>
 #include <vector>
@@ -15,6 +16,7 @@ class ImGuiContextInstance;
 class Window;
 class RenderContext;
 class Renderer;
+class RenderGraph;
 class AABBRenderer;
 class RenderTarget;
 class SceneWorld;
@@ -54,7 +56,8 @@ public:
 	void InitEngineRenderers();
 	void InitShaderPrograms() const;
 	void AddEditorRenderer(std::unique_ptr<engine::Renderer> pRenderer);
-	void AddEngineRenderer(std::unique_ptr<engine::Renderer> pRenderer);
+	void AddEngineRenderer(std::unique_ptr<engine::Renderer> pRenderer,
+		const std::vector<engine::StringCrc>& reads, const std::vector<engine::StringCrc>& writes);
 
 	void InitEditorImGuiContext(engine::Language language);
 	void InitEditorUILayers();
@@ -102,7 +105,7 @@ private:
 	// Rendering
 	std::unique_ptr<engine::RenderContext> m_pRenderContext;
 	std::vector<std::unique_ptr<engine::Renderer>> m_pEditorRenderers;
-	std::vector<std::unique_ptr<engine::Renderer>> m_pEngineRenderers;
+	std::unique_ptr<engine::RenderGraph> m_pEngineRenderGraph;
 
 	// Controllers for processing input events.
 	std::unique_ptr<engine::CameraController> m_pViewportCameraController;
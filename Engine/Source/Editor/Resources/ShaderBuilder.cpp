@@ -17,6 +17,13 @@ void ShaderBuilder::BuildUberShader(engine::MaterialType* pMaterialType)
 	ResourceBuilder::Get().AddShaderBuildTask(ShaderType::Vertex,
 		shaderSchema.GetVertexShaderPath(), outputVSFilePath.c_str());
 
+	if (shaderSchema.HasInstanceVertexShader())
+	{
+		std::string outputInstanceVSFilePath = engine::Path::GetShaderOutputPath(shaderSchema.GetInstanceVertexShaderPath());
+		ResourceBuilder::Get().AddShaderBuildTask(ShaderType::Vertex,
+			shaderSchema.GetInstanceVertexShaderPath(), outputInstanceVSFilePath.c_str());
+	}
+
 	// Compile fragment shaders with shader features.
 	for (const auto& combine : shaderSchema.GetFeatureCombines())
 	{
@@ -255,8 +255,8 @@ void EntityList::DrawEntity(engine::SceneWorld* pSceneWorld, engine::Entity enti
         nodeFlags |= ImGuiTreeNodeFlags_Selected;
     }
 
-    // TODO : hierarchy or not?
-    bool hasNoChildren = true;
+    const engine::TransformSystem* pTransformSystem = pSceneWorld->GetTransformSystem();
+    bool hasNoChildren = !pTransformSystem->HasChildren(entity);
     if (hasNoChildren)
     {
         nodeFlags |= ImGuiTreeNodeFlags_Leaf;
@@ -367,6 +367,11 @@ void EntityList::DrawEntity(engine::SceneWorld* pSceneWorld, engine::Entity enti
     ImVec2 verticalLineEnd = verticalLineStart;
     ImGui::GetWindowDrawList()->AddLine(verticalLineStart, verticalLineEnd, TreeLineColor);
 
+    pTransformSystem->ForEachChild(entity, [this, pSceneWorld](engine::Entity child)
+    {
+        DrawEntity(pSceneWorld, child);
+    });
+
     ImGui::TreePop();
     ImGui::PopID();
 }
@@ -439,9 +444,13 @@ void EntityList::Update()
 
     ImGui::BeginChild("Entites");
 
+    // Children are drawn under their parents' tree nodes.
     for (engine::Entity entity : pSceneWorld->GetNameEntities())
     {
-        DrawEntity(pSceneWorld, entity);
+        if (engine::INVALID_ENTITY == pSceneWorld->GetTransformSystem()->GetParent(entity))
+        {
+            DrawEntity(pSceneWorld, entity);
+        }
     }
 
     ImGui::Indent();
@@ -54,25 +54,30 @@ void ImGuizmoView::Update()
 
 	if (ImGuizmo::IsUsing())
 	{
+		// Gizmo works in world space but the transform is relative to the parent.
+		engine::TransformSystem* pTransformSystem = pSceneWorld->GetTransformSystem();
+		const engine::TransformComponent* pParentTransformComponent = pSceneWorld->GetTransformComponent(pTransformSystem->GetParent(selectedEntity));
+		cd::Matrix4x4 parentWorldMatrix = pParentTransformComponent ? pParentTransformComponent->GetWorldMatrix() : cd::Matrix4x4::Identity();
+		cd::Matrix4x4 localMatrix = parentWorldMatrix.Inverse() * worldMatrix;
+
 		if (ImGuizmo::OPERATION::TRANSLATE & operation)
 		{
-			pTransformComponent->GetTransform().SetTranslation(worldMatrix.GetTranslation());
-			pTransformComponent->Dirty();
+			pTransformComponent->GetTransform().SetTranslation(localMatrix.GetTranslation());
 		}
 		
 		if (ImGuizmo::OPERATION::ROTATE & operation)
 		{
-			pTransformComponent->GetTransform().SetRotation(cd::Quaternion::FromMatrix(worldMatrix.GetRotation()));
-			pTransformComponent->Dirty();
+			pTransformComponent->GetTransform().SetRotation(cd::Quaternion::FromMatrix(localMatrix.GetRotation()));
 		}
 
 		if (ImGuizmo::OPERATION::SCALE & operation)
 		{
-			pTransformComponent->GetTransform().SetScale(worldMatrix.GetScale());
-			pTransformComponent->Dirty();
+			pTransformComponent->GetTransform().SetScale(localMatrix.GetScale());
 		}
 
-		pTransformComponent->Build();
+		// Keep the gizmo on the entity in this frame, children follow in the next TransformSystem::Update.
+		pTransformComponent->Build(parentWorldMatrix);
+		pTransformSystem->MarkDirty(selectedEntity);
 	}
 }
 
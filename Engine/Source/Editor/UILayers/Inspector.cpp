@@ -74,8 +74,9 @@ void UpdateComponentWidget<engine::TransformComponent>(engine::SceneWorld* pScen
 	{
 		if (ImGuiUtils::ImGuiTransformProperty("Transform", pTransformComponent->GetTransform()))
 		{
+			// World matrix is rebuilt under the parent's one by TransformSystem.
 			pTransformComponent->Dirty();
-			pTransformComponent->Build();
+			pSceneWorld->GetTransformSystem()->MarkDirty(entity);
 		}
 	}
 
@@ -254,40 +254,36 @@ void SceneView::PickSceneMesh(float regionWidth, float regionHeight)
 		return;
 	}
 
-	// Loop through scene's all static meshes' AABB to test intersections with Ray.
+	// Only entities whose fat bounds in the spatial tree are hit before the current nearest one are tested exactly.
 	engine::SceneWorld* pSceneWorld = GetSceneWorld();
 	engine::CameraComponent* pCameraComponent = pSceneWorld->GetCameraComponent(pSceneWorld->GetMainCameraEntity());
-	cd::Ray pickRay = pCameraComponent->EmitRay(screenX, screenY, screenWidth, screenHeight);
+	cd::Vec3f rayOrigin;
+	cd::Vec3f rayDirection;
+	pCameraComponent->EmitRay(screenX, screenY, screenWidth, screenHeight, rayOrigin, rayDirection);
+	cd::Ray pickRay(rayOrigin, rayDirection);
 
-	float minRayTime = FLT_MAX;
 	engine::Entity nearestEntity = engine::INVALID_ENTITY;
-	for (engine::Entity entity : pSceneWorld->GetCollisionMeshEntities())
+	pSceneWorld->GetSpatialSystem()->QueryRay(rayOrigin, rayDirection, FLT_MAX, [&](engine::Entity entity, float minRayTime)
 	{
 		engine::TransformComponent* pTransformComponent = pSceneWorld->GetTransformComponent(entity);
-		if (!pTransformComponent)
-		{
-			continue;
-		}
-
 		auto* pCollisionMesh = pSceneWorld->GetCollisionMeshComponent(entity);
-		if (!pCollisionMesh)
+		if (!pTransformComponent || !pCollisionMesh)
 		{
-			continue;
+			return minRayTime;
 		}
 
 		cd::AABB collisonMeshAABB = pCollisionMesh->GetAABB();
 		collisonMeshAABB = collisonMeshAABB.Transform(pTransformComponent->GetWorldMatrix());
 
 		float rayTime;
-		if (collisonMeshAABB.Intersects(pickRay, rayTime))
+		if (collisonMeshAABB.Intersects(pickRay, rayTime) && rayTime < minRayTime)
 		{
-			if (rayTime < minRayTime)
-			{
-				minRayTime = rayTime;
-				nearestEntity = entity;
-			}
+			nearestEntity = entity;
+			return rayTime;
 		}
-	}
+
+		return minRayTime;
+	});
 
 	pSceneWorld->SetSelectedEntity(nearestEntity);
 }
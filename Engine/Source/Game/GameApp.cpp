@@ -18,6 +18,7 @@
 #include "Rendering/PBRSkyRenderer.h"
 #include "Rendering/PostProcessRenderer.h"
 #include "Rendering/RenderContext.h"
+#include "Rendering/RenderGraph.h"
 #include "Rendering/SkyboxRenderer.h"
 #include "Rendering/WorldRenderer.h"
 #include "Resources/ShaderLoader.h"
@@ -212,16 +213,19 @@ void GameApp::InitRenderContext(engine::GraphicsBackend backend, void* hwnd)
 
 	engine::Path::SetGraphicsBackend(backend);
 	m_pRenderContext = std::make_unique<engine::RenderContext>();
-	m_pRenderContext->Init(backend, hwnd);
+	m_pRenderContext->Init(backend, hwnd, m_initArgs.submitThreadCount);
 	engine::Renderer::SetRenderContext(m_pRenderContext.get());
 }
 
 void GameApp::InitEngineRenderers()
 {
 	constexpr engine::StringCrc sceneViewRenderTargetName("SceneRenderTarget");
+	constexpr engine::StringCrc sceneColor = engine::RenderGraph::SceneColor;
+	constexpr engine::StringCrc sceneEmissive = engine::RenderGraph::SceneEmissive;
+	constexpr engine::StringCrc sceneDepth = engine::RenderGraph::SceneDepth;
 	std::vector<engine::AttachmentDescriptor> attachmentDesc = {
-		{.textureFormat = engine::TextureFormat::RGBA32F },
-		{.textureFormat = engine::TextureFormat::RGBA32F },
+		{.textureFormat = engine::TextureFormat::RGBA16F },
+		{.textureFormat = engine::TextureFormat::R11G11B10F },
 		{.textureFormat = engine::TextureFormat::D32F },
 	};
 
@@ -229,32 +233,35 @@ void GameApp::InitEngineRenderers()
 	engine::RenderTarget* pSceneRenderTarget = nullptr;
 	pSceneRenderTarget = m_pRenderContext->CreateRenderTarget(sceneViewRenderTargetName, GetMainWindow()->GetWidth(), GetMainWindow()->GetHeight(), std::move(attachmentDesc));
 
+	m_pEngineRenderGraph = std::make_unique<engine::RenderGraph>(m_pRenderContext.get());
+	m_pEngineRenderGraph->MarkOutput(engine::RenderGraph::BackBuffer);
+
 	auto pSkyboxRenderer = std::make_unique<engine::SkyboxRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	m_pIBLSkyRenderer = pSkyboxRenderer.get();
 	pSkyboxRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pSkyboxRenderer));
+	AddEngineRenderer(cd::MoveTemp(pSkyboxRenderer), {}, { sceneColor, sceneEmissive, sceneDepth });
 
 	if (IsAtmosphericScatteringEnable())
 	{
 		auto pPBRSkyRenderer = std::make_unique<engine::PBRSkyRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 		m_pPBRSkyRenderer = pPBRSkyRenderer.get();
 		pPBRSkyRenderer->SetSceneWorld(m_pSceneWorld.get());
-		AddEngineRenderer(cd::MoveTemp(pPBRSkyRenderer));
+		AddEngineRenderer(cd::MoveTemp(pPBRSkyRenderer), {}, { sceneColor, sceneEmissive, sceneDepth });
 	}
 
 	auto pSceneRenderer = std::make_unique<engine::WorldRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	m_pSceneRenderer = pSceneRenderer.get();
 	pSceneRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pSceneRenderer));
+	AddEngineRenderer(cd::MoveTemp(pSceneRenderer), { sceneDepth }, { sceneColor, sceneEmissive, sceneDepth });
 
 	auto pAnimationRenderer = std::make_unique<engine::AnimationRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	pAnimationRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pAnimationRenderer));
+	AddEngineRenderer(cd::MoveTemp(pAnimationRenderer), { sceneDepth }, { sceneColor, sceneDepth });
 
 #ifdef ENABLE_DDGI
 	auto pDDGIRenderer = std::make_unique<engine::DDGIRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	pDDGIRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pDDGIRenderer));
+	AddEngineRenderer(cd::MoveTemp(pDDGIRenderer), { sceneDepth }, { sceneColor, sceneDepth });
 #endif
 
 	// We can debug vertex/material/texture information by just output that to screen as fragmentColor.
@@ -262,11 +269,11 @@ void GameApp::InitEngineRenderers()
 	auto pPostProcessRenderer = std::make_unique<engine::PostProcessRenderer>(m_pRenderContext->CreateView());
 	pPostProcessRenderer->SetSceneWorld(m_pSceneWorld.get());
 	pPostProcessRenderer->SetEnable(true);
-	AddEngineRenderer(cd::MoveTemp(pPostProcessRenderer));
+	AddEngineRenderer(cd::MoveTemp(pPostProcessRenderer), { sceneColor }, { engine::RenderGraph::BackBuffer });
 
 
 	// Note that if you don't want to use ImGuiRenderer for engine, you should also disable EngineImGuiContext.
-	AddEngineRenderer(std::make_unique<engine::ImGuiRenderer>(m_pRenderContext->CreateView()));
+	AddEngineRenderer(std::make_unique<engine::ImGuiRenderer>(m_pRenderContext->CreateView()), {}, { engine::RenderGraph::BackBuffer });
 }
 
 bool GameApp::IsAtmosphericScatteringEnable() const
@@ -286,10 +293,10 @@ void GameApp::InitController()
 	m_pCameraController->CameraToController();
 }
 
-void GameApp::AddEngineRenderer(std::unique_ptr<engine::Renderer> pRenderer)
+void GameApp::AddEngineRenderer(std::unique_ptr<engine::Renderer> pRenderer,
+	const std::vector<engine::StringCrc>& reads, const std::vector<engine::StringCrc>& writes)
 {
-	pRenderer->Init();
-	m_pEngineRenderers.emplace_back(cd::MoveTemp(pRenderer));
+	m_pEngineRenderGraph->AddPass(cd::MoveTemp(pRenderer), reads, writes);
 }
 
 bool GameApp::Update(float deltaTime)
@@ -343,21 +350,15 @@ bool GameApp::Update(float deltaTime)
 	engine::CameraComponent* pMainCameraComponent = m_pSceneWorld->GetCameraComponent(m_pSceneWorld->GetMainCameraEntity());
 	assert(pMainCameraComponent);
 	pMainCameraComponent->BuildProjectMatrix();
+	m_pSceneWorld->UpdateVisibility();
+	m_pSceneWorld->UpdateAnimation(deltaTime);
+	m_pRenderContext->GetFrameConstants().Update(m_pSceneWorld.get());
 
 	m_pRenderContext->BeginFrame();
 	if (m_pEngineImGuiContext)
 	{
 		m_pEngineImGuiContext->Update(deltaTime);
-		for (std::unique_ptr<engine::Renderer>& pRenderer : m_pEngineRenderers)
-		{
-			if (pRenderer->IsEnable())
-			{
-				const float* pViewMatrix = pMainCameraComponent->GetViewMatrix().Begin();
-				const float* pProjectionMatrix = pMainCameraComponent->GetProjectionMatrix().Begin();
-				pRenderer->UpdateView(pViewMatrix, pProjectionMatrix);
-				pRenderer->Render(deltaTime);
-			}
-		}
+		m_pEngineRenderGraph->Execute(deltaTime, pMainCameraComponent->GetViewMatrix().Begin(), pMainCameraComponent->GetProjectionMatrix().Begin());
 	}
 
 	m_pRenderContext->EndFrame();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Application/IApplication.h"
+#include "Core/StringCrc.h"
 
 #include <memory>
 #include <vector>
@@ -15,6 +16,7 @@ class ImGuiContextInstance;
 class Window;
 class RenderContext;
 class Renderer;
+class RenderGraph;
 class RenderTarget;
 class SceneWorld;
 
@@ -49,7 +51,8 @@ public:
 
 	void InitRenderContext(engine::GraphicsBackend backend, void* hwnd = nullptr);
 	void InitEngineRenderers();
-	void AddEngineRenderer(std::unique_ptr<engine::Renderer> pRenderer);
+	void AddEngineRenderer(std::unique_ptr<engine::Renderer> pRenderer,
+		const std::vector<engine::StringCrc>& reads, const std::vector<engine::StringCrc>& writes);
 
 	void InitEngineImGuiContext(engine::Language language);
 	void InitEngineUILayers();
@@ -85,7 +88,7 @@ private:
 
 	// Rendering
 	std::unique_ptr<engine::RenderContext> m_pRenderContext;
-	std::vector<std::unique_ptr<engine::Renderer>> m_pEngineRenderers;
+	std::unique_ptr<engine::RenderGraph> m_pEngineRenderGraph;
 
 	// Controllers for processing input events.
 	std::unique_ptr<engine::CameraController> m_pCameraController;
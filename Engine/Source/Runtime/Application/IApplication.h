@@ -19,6 +19,8 @@ struct EngineInitArgs
 	bool useFullScreen = false;
 	Language language = Language::English;
 	GraphicsBackend backend = GraphicsBackend::Direct3D11;
+	// Threads recording draw calls of heavy renderers. 1 records on the main thread.
+	uint16_t submitThreadCount = 1;
 };
 
 class IApplication
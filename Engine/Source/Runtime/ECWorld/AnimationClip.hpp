@@ -0,0 +1,440 @@
+#pragma once
+
+#include "Math/Quaternion.hpp"
+#include "Math/Vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+// AnimationClip is the runtime format of animation tracks, built once when an animation is imported.
+// Keys which linear interpolation of their neighbors reproduces within a tolerance are removed.
+// Remaining keys take 8 bytes : a 16 bits time in the clip and 48 bits value. Rotations use the smallest three
+// components with 15 bits each, translations and scales use 16 bits per component in the range of their channel.
+// Keys of one channel are stored next to each other and channels of one track are adjacent, so sampling a bone
+// reads a few close cache lines.
+class AnimationClip final
+{
+public:
+	struct CompressionSettings
+	{
+		// Max error of a removed key per component, in units of the value.
+		float translationTolerance = 0.0001f;
+		float rotationTolerance = 0.0001f;
+		float scaleTolerance = 0.0001f;
+	};
+
+	// Sampling position of a track. Cursors move forward with time, so one cursor is needed per playback.
+	struct TrackCursor
+	{
+		uint32_t translation = 0U;
+		uint32_t rotation = 0U;
+		uint32_t scale = 0U;
+	};
+
+	// Returns the index of the key segment [index, index + 1] which contains time.
+	// Keys are sorted by time and there are at least two of them.
+	template<typename Keys>
+	static uint32_t SeekKey(const Keys& keys, uint32_t keyCount, uint32_t cursor, float time)
+	{
+		uint32_t lastSegment = keyCount - 2U;
+		if (cursor <= lastSegment && keys[cursor].GetTime() <= time)
+		{
+			// Playback moves a few keys per frame at most, larger jumps fall back to the binary search.
+			constexpr uint32_t maxLinearSteps = 4U;
+			for (uint32_t step = 0U; step < maxLinearSteps; ++step)
+			{
+				if (cursor == lastSegment || time < keys[cursor + 1U].GetTime())
+				{
+					return cursor;
+				}
+				++cursor;
+			}
+		}
+
+		// First key after time in [1, keyCount - 1].
+		uint32_t first = 1U;
+		uint32_t count = keyCount - 1U;
+		while (count > 0U)
+		{
+			uint32_t half = count / 2U;
+			if (keys[first + half].GetTime() <= time)
+			{
+				first += half + 1U;
+				count -= half + 1U;
+			}
+			else
+			{
+				count = half;
+			}
+		}
+
+		return first - 1U > lastSegment ? lastSegment : first - 1U;
+	}
+
+	// Track needs the key accessors of cd::Track. Key times are in [0, duration].
+	template<typename Track>
+	static AnimationClip Compress(const Track* pTracks, uint32_t trackCount, float duration, const CompressionSettings& settings = CompressionSettings())
+	{
+		AnimationClip clip;
+		clip.m_duration = duration;
+		clip.m_timeScale = duration > 0.0f ? MaxQuantizedValue / duration : 0.0f;
+		clip.m_channels.reserve(trackCount * 3U);
+
+		std::vector<Value> values;
+		std::vector<float> times;
+		for (uint32_t trackIndex = 0U; trackIndex < trackCount; ++trackIndex)
+		{
+			const Track& track = pTracks[trackIndex];
+
+			LoadKeys(track.GetTranslationKeys(), track.GetTranslationKeyCount(), times, values, [](const cd::Vec3f& value)
+			{
+				return Value{ value.x(), value.y(), value.z(), 0.0f };
+			});
+			clip.AddChannel(times, values, ChannelType::Vector, settings.translationTolerance);
+
+			LoadKeys(track.GetRotationKeys(), track.GetRotationKeyCount(), times, values, [](const cd::Quaternion& value)
+			{
+				return Value{ value.x(), value.y(), value.z(), value.w() };
+			});
+			clip.AddChannel(times, values, ChannelType::Rotation, settings.rotationTolerance);
+
+			LoadKeys(track.GetScaleKeys(), track.GetScaleKeyCount(), times, values, [](const cd::Vec3f& value)
+			{
+				return Value{ value.x(), value.y(), value.z(), 0.0f };
+			});
+			clip.AddChannel(times, values, ChannelType::Vector, settings.scaleTolerance);
+		}
+
+		clip.m_keys.shrink_to_fit();
+		return clip;
+	}
+
+public:
+	AnimationClip() = default;
+	AnimationClip(const AnimationClip&) = default;
+	AnimationClip& operator=(const AnimationClip&) = default;
+	AnimationClip(AnimationClip&&) = default;
+	AnimationClip& operator=(AnimationClip&&) = default;
+	~AnimationClip() = default;
+
+	uint32_t GetTrackCount() const { return static_cast<uint32_t>(m_channels.size() / 3U); }
+	float GetDuration() const { return m_duration; }
+	size_t GetKeyCount() const { return m_keys.size(); }
+
+	// Bytes of keys and channel descriptions.
+	size_t GetMemorySize() const { return m_keys.size() * sizeof(Key) + m_channels.size() * sizeof(Channel); }
+
+	// Not thread safe for the same cursor. Channels without keys return zero translation, identity rotation and unit scale.
+	void Sample(uint32_t trackIndex, float time, TrackCursor& cursor, cd::Vec3f& translation, cd::Quaternion& rotation, cd::Vec3f& scale) const
+	{
+		float quantizedTime = std::clamp(time * m_timeScale, 0.0f, MaxQuantizedValue);
+		const Channel* pChannels = &m_channels[trackIndex * 3U];
+
+		Value value = SampleChannel(pChannels[0], quantizedTime, cursor.translation, ChannelType::Vector, Value{ 0.0f, 0.0f, 0.0f, 0.0f });
+		translation = cd::Vec3f(value[0], value[1], value[2]);
+
+		value = SampleChannel(pChannels[1], quantizedTime, cursor.rotation, ChannelType::Rotation, Value{ 0.0f, 0.0f, 0.0f, 1.0f });
+		rotation = cd::Quaternion(value[0], value[1], value[2], value[3]);
+
+		value = SampleChannel(pChannels[2], quantizedTime, cursor.scale, ChannelType::Vector, Value{ 1.0f, 1.0f, 1.0f, 0.0f });
+		scale = cd::Vec3f(value[0], value[1], value[2]);
+	}
+
+private:
+	using Value = std::array<float, 4>;
+
+	static constexpr float MaxQuantizedValue = 65535.0f;
+	static constexpr float MaxSmallestThreeValue = 32767.0f;
+	static constexpr float SmallestThreeRange = 0.70710678f;
+
+	enum class ChannelType
+	{
+		Vector,
+		Rotation
+	};
+
+	struct Key
+	{
+		uint16_t time;
+		uint16_t value[3];
+
+		float GetTime() const { return static_cast<float>(time); }
+	};
+
+	struct Channel
+	{
+		uint32_t firstKey = 0U;
+		uint32_t keyCount = 0U;
+
+		// Vector value = rangeMin + quantized value * rangeScale.
+		float rangeMin[3] = { 0.0f, 0.0f, 0.0f };
+		float rangeScale[3] = { 0.0f, 0.0f, 0.0f };
+	};
+
+	template<typename Keys, typename ToValue>
+	static void LoadKeys(const Keys& keys, uint32_t keyCount, std::vector<float>& times, std::vector<Value>& values, ToValue&& toValue)
+	{
+		times.clear();
+		values.clear();
+		for (uint32_t keyIndex = 0U; keyIndex < keyCount; ++keyIndex)
+		{
+			times.push_back(keys[keyIndex].GetTime());
+			values.push_back(toValue(keys[keyIndex].GetValue()));
+		}
+	}
+
+	static Value Interpolate(const Value& from, const Value& to, float rate, ChannelType type)
+	{
+		if (ChannelType::Vector == type)
+		{
+			return Value{ from[0] + (to[0] - from[0]) * rate, from[1] + (to[1] - from[1]) * rate, from[2] + (to[2] - from[2]) * rate, 0.0f };
+		}
+
+		// Normalized lerp on the shortest path. Smallest three encoding doesn't keep signs of neighbor keys.
+		float dot = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+		float toSign = dot < 0.0f ? -1.0f : 1.0f;
+		Value result;
+		float lengthSquared = 0.0f;
+		for (uint32_t index = 0U; index < 4U; ++index)
+		{
+			result[index] = from[index] + (to[index] * toSign - from[index]) * rate;
+			lengthSquared += result[index] * result[index];
+		}
+
+		float inverseLength = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+		for (float& component : result)
+		{
+			component *= inverseLength;
+		}
+		return result;
+	}
+
+	static float GetError(const Value& lhs, const Value& rhs, ChannelType type)
+	{
+		// q and -q are the same rotation.
+		float sign = 1.0f;
+		if (ChannelType::Rotation == type && lhs[0] * rhs[0] + lhs[1] * rhs[1] + lhs[2] * rhs[2] + lhs[3] * rhs[3] < 0.0f)
+		{
+			sign = -1.0f;
+		}
+
+		float error = 0.0f;
+		for (uint32_t index = 0U; index < 4U; ++index)
+		{
+			error = std::max(error, std::abs(lhs[index] - rhs[index] * sign));
+		}
+		return error;
+	}
+
+	// Greedy reduction : extend the segment from the last kept key while it reproduces all keys in between.
+	static void ReduceKeys(const std::vector<float>& times, const std::vector<Value>& values, ChannelType type, float tolerance,
+		std::vector<uint32_t>& keptKeys)
+	{
+		keptKeys.clear();
+		uint32_t keyCount = static_cast<uint32_t>(times.size());
+		if (0U == keyCount)
+		{
+			return;
+		}
+
+		keptKeys.push_back(0U);
+		uint32_t anchor = 0U;
+		for (uint32_t candidate = 2U; candidate < keyCount; ++candidate)
+		{
+			for (uint32_t keyIndex = anchor + 1U; keyIndex < candidate; ++keyIndex)
+			{
+				float deltaTime = times[candidate] - times[anchor];
+				float rate = deltaTime > 0.0f ? (times[keyIndex] - times[anchor]) / deltaTime : 0.0f;
+				if (GetError(Interpolate(values[anchor], values[candidate], rate, type), values[keyIndex], type) > tolerance)
+				{
+					anchor = candidate - 1U;
+					keptKeys.push_back(anchor);
+					break;
+				}
+			}
+		}
+
+		if (keyCount > 1U)
+		{
+			keptKeys.push_back(keyCount - 1U);
+		}
+
+		// A constant channel keeps one key.
+		if (2U == keptKeys.size() && GetError(values[keptKeys[0]], values[keptKeys[1]], type) <= tolerance)
+		{
+			keptKeys.pop_back();
+		}
+	}
+
+	static uint16_t Quantize(float value, float maxValue)
+	{
+		return static_cast<uint16_t>(std::clamp(value, 0.0f, 1.0f) * maxValue + 0.5f);
+	}
+
+	static void EncodeRotation(Value rotation, uint16_t (&encoded)[3])
+	{
+		uint32_t largestIndex = 0U;
+		for (uint32_t index = 1U; index < 4U; ++index)
+		{
+			if (std::abs(rotation[index]) > std::abs(rotation[largestIndex]))
+			{
+				largestIndex = index;
+			}
+		}
+
+		// The dropped largest component is rebuilt as positive.
+		float sign = rotation[largestIndex] < 0.0f ? -1.0f : 1.0f;
+		float lengthSquared = 0.0f;
+		for (float component : rotation)
+		{
+			lengthSquared += component * component;
+		}
+		float inverseLength = lengthSquared > 0.0f ? sign / std::sqrt(lengthSquared) : 0.0f;
+
+		uint64_t packed = static_cast<uint64_t>(largestIndex) << 45U;
+		uint32_t shift = 30U;
+		for (uint32_t index = 0U; index < 4U; ++index)
+		{
+			if (index != largestIndex)
+			{
+				float normalized = (rotation[index] * inverseLength / SmallestThreeRange + 1.0f) * 0.5f;
+				packed |= static_cast<uint64_t>(Quantize(normalized, MaxSmallestThreeValue)) << shift;
+				shift -= 15U;
+			}
+		}
+
+		encoded[0] = static_cast<uint16_t>(packed >> 32U);
+		encoded[1] = static_cast<uint16_t>(packed >> 16U);
+		encoded[2] = static_cast<uint16_t>(packed);
+	}
+
+	static Value DecodeRotation(const uint16_t (&encoded)[3])
+	{
+		uint64_t packed = (static_cast<uint64_t>(encoded[0]) << 32U) | (static_cast<uint64_t>(encoded[1]) << 16U) | encoded[2];
+		uint32_t largestIndex = static_cast<uint32_t>(packed >> 45U) & 3U;
+
+		Value rotation;
+		float lengthSquared = 0.0f;
+		uint32_t shift = 30U;
+		for (uint32_t index = 0U; index < 4U; ++index)
+		{
+			if (index != largestIndex)
+			{
+				float normalized = static_cast<float>((packed >> shift) & 0x7FFFU) / MaxSmallestThreeValue;
+				rotation[index] = (normalized * 2.0f - 1.0f) * SmallestThreeRange;
+				lengthSquared += rotation[index] * rotation[index];
+				shift -= 15U;
+			}
+		}
+		rotation[largestIndex] = std::sqrt(std::max(0.0f, 1.0f - lengthSquared));
+		return rotation;
+	}
+
+	Value DecodeValue(const Channel& channel, const Key& key, ChannelType type) const
+	{
+		if (ChannelType::Rotation == type)
+		{
+			return DecodeRotation(key.value);
+		}
+
+		return Value{ channel.rangeMin[0] + static_cast<float>(key.value[0]) * channel.rangeScale[0],
+			channel.rangeMin[1] + static_cast<float>(key.value[1]) * channel.rangeScale[1],
+			channel.rangeMin[2] + static_cast<float>(key.value[2]) * channel.rangeScale[2], 0.0f };
+	}
+
+	void AddChannel(const std::vector<float>& times, const std::vector<Value>& values, ChannelType type, float tolerance)
+	{
+		Channel& channel = m_channels.emplace_back();
+		channel.firstKey = static_cast<uint32_t>(m_keys.size());
+
+		std::vector<uint32_t> keptKeys;
+		ReduceKeys(times, values, type, tolerance, keptKeys);
+		if (keptKeys.empty())
+		{
+			return;
+		}
+
+		if (ChannelType::Vector == type)
+		{
+			for (uint32_t component = 0U; component < 3U; ++component)
+			{
+				float rangeMin = values[keptKeys[0]][component];
+				float rangeMax = rangeMin;
+				for (uint32_t keyIndex : keptKeys)
+				{
+					rangeMin = std::min(rangeMin, values[keyIndex][component]);
+					rangeMax = std::max(rangeMax, values[keyIndex][component]);
+				}
+				channel.rangeMin[component] = rangeMin;
+				channel.rangeScale[component] = (rangeMax - rangeMin) / MaxQuantizedValue;
+			}
+		}
+
+		for (uint32_t keyIndex : keptKeys)
+		{
+			Key key;
+			key.time = Quantize(times[keyIndex] * m_timeScale / MaxQuantizedValue, MaxQuantizedValue);
+
+			// Close keys of a long clip may share a quantized time, the first one is kept.
+			if (channel.keyCount > 0U && key.time == m_keys.back().time)
+			{
+				continue;
+			}
+
+			if (ChannelType::Rotation == type)
+			{
+				EncodeRotation(values[keyIndex], key.value);
+			}
+			else
+			{
+				for (uint32_t component = 0U; component < 3U; ++component)
+				{
+					float range = channel.rangeScale[component] * MaxQuantizedValue;
+					float normalized = range > 0.0f ? (values[keyIndex][component] - channel.rangeMin[component]) / range : 0.0f;
+					key.value[component] = Quantize(normalized, MaxQuantizedValue);
+				}
+			}
+
+			m_keys.push_back(key);
+			++channel.keyCount;
+		}
+	}
+
+	Value SampleChannel(const Channel& channel, float quantizedTime, uint32_t& cursor, ChannelType type, const Value& defaultValue) const
+	{
+		if (0U == channel.keyCount)
+		{
+			return defaultValue;
+		}
+
+		const Key* pKeys = &m_keys[channel.firstKey];
+		if (1U == channel.keyCount)
+		{
+			return DecodeValue(channel, pKeys[0], type);
+		}
+
+		cursor = SeekKey(pKeys, channel.keyCount, cursor, quantizedTime);
+		const Key& fromKey = pKeys[cursor];
+		const Key& toKey = pKeys[cursor + 1U];
+		float rate = std::clamp((quantizedTime - fromKey.GetTime()) / (toKey.GetTime() - fromKey.GetTime()), 0.0f, 1.0f);
+		return Interpolate(DecodeValue(channel, fromKey, type), DecodeValue(channel, toKey, type), rate, type);
+	}
+
+private:
+	float m_duration = 0.0f;
+
+	// Seconds or ticks of the clip -> quantized key time.
+	float m_timeScale = 0.0f;
+
+	// Channels of a track are translation, rotation and scale.
+	std::vector<Channel> m_channels;
+	std::vector<Key> m_keys;
+};
+
+}
\ No newline at end of file
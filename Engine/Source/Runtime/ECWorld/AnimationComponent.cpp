@@ -1,7 +1,50 @@
 #include "AnimationComponent.h"
 
+#include "Scene/Mesh.h"
+#include "Scene/VertexFormat.h"
+
+#include <algorithm>
+
 namespace engine
 {
 
+void AnimationComponent::Build(const cd::SceneDatabase* pSceneDatabase, std::shared_ptr<const AnimationClip> pClip)
+{
+	m_sampler.Build(pSceneDatabase, cd::MoveTemp(pClip));
+	m_boneMatrices.assign(m_sampler.GetPaletteSize(), cd::Matrix4x4::Identity());
+}
+
+void AnimationComponent::BuildSkinning(const cd::Mesh& mesh)
+{
+	constexpr uint32_t influenceCount = SkinningKernel::InfluenceCount;
+	const uint32_t vertexCount = mesh.GetVertexCount();
+	const uint32_t meshInfluenceCount = std::min(mesh.GetVertexInfluenceCount(), influenceCount);
+	const bool containsNormal = mesh.GetVertexFormat().Contains(cd::VertexAttributeType::Normal);
+
+	std::vector<float> positions(vertexCount * 3U);
+	std::vector<float> normals(containsNormal ? vertexCount * 3U : 0U);
+	std::vector<uint16_t> boneIndices(vertexCount * influenceCount, 0U);
+	std::vector<float> boneWeights(vertexCount * influenceCount, 0.0f);
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		std::copy_n(mesh.GetVertexPosition(vertexIndex).Begin(), 3U, &positions[vertexIndex * 3U]);
+		if (containsNormal)
+		{
+			std::copy_n(mesh.GetVertexNormal(vertexIndex).Begin(), 3U, &normals[vertexIndex * 3U]);
+		}
+
+		for (uint32_t influence = 0U; influence < meshInfluenceCount; ++influence)
+		{
+			cd::BoneID boneID = mesh.GetVertexBoneID(influence, vertexIndex);
+			if (boneID.IsValid())
+			{
+				boneIndices[vertexIndex * influenceCount + influence] = static_cast<uint16_t>(boneID.Data());
+				boneWeights[vertexIndex * influenceCount + influence] = mesh.GetVertexWeight(influence, vertexIndex);
+			}
+		}
+	}
+
+	m_skinning.Build(cd::MoveTemp(positions), cd::MoveTemp(normals), cd::MoveTemp(boneIndices), cd::MoveTemp(boneWeights));
+}
 
 }
\ No newline at end of file
@@ -1,14 +1,19 @@
 #pragma once
 
 #include "Core/StringCrc.h"
+#include "ECWorld/AnimationSampler.h"
+#include "ECWorld/SkinningKernel.hpp"
 #include "Math/Matrix.hpp"
 
+#include <memory>
 #include <vector>
 
 namespace cd
 {
 
 class Animation;
+class Mesh;
+class SceneDatabase;
 class Track;
 
 }
@@ -16,6 +21,13 @@ class Track;
 namespace engine
 {
 
+enum class AnimationLoopMode
+{
+	Once,
+	Loop,
+	PingPong
+};
+
 class AnimationComponent final
 {
 public:
@@ -46,21 +58,55 @@ public:
 	void SetTicksPerSecond(float ticksPerSecond) { m_ticksPerSecond = ticksPerSecond; }
 	float GetTicksPerSecond() const { return m_ticksPerSecond; }
 
-	void SetBoneMatricesUniform(uint16_t uniform) { m_boneMatricesUniform = uniform; }
-	uint16_t GetBoneMatrixsUniform() const { return m_boneMatricesUniform; }
-
 	void SetBoneMatrices(std::vector<cd::Matrix4x4> boneMatrices) { m_boneMatrices = cd::MoveTemp(boneMatrices); }
 	std::vector<cd::Matrix4x4>& GetBoneMatrices() { return m_boneMatrices; }
 	const std::vector<cd::Matrix4x4>& GetBoneMatrices() const { return m_boneMatrices; }
 
+	// Playback time in seconds. AnimationSystem advances it by delta time * speed and wraps it by loop mode.
+	void SetPlaybackTime(float playbackTime) { m_playbackTime = playbackTime; }
+	float GetPlaybackTime() const { return m_playbackTime; }
+
+	void SetPlaybackSpeed(float playbackSpeed) { m_playbackSpeed = playbackSpeed; }
+	float GetPlaybackSpeed() const { return m_playbackSpeed; }
+
+	void SetLoopMode(AnimationLoopMode loopMode) { m_loopMode = loopMode; }
+	AnimationLoopMode GetLoopMode() const { return m_loopMode; }
+
+	void SetPlaying(bool isPlaying) { m_isPlaying = isPlaying; }
+	bool IsPlaying() const { return m_isPlaying; }
+
+	// Resolves clip tracks of skeleton bones once and resets bone matrices to identity. Call it after animation data is set.
+	void Build(const cd::SceneDatabase* pSceneDatabase, std::shared_ptr<const AnimationClip> pClip);
+
+	AnimationSampler& GetSampler() { return m_sampler; }
+	const AnimationSampler& GetSampler() const { return m_sampler; }
+
+	// Copies bind pose streams and bone influences of the skin mesh for bounds and CPU skinning.
+	void BuildSkinning(const cd::Mesh& mesh);
+	SkinningKernel& GetSkinning() { return m_skinning; }
+	const SkinningKernel& GetSkinning() const { return m_skinning; }
+
+	// AnimationSystem refreshes bounds of every evaluated skin mesh, but only skins vertices on the CPU when enabled.
+	void SetCPUSkinningEnabled(bool enable) { m_isCPUSkinningEnabled = enable; }
+	bool IsCPUSkinningEnabled() const { return m_isCPUSkinningEnabled; }
+
 private:
 	const cd::Animation* m_pAnimation = nullptr;
 	const cd::Track* m_pTrack = nullptr;
 	
-	float m_duration;
-	float m_ticksPerSecond;
-	uint16_t m_boneMatricesUniform;
+	float m_duration = 0.0f;
+	float m_ticksPerSecond = 0.0f;
+
+	float m_playbackTime = 0.0f;
+	float m_playbackSpeed = 1.0f;
+	AnimationLoopMode m_loopMode = AnimationLoopMode::Loop;
+	bool m_isPlaying = true;
+
 	std::vector<cd::Matrix4x4> m_boneMatrices;
+	AnimationSampler m_sampler;
+
+	SkinningKernel m_skinning;
+	bool m_isCPUSkinningEnabled = false;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "AnimationSampler.h"
+
+#include "Base/Template.h"
+#include "Math/Transform.hpp"
+#include "Scene/SceneDatabase.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace engine
+{
+
+void AnimationSampler::Build(const cd::SceneDatabase* pSceneDatabase, std::shared_ptr<const AnimationClip> pClip)
+{
+	m_bones.clear();
+	m_keyCursors.clear();
+	m_globalTransforms.clear();
+	m_paletteSize = 0U;
+	m_pClip = cd::MoveTemp(pClip);
+	if (!m_pClip || 0U == pSceneDatabase->GetBoneCount())
+	{
+		return;
+	}
+
+	// Breadth first from the root bone, so parents always come before their children.
+	auto AddBone = [&](const cd::Bone& bone, uint32_t parentIndex)
+	{
+		uint32_t trackIndex = InvalidIndex;
+		if (const cd::Track* pTrack = pSceneDatabase->GetTrackByName(bone.GetName()))
+		{
+			trackIndex = static_cast<uint32_t>(pTrack - pSceneDatabase->GetTracks().data());
+		}
+
+		uint32_t boneID = static_cast<uint32_t>(bone.GetID().Data());
+		m_bones.push_back(SampledBone{ bone.GetTransform().GetMatrix(), bone.GetOffset(), boneID, parentIndex, trackIndex });
+		m_paletteSize = std::max(m_paletteSize, boneID + 1U);
+	};
+
+	AddBone(pSceneDatabase->GetBone(0), InvalidIndex);
+	for (uint32_t boneIndex = 0U; boneIndex < m_bones.size(); ++boneIndex)
+	{
+		const cd::Bone& bone = pSceneDatabase->GetBone(m_bones[boneIndex].boneID);
+		for (cd::BoneID childID : bone.GetChildIDs())
+		{
+			AddBone(pSceneDatabase->GetBone(childID.Data()), boneIndex);
+		}
+	}
+
+	assert(m_pClip->GetTrackCount() == pSceneDatabase->GetTracks().size());
+	m_keyCursors.resize(m_pClip->GetTrackCount());
+	m_globalTransforms.resize(m_bones.size());
+}
+
+void AnimationSampler::Sample(float animationTime, const cd::Matrix4x4& globalInverse, std::vector<cd::Matrix4x4>& boneMatrices)
+{
+	for (uint32_t boneIndex = 0U; boneIndex < m_bones.size(); ++boneIndex)
+	{
+		const SampledBone& bone = m_bones[boneIndex];
+		cd::Matrix4x4 localTransform = bone.bindTransform;
+		if (InvalidIndex != bone.trackIndex)
+		{
+			cd::Vec3f translation;
+			cd::Quaternion rotation;
+			cd::Vec3f scale;
+			m_pClip->Sample(bone.trackIndex, animationTime, m_keyCursors[bone.trackIndex], translation, rotation, scale);
+			localTransform = cd::Transform(translation, rotation, scale).GetMatrix();
+		}
+
+		m_globalTransforms[boneIndex] = InvalidIndex == bone.parentIndex ?
+			localTransform : m_globalTransforms[bone.parentIndex] * localTransform;
+
+		assert(bone.boneID < boneMatrices.size());
+		boneMatrices[bone.boneID] = globalInverse * m_globalTransforms[boneIndex] * bone.offset;
+	}
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ECWorld/AnimationClip.hpp"
+#include "Math/Matrix.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cd
+{
+
+class SceneDatabase;
+
+}
+
+namespace engine
+{
+
+// AnimationSampler evaluates a skeleton from the tracks of an AnimationClip.
+// Build resolves the track of every bone once and sorts bones parent first, so Sample walks bones in one loop
+// without name lookups or recursion. Every track keeps a key cursor per channel which moves forward with playback time.
+// Seeking backwards, e.g. when the animation loops, binary searches the keys again.
+class AnimationSampler final
+{
+public:
+	static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+public:
+	AnimationSampler() = default;
+	AnimationSampler(const AnimationSampler&) = default;
+	AnimationSampler& operator=(const AnimationSampler&) = default;
+	AnimationSampler(AnimationSampler&&) = default;
+	AnimationSampler& operator=(AnimationSampler&&) = default;
+	~AnimationSampler() = default;
+
+	// Clip tracks are in the same order as tracks of the SceneDatabase. Samplers of one animation share the clip.
+	void Build(const cd::SceneDatabase* pSceneDatabase, std::shared_ptr<const AnimationClip> pClip);
+	bool IsValid() const { return m_pClip && !m_bones.empty(); }
+
+	uint32_t GetBoneCount() const { return static_cast<uint32_t>(m_bones.size()); }
+
+	// The largest bone id + 1.
+	uint32_t GetPaletteSize() const { return m_paletteSize; }
+
+	// Bone matrices are indexed by bone id, boneMatrices needs to hold the largest bone id.
+	void Sample(float animationTime, const cd::Matrix4x4& globalInverse, std::vector<cd::Matrix4x4>& boneMatrices);
+
+private:
+	struct SampledBone
+	{
+		cd::Matrix4x4 bindTransform;
+		cd::Matrix4x4 offset;
+		uint32_t boneID;
+
+		// Position of the parent in m_bones, InvalidIndex for the root.
+		uint32_t parentIndex;
+		uint32_t trackIndex;
+	};
+
+	std::shared_ptr<const AnimationClip> m_pClip;
+	uint32_t m_paletteSize = 0U;
+
+	// Parent first.
+	std::vector<SampledBone> m_bones;
+	std::vector<AnimationClip::TrackCursor> m_keyCursors;
+	std::vector<cd::Matrix4x4> m_globalTransforms;
+};
+
+}
\ No newline at end of file
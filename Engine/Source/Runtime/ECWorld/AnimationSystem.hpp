@@ -0,0 +1,192 @@
+#pragma once
+
+#include "ECWorld/AnimationComponent.h"
+#include "ECWorld/CollisionMeshComponent.h"
+#include "ECWorld/CullingSystem.hpp"
+#include "ECWorld/TransformComponent.h"
+#include "ECWorld/World.h"
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <vector>
+
+namespace engine
+{
+
+// AnimationSystem advances playback of every AnimationComponent and evaluates bone matrices of visible ones.
+// Each component owns its playback state, sampler cursors and bone matrices, so skeletons are evaluated in parallel
+// and renderers only upload AnimationComponent::GetBoneMatrices.
+// Evaluated skin meshes also refresh their CollisionMeshComponent AABBs from per bone bounds, and skin vertices
+// on the CPU in parallel vertex ranges if enabled. Culled skin meshes which are playing still sample their pose
+// to refresh bounds, otherwise root motion could leave them culled by stale bounds. They are not skinned.
+class AnimationSystem final
+{
+public:
+	AnimationSystem() = delete;
+	explicit AnimationSystem(World* pWorld, const CullingSystem* pCullingSystem)
+		: m_pAnimationStorage(pWorld->GetComponents<AnimationComponent>())
+		, m_pTransformStorage(pWorld->GetComponents<TransformComponent>())
+		, m_pCollisionMeshStorage(pWorld->GetComponents<CollisionMeshComponent>())
+		, m_pCullingSystem(pCullingSystem)
+	{
+	}
+	AnimationSystem(const AnimationSystem&) = delete;
+	AnimationSystem& operator=(const AnimationSystem&) = delete;
+	AnimationSystem(AnimationSystem&&) = delete;
+	AnimationSystem& operator=(AnimationSystem&&) = delete;
+	~AnimationSystem() = default;
+
+	// Not thread safe. Call it after visibility and world matrices are final for the frame.
+	void Update(float deltaTime)
+	{
+		m_evaluatedEntities.clear();
+		m_sampledEntities.clear();
+		for (Entity entity : m_pAnimationStorage->GetEntities())
+		{
+			AnimationComponent* pAnimationComponent = m_pAnimationStorage->GetComponent(entity);
+			if (!pAnimationComponent)
+			{
+				continue;
+			}
+
+			AdvancePlayback(*pAnimationComponent, deltaTime);
+			if (!pAnimationComponent->GetSampler().IsValid() || !m_pTransformStorage->Contains(entity))
+			{
+				continue;
+			}
+
+			if (m_pCullingSystem->IsVisible(entity))
+			{
+				m_evaluatedEntities.push_back(entity);
+				m_sampledEntities.push_back(entity);
+			}
+			else if (pAnimationComponent->IsPlaying() && IsSkinnable(*pAnimationComponent) && m_pCollisionMeshStorage->Contains(entity))
+			{
+				m_sampledEntities.push_back(entity);
+			}
+		}
+
+		std::for_each(std::execution::par, m_sampledEntities.begin(), m_sampledEntities.end(), [this](Entity entity)
+		{
+			AnimationComponent* pAnimationComponent = m_pAnimationStorage->GetComponent(entity);
+			const TransformComponent* pTransformComponent = m_pTransformStorage->GetComponent(entity);
+			pAnimationComponent->GetSampler().Sample(GetAnimationTime(*pAnimationComponent),
+				pTransformComponent->GetWorldMatrix().Inverse(), pAnimationComponent->GetBoneMatrices());
+
+			CollisionMeshComponent* pCollisionMesh = m_pCollisionMeshStorage->GetComponent(entity);
+			float boundsMin[3];
+			float boundsMax[3];
+			if (pCollisionMesh && IsSkinnable(*pAnimationComponent) &&
+				pAnimationComponent->GetSkinning().ComputeBounds(GetPalette(*pAnimationComponent), boundsMin, boundsMax))
+			{
+				pCollisionMesh->SetAABB(cd::AABB(cd::Point(boundsMin[0], boundsMin[1], boundsMin[2]), cd::Point(boundsMax[0], boundsMax[1], boundsMax[2])));
+			}
+		});
+
+		// Changed bounds move proxies of SpatialSystem in the next SceneWorld::Update.
+		for (Entity entity : m_sampledEntities)
+		{
+			if (IsSkinnable(*m_pAnimationStorage->GetComponent(entity)))
+			{
+				m_pCollisionMeshStorage->MarkChanged(entity);
+			}
+		}
+
+		m_skinningJobs.clear();
+		for (Entity entity : m_evaluatedEntities)
+		{
+			AnimationComponent* pAnimationComponent = m_pAnimationStorage->GetComponent(entity);
+			if (IsSkinnable(*pAnimationComponent) && pAnimationComponent->IsCPUSkinningEnabled())
+			{
+				for (uint32_t rangeIndex = 0U; rangeIndex < pAnimationComponent->GetSkinning().GetVertexRangeCount(); ++rangeIndex)
+				{
+					m_skinningJobs.push_back(SkinningJob{ pAnimationComponent, rangeIndex });
+				}
+			}
+		}
+
+		// Vertex ranges of all meshes are skinned in one parallel pass so that one large mesh doesn't serialize the frame.
+		std::for_each(std::execution::par, m_skinningJobs.begin(), m_skinningJobs.end(), [](const SkinningJob& job)
+		{
+			job.pAnimationComponent->GetSkinning().SkinRange(GetPalette(*job.pAnimationComponent), job.rangeIndex);
+		});
+	}
+
+	// Visible entities whose bone matrices were evaluated by the last Update.
+	const std::vector<Entity>& GetEvaluatedEntities() const { return m_evaluatedEntities; }
+
+	// Playback time in seconds is wrapped to [0, length] for Once and Loop, [0, 2 * length] for PingPong.
+	static void AdvancePlayback(AnimationComponent& animationComponent, float deltaTime)
+	{
+		float length = GetLength(animationComponent);
+		if (length <= 0.0f)
+		{
+			animationComponent.SetPlaybackTime(0.0f);
+			return;
+		}
+
+		float playbackTime = animationComponent.GetPlaybackTime();
+		if (animationComponent.IsPlaying())
+		{
+			playbackTime += deltaTime * animationComponent.GetPlaybackSpeed();
+		}
+
+		if (AnimationLoopMode::Once == animationComponent.GetLoopMode())
+		{
+			playbackTime = std::clamp(playbackTime, 0.0f, length);
+		}
+		else
+		{
+			float period = AnimationLoopMode::PingPong == animationComponent.GetLoopMode() ? 2.0f * length : length;
+			playbackTime -= std::floor(playbackTime / period) * period;
+		}
+		animationComponent.SetPlaybackTime(playbackTime);
+	}
+
+	// Returns the time in ticks to sample tracks.
+	static float GetAnimationTime(const AnimationComponent& animationComponent)
+	{
+		float length = GetLength(animationComponent);
+		float playbackTime = animationComponent.GetPlaybackTime();
+		if (AnimationLoopMode::PingPong == animationComponent.GetLoopMode() && playbackTime > length)
+		{
+			playbackTime = 2.0f * length - playbackTime;
+		}
+
+		return playbackTime * animationComponent.GetTicksPerSecond();
+	}
+
+private:
+	struct SkinningJob
+	{
+		AnimationComponent* pAnimationComponent;
+		uint32_t rangeIndex;
+	};
+
+	static bool IsSkinnable(const AnimationComponent& animationComponent)
+	{
+		const SkinningKernel& skinning = animationComponent.GetSkinning();
+		return skinning.IsValid() && skinning.GetPaletteSize() <= animationComponent.GetBoneMatrices().size();
+	}
+
+	static const float* GetPalette(const AnimationComponent& animationComponent) { return animationComponent.GetBoneMatrices().front().Begin(); }
+
+	static float GetLength(const AnimationComponent& animationComponent)
+	{
+		float ticksPerSecond = animationComponent.GetTicksPerSecond();
+		return ticksPerSecond > 0.0f ? animationComponent.GetDuration() / ticksPerSecond : 0.0f;
+	}
+
+private:
+	ComponentsStorage<AnimationComponent>* m_pAnimationStorage;
+	ComponentsStorage<TransformComponent>* m_pTransformStorage;
+	ComponentsStorage<CollisionMeshComponent>* m_pCollisionMeshStorage;
+	const CullingSystem* m_pCullingSystem;
+
+	std::vector<Entity> m_evaluatedEntities;
+	std::vector<Entity> m_sampledEntities;
+	std::vector<SkinningJob> m_skinningJobs;
+};
+
+}
\ No newline at end of file
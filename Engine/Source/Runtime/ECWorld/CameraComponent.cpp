@@ -23,6 +23,14 @@ void CameraComponent::BuildProjectMatrix()
 }
 
 cd::Ray CameraComponent::EmitRay(float screenX, float screenY, float width, float height) const
+{
+	cd::Vec3f origin;
+	cd::Vec3f direction;
+	EmitRay(screenX, screenY, width, height, origin, direction);
+	return cd::Ray(origin, direction);
+}
+
+void CameraComponent::EmitRay(float screenX, float screenY, float width, float height, cd::Vec3f& origin, cd::Vec3f& direction) const
 {
 	cd::Matrix4x4 vpInverse = m_projectionMatrix * m_viewMatrix;
 	vpInverse = vpInverse.Inverse();
@@ -36,9 +44,9 @@ cd::Ray CameraComponent::EmitRay(float screenX, float screenY, float width, floa
 	cd::Vec4f far = vpInverse * cd::Vec4f(x, -y, 1.0f, 1.0f);
 	far /= far.w();
 
-	cd::Vec4f direction = (far - near).Normalize();
-	return cd::Ray(cd::Vec3f(near.x(), near.y(), near.z()),
-		cd::Vec3f(direction.x(), direction.y(), direction.z()));
+	cd::Vec4f rayDirection = (far - near).Normalize();
+	origin = cd::Vec3f(near.x(), near.y(), near.z());
+	direction = cd::Vec3f(rayDirection.x(), rayDirection.y(), rayDirection.z());
 }
 
 void CameraComponent::SetLookAt(const cd::Vec3f& lookAt, cd::Transform& transform)
@@ -54,6 +54,7 @@ public:
 	~CameraComponent() = default;
 
 	cd::Ray EmitRay(float screenX, float screenY, float width, float height) const;
+	void EmitRay(float screenX, float screenY, float width, float height, cd::Vec3f& origin, cd::Vec3f& direction) const;
 
 	void SetAspect(float aspect) { m_aspect = aspect; m_isProjectionDirty = true; }
 	void SetAspect(uint16_t width, uint16_t height) { SetAspect(static_cast<float>(width) / static_cast<float>(height)); }
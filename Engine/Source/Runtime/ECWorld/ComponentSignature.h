@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ComponentTypeID.h"
+#include "Entity.h"
+#include "PagedSparseArray.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace engine
+{
+
+// ComponentSignature is a bitmask which bit N means the entity owns a component whose ComponentTypeID is N.
+using ComponentSignature = uint64_t;
+static_assert(MAX_COMPONENT_TYPE_COUNT <= sizeof(ComponentSignature) * 8U, "ComponentSignature can't hold all component types.");
+
+template<typename... Components>
+ComponentSignature GetComponentSignature()
+{
+	return ((static_cast<ComponentSignature>(1U) << GetComponentTypeID<Components>()) | ... | static_cast<ComponentSignature>(0U));
+}
+
+// Returns index of the lowest set bit. bits should not be 0.
+inline uint32_t GetLowestBitIndex(uint64_t bits)
+{
+	assert(bits != 0U);
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, bits);
+	return static_cast<uint32_t>(index);
+#else
+	return static_cast<uint32_t>(__builtin_ctzll(bits));
+#endif
+}
+
+// ComponentSignatureTable stores ComponentSignature per entity index. It is updated by registered ComponentsStorages.
+class ComponentSignatureTable final
+{
+public:
+	ComponentSignatureTable() = default;
+	ComponentSignatureTable(const ComponentSignatureTable&) = delete;
+	ComponentSignatureTable& operator=(const ComponentSignatureTable&) = delete;
+	ComponentSignatureTable(ComponentSignatureTable&&) = default;
+	ComponentSignatureTable& operator=(ComponentSignatureTable&&) = default;
+	~ComponentSignatureTable() = default;
+
+	ComponentSignature Get(Entity entity) const { return m_signatures.Get(GetEntityIndex(entity)); }
+
+	void Add(Entity entity, ComponentTypeID typeID)
+	{
+		uint32_t entityIndex = GetEntityIndex(entity);
+		m_signatures.Set(entityIndex, m_signatures.Get(entityIndex) | (static_cast<ComponentSignature>(1U) << typeID));
+	}
+
+	void Remove(Entity entity, ComponentTypeID typeID)
+	{
+		uint32_t entityIndex = GetEntityIndex(entity);
+		m_signatures.Set(entityIndex, m_signatures.Get(entityIndex) & ~(static_cast<ComponentSignature>(1U) << typeID));
+	}
+
+private:
+	PagedSparseArray<ComponentSignature, 0U> m_signatures;
+};
+
+}
\ No newline at end of file
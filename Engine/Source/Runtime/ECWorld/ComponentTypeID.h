@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+#include <cstdint>
+
+namespace engine
+{
+
+// ComponentTypeID is a dense index [0, MAX_COMPONENT_TYPE_COUNT) assigned to every component type on first use.
+// It is used to index storages in World and bits in entity component signatures.
+using ComponentTypeID = uint32_t;
+static constexpr ComponentTypeID MAX_COMPONENT_TYPE_COUNT = 64U;
+
+class ComponentTypeRegistry final
+{
+public:
+	ComponentTypeRegistry() = delete;
+
+	template<typename Component>
+	static ComponentTypeID GetID()
+	{
+		static const ComponentTypeID typeID = s_nextTypeID.fetch_add(1U);
+		return typeID;
+	}
+
+	static ComponentTypeID GetTypeCount() { return s_nextTypeID.load(); }
+
+private:
+	static inline std::atomic<ComponentTypeID> s_nextTypeID = 0U;
+};
+
+template<typename Component>
+ComponentTypeID GetComponentTypeID()
+{
+	return ComponentTypeRegistry::GetID<std::remove_cv_t<Component>>();
+}
+
+}
\ No newline at end of file
@@ -1,11 +1,11 @@
 #pragma once
 
+#include "ComponentSignature.h"
 #include "Entity.h"
+#include "PagedSparseArray.hpp"
 
 #include <algorithm>
 #include <cassert>
-#include <map>
-#include <unordered_map>
 #include <vector>
 
 namespace engine
@@ -15,9 +15,13 @@ class IComponentsStorage
 {
 public:
 	virtual ~IComponentsStorage() = default;
+
+	virtual void RemoveComponent(Entity entity) = 0;
+	virtual void ClearChanged() = 0;
 };
 
 // ComponentsStorage stores an array of Components in the same type and the entity which contains the component.
+// It is a sparse set : a paged sparse array maps entity index to dense index, dense arrays store entities and components.
 template<typename Component>
 class ComponentsStorage : public IComponentsStorage
 {
@@ -32,11 +36,18 @@ public:
 	ComponentsStorage& operator=(ComponentsStorage&&) = default;
 	virtual ~ComponentsStorage() = default;
 
+	// Keep signatures of entities in sync when components are created or removed.
+	void BindSignatureTable(ComponentSignatureTable* pSignatureTable, ComponentTypeID typeID)
+	{
+		m_pSignatureTable = pSignatureTable;
+		m_typeID = typeID;
+	}
+
 	// Returns if ComponentStorage stores component for entity.
-	bool Contains(Entity entity) const { return m_entityToIndex.find(entity) != m_entityToIndex.end(); }
+	bool Contains(Entity entity) const { return GetDenseIndex(entity) != InvalidDenseIndex; }
 
 	// Returns current active components count.
-	size_t GetCount() const { return m_entityToIndex.size(); }
+	size_t GetCount() const { return m_entities.size(); }
 
 	// Returns current components capcity.
 	size_t GetCapcity() const { assert(m_entities.size() == m_components.size()); return m_entities.size(); }
@@ -44,11 +55,103 @@ public:
 	// Need to check if it is still active.
 	const std::vector<Entity>& GetEntities() const { return m_entities; }
 
+	// Change tracking is optional. When enabled, every component has a changed bit and a version which
+	// are updated by CreateComponent, ModifyComponent and MarkChanged. GetComponent doesn't record changes.
+	void EnableChangeTracking()
+	{
+		if (m_isChangeTrackingEnabled)
+		{
+			return;
+		}
+
+		m_isChangeTrackingEnabled = true;
+		m_versions.assign(m_entities.size(), m_version);
+		m_changedBits.assign(GetChangedWordCount(m_entities.size()), 0U);
+	}
+
+	bool IsChangeTrackingEnabled() const { return m_isChangeTrackingEnabled; }
+
+	// Returns the latest version of all components in the storage. It increases on every recorded change.
+	uint32_t GetVersion() const { return m_version; }
+
+	// Returns the version of the last recorded change on entity's component, or 0 if there is no such component.
+	uint32_t GetVersion(Entity entity) const
+	{
+		uint32_t denseIndex = GetDenseIndex(entity);
+		return m_isChangeTrackingEnabled && denseIndex != InvalidDenseIndex ? m_versions[denseIndex] : 0U;
+	}
+
+	// Returns if entity's component changed since the last ClearChanged.
+	bool IsChanged(Entity entity) const
+	{
+		uint32_t denseIndex = GetDenseIndex(entity);
+		return m_isChangeTrackingEnabled && denseIndex != InvalidDenseIndex && IsChangedAt(denseIndex);
+	}
+
+	// Get component to write. The change is recorded if tracking is enabled.
+	Component* ModifyComponent(Entity entity)
+	{
+		uint32_t denseIndex = GetDenseIndex(entity);
+		if (denseIndex == InvalidDenseIndex)
+		{
+			return nullptr;
+		}
+
+		MarkChangedAt(denseIndex);
+		return &m_components[denseIndex];
+	}
+
+	// Record a change which was done through a pointer from GetComponent.
+	void MarkChanged(Entity entity)
+	{
+		uint32_t denseIndex = GetDenseIndex(entity);
+		if (denseIndex != InvalidDenseIndex)
+		{
+			MarkChangedAt(denseIndex);
+		}
+	}
+
+	// func(Entity, Component&) for components changed since the last ClearChanged.
+	template<typename Func>
+	void ForEachChanged(Func&& func)
+	{
+		if (!m_isChangeTrackingEnabled || !m_hasChanges)
+		{
+			return;
+		}
+
+		for (size_t wordIndex = 0; wordIndex < m_changedBits.size(); ++wordIndex)
+		{
+			uint64_t bits = m_changedBits[wordIndex];
+			while (bits != 0U)
+			{
+				size_t denseIndex = wordIndex * 64U + GetLowestBitIndex(bits);
+				func(m_entities[denseIndex], m_components[denseIndex]);
+				bits &= bits - 1U;
+			}
+		}
+	}
+
+	virtual void ClearChanged() override
+	{
+		if (m_hasChanges)
+		{
+			std::fill(m_changedBits.begin(), m_changedBits.end(), 0U);
+			m_hasChanges = false;
+		}
+	}
+
 	// Get component by entity.
 	Component* GetComponent(Entity entity)
 	{
-		auto itIndex = m_entityToIndex.find(entity);
-		return itIndex == m_entityToIndex.end() ? nullptr : &m_components[itIndex->second];
+		uint32_t denseIndex = GetDenseIndex(entity);
+		return denseIndex == InvalidDenseIndex ? nullptr : &m_components[denseIndex];
+	}
+
+	const Component* GetComponent(Entity entity) const
+	{
+		uint32_t denseIndex = GetDenseIndex(entity);
+		return denseIndex == InvalidDenseIndex ? nullptr : &m_components[denseIndex];
 	}
 
 	// Create component for entity.
@@ -56,39 +159,108 @@ public:
 	{
 		assert(entity != INVALID_ENTITY && !Contains(entity));
 
-		m_entityToIndex[entity] = m_components.size();
+		m_entityToIndex.Set(GetEntityIndex(entity), static_cast<uint32_t>(m_components.size()));
 		m_entities.emplace_back(entity);
 		m_components.emplace_back();
+		if (m_pSignatureTable)
+		{
+			m_pSignatureTable->Add(entity, m_typeID);
+		}
+		if (m_isChangeTrackingEnabled)
+		{
+			m_versions.emplace_back();
+			m_changedBits.resize(GetChangedWordCount(m_entities.size()), 0U);
+			MarkChangedAt(static_cast<uint32_t>(m_entities.size() - 1));
+		}
 		return m_components.back();
 	}
 
 	// Remove actvie component from storage.
-	void RemoveComponent(Entity entity)
+	virtual void RemoveComponent(Entity entity) override
 	{
-		auto itIndex = m_entityToIndex.find(entity);
-		if (itIndex == m_entityToIndex.end())
+		uint32_t unusedIndex = GetDenseIndex(entity);
+		if (unusedIndex == InvalidDenseIndex)
 		{
 			return;
 		}
 
-		if (m_entityToIndex.size() > 1)
+		uint32_t lastIndex = static_cast<uint32_t>(m_entities.size() - 1);
+		if (unusedIndex != lastIndex)
 		{
-			size_t unusedIndex = itIndex->second;
 			Entity lastEntity = m_entities.back();
 			m_entities[unusedIndex] = lastEntity;
 			m_components[unusedIndex] = cd::MoveTemp(m_components.back());
-			m_entityToIndex[lastEntity] = unusedIndex;
+			m_entityToIndex.Set(GetEntityIndex(lastEntity), unusedIndex);
+			if (m_isChangeTrackingEnabled)
+			{
+				m_versions[unusedIndex] = m_versions.back();
+				SetChangedAt(unusedIndex, IsChangedAt(lastIndex));
+			}
 		}
 
+		if (m_isChangeTrackingEnabled)
+		{
+			m_versions.pop_back();
+			SetChangedAt(lastIndex, false);
+		}
 		m_entities.pop_back();
 		m_components.pop_back();
-		m_entityToIndex.erase(entity);
+		m_entityToIndex.Reset(GetEntityIndex(entity));
+		if (m_pSignatureTable)
+		{
+			m_pSignatureTable->Remove(entity, m_typeID);
+		}
+	}
+
+private:
+	static constexpr uint32_t InvalidDenseIndex = UINT32_MAX;
+
+	uint32_t GetDenseIndex(Entity entity) const
+	{
+		if (entity == INVALID_ENTITY)
+		{
+			return InvalidDenseIndex;
+		}
+
+		// Double check dense side so that a stale handle with old generation can never alias the recycled entity.
+		uint32_t denseIndex = m_entityToIndex.Get(GetEntityIndex(entity));
+		return denseIndex < m_entities.size() && m_entities[denseIndex] == entity ? denseIndex : InvalidDenseIndex;
+	}
+
+	static size_t GetChangedWordCount(size_t componentCount) { return (componentCount + 63U) / 64U; }
+	bool IsChangedAt(uint32_t denseIndex) const { return 0U != (m_changedBits[denseIndex / 64U] & (static_cast<uint64_t>(1U) << (denseIndex % 64U))); }
+
+	void SetChangedAt(uint32_t denseIndex, bool isChanged)
+	{
+		uint64_t bit = static_cast<uint64_t>(1U) << (denseIndex % 64U);
+		uint64_t& word = m_changedBits[denseIndex / 64U];
+		word = isChanged ? (word | bit) : (word & ~bit);
+	}
+
+	void MarkChangedAt(uint32_t denseIndex)
+	{
+		if (m_isChangeTrackingEnabled)
+		{
+			m_versions[denseIndex] = ++m_version;
+			SetChangedAt(denseIndex, true);
+			m_hasChanges = true;
+		}
 	}
 
 private:
 	std::vector<Entity> m_entities;
 	std::vector<Component> m_components;
-	std::unordered_map<Entity, size_t> m_entityToIndex;
+	PagedSparseArray<uint32_t, UINT32_MAX> m_entityToIndex;
+
+	ComponentSignatureTable* m_pSignatureTable = nullptr;
+	ComponentTypeID m_typeID = 0U;
+
+	// Change tracking, indexed by dense index.
+	bool m_isChangeTrackingEnabled = false;
+	bool m_hasChanges = false;
+	uint32_t m_version = 0U;
+	std::vector<uint32_t> m_versions;
+	std::vector<uint64_t> m_changedBits;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "ECWorld/CollisionMeshComponent.h"
+#include "ECWorld/FrustumCuller.hpp"
+#include "ECWorld/PagedSparseArray.hpp"
+#include "ECWorld/SpatialSystem.hpp"
+#include "ECWorld/TransformComponent.h"
+#include "ECWorld/World.h"
+
+#include <vector>
+
+namespace engine
+{
+
+// CullingSystem decides once per frame which entities are inside the camera frustum so that every renderer shares the result.
+// SpatialSystem's tree rejects whole subtrees outside the frustum, then candidates are tested with their exact
+// CollisionMeshComponent AABBs and current TransformComponent world matrices.
+// Entities without bounds are never culled.
+class CullingSystem final
+{
+public:
+	CullingSystem() = delete;
+	explicit CullingSystem(World* pWorld, const SpatialSystem* pSpatialSystem)
+		: m_pCollisionMeshStorage(pWorld->GetComponents<CollisionMeshComponent>())
+		, m_pTransformStorage(pWorld->GetComponents<TransformComponent>())
+		, m_pSpatialSystem(pSpatialSystem)
+	{
+	}
+	CullingSystem(const CullingSystem&) = delete;
+	CullingSystem& operator=(const CullingSystem&) = delete;
+	CullingSystem(CullingSystem&&) = delete;
+	CullingSystem& operator=(CullingSystem&&) = delete;
+	~CullingSystem() = default;
+
+	// Not thread safe. Call it after camera matrices and world matrices are final for the frame.
+	void Update(const cd::Matrix4x4& viewProjection, bool isDepthZeroToOne)
+	{
+		for (Entity entity : m_visibleEntities)
+		{
+			m_visibleMarks.Reset(GetEntityIndex(entity));
+		}
+		m_visibleEntities.clear();
+		m_candidates.clear();
+
+		m_culler.Clear();
+		m_culler.SetViewProjection(viewProjection.Begin(), isDepthZeroToOne);
+		m_pSpatialSystem->QueryFrustum(m_culler, [this](Entity entity)
+		{
+			const CollisionMeshComponent* pCollisionMesh = m_pCollisionMeshStorage->GetComponent(entity);
+			const TransformComponent* pTransform = m_pTransformStorage->GetComponent(entity);
+			if (pCollisionMesh && pTransform)
+			{
+				const cd::AABB& aabb = pCollisionMesh->GetAABB();
+				m_culler.Add(aabb.Min().Begin(), aabb.Max().Begin(), pTransform->GetWorldMatrix().Begin());
+				m_candidates.push_back(entity);
+			}
+		});
+		m_culler.Cull();
+
+		for (size_t index = 0; index < m_candidates.size(); ++index)
+		{
+			if (m_culler.IsVisible(index))
+			{
+				Entity entity = m_candidates[index];
+				m_visibleMarks.Set(GetEntityIndex(entity), entity);
+				m_visibleEntities.push_back(entity);
+			}
+		}
+		m_culledCount = m_pSpatialSystem->GetEntityCount() - m_visibleEntities.size();
+	}
+
+	// Entities which are not in SpatialSystem yet are visible.
+	bool IsVisible(Entity entity) const
+	{
+		return m_visibleMarks.Get(GetEntityIndex(entity)) == entity || !m_pSpatialSystem->Contains(entity);
+	}
+
+	// Entities with bounds which passed the last Update.
+	const std::vector<Entity>& GetVisibleEntities() const { return m_visibleEntities; }
+	size_t GetVisibleCount() const { return m_visibleEntities.size(); }
+	size_t GetCulledCount() const { return m_culledCount; }
+
+private:
+	ComponentsStorage<CollisionMeshComponent>* m_pCollisionMeshStorage;
+	ComponentsStorage<TransformComponent>* m_pTransformStorage;
+	const SpatialSystem* m_pSpatialSystem;
+
+	FrustumCuller m_culler;
+	std::vector<Entity> m_candidates;
+	std::vector<Entity> m_visibleEntities;
+	size_t m_culledCount = 0;
+
+	// Entity index -> the visible entity. Storing the full id keeps recycled indices apart.
+	PagedSparseArray<Entity, INVALID_ENTITY> m_visibleMarks;
+};
+
+}
\ No newline at end of file
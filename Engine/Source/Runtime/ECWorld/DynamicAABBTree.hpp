@@ -0,0 +1,531 @@
+#pragma once
+
+#include "ECWorld/Entity.h"
+#include "ECWorld/FrustumCuller.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace engine
+{
+
+// DynamicAABBTree is a binary tree of bounding boxes whose leaves are proxies of entities.
+// Leaves store fat boxes which are larger than the entity bounds so that small moves don't touch the tree.
+// Inserting picks the sibling with the least surface area cost and rotations keep the tree balanced,
+// so queries visit O(log n) nodes plus the nodes which overlap the query.
+class DynamicAABBTree final
+{
+public:
+	static constexpr uint32_t NullNode = UINT32_MAX;
+
+	// Fat boxes grow by this fraction of the entity bounds size on each side.
+	static constexpr float FatRatio = 0.1f;
+
+public:
+	DynamicAABBTree() = default;
+	DynamicAABBTree(const DynamicAABBTree&) = delete;
+	DynamicAABBTree& operator=(const DynamicAABBTree&) = delete;
+	DynamicAABBTree(DynamicAABBTree&&) = default;
+	DynamicAABBTree& operator=(DynamicAABBTree&&) = default;
+	~DynamicAABBTree() = default;
+
+	// Returns proxy id which stays valid until DestroyProxy.
+	uint32_t CreateProxy(const float* pMin, const float* pMax, Entity entity)
+	{
+		uint32_t proxy = AllocateNode();
+		Node& node = m_nodes[proxy];
+		SetFatBox(node, pMin, pMax);
+		node.entity = entity;
+		node.height = 0;
+		InsertLeaf(proxy);
+		++m_proxyCount;
+		return proxy;
+	}
+
+	void DestroyProxy(uint32_t proxy)
+	{
+		assert(IsLeaf(proxy));
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		--m_proxyCount;
+	}
+
+	// Returns true if the proxy was reinserted. Bounds which are still inside the fat box keep the tree as is
+	// unless the fat box became too loose for them.
+	bool MoveProxy(uint32_t proxy, const float* pMin, const float* pMax)
+	{
+		assert(IsLeaf(proxy));
+		Node& node = m_nodes[proxy];
+		if (Contains(node.min, node.max, pMin, pMax))
+		{
+			float looseMin[3];
+			float looseMax[3];
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				float margin = 4.0f * FatRatio * (pMax[axis] - pMin[axis]);
+				looseMin[axis] = pMin[axis] - margin;
+				looseMax[axis] = pMax[axis] + margin;
+			}
+
+			if (Contains(looseMin, looseMax, node.min, node.max))
+			{
+				return false;
+			}
+		}
+
+		RemoveLeaf(proxy);
+		SetFatBox(m_nodes[proxy], pMin, pMax);
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	Entity GetEntity(uint32_t proxy) const { return m_nodes[proxy].entity; }
+	const float* GetFatMin(uint32_t proxy) const { return m_nodes[proxy].min; }
+	const float* GetFatMax(uint32_t proxy) const { return m_nodes[proxy].max; }
+
+	size_t GetProxyCount() const { return m_proxyCount; }
+	int32_t GetHeight() const { return NullNode == m_root ? 0 : m_nodes[m_root].height; }
+
+	// func(uint32_t proxy, Entity).
+	template<typename Func>
+	void ForEachProxy(Func&& func) const
+	{
+		for (uint32_t nodeIndex = 0; nodeIndex < m_nodes.size(); ++nodeIndex)
+		{
+			if (0 == m_nodes[nodeIndex].height)
+			{
+				func(nodeIndex, m_nodes[nodeIndex].entity);
+			}
+		}
+	}
+
+	// func(Entity) for leaves whose fat box overlaps the box.
+	template<typename Func>
+	void QueryBox(const float* pMin, const float* pMax, Func&& func) const
+	{
+		Traverse([pMin, pMax](const Node& node) { return Overlaps(node.min, node.max, pMin, pMax); }, func);
+	}
+
+	// func(Entity) for leaves whose fat box is not completely outside the frustum.
+	// Subtrees completely inside the frustum are reported without testing their nodes.
+	template<typename Func>
+	void QueryFrustum(const FrustumCuller& frustum, Func&& func) const
+	{
+		if (NullNode == m_root)
+		{
+			return;
+		}
+
+		std::vector<std::pair<uint32_t, bool>> stack;
+		stack.emplace_back(m_root, false);
+		while (!stack.empty())
+		{
+			auto [nodeIndex, isInside] = stack.back();
+			stack.pop_back();
+
+			const Node& node = m_nodes[nodeIndex];
+			if (!isInside)
+			{
+				bool isOutside = false;
+				isInside = true;
+				for (size_t planeIndex = 0; planeIndex < FrustumCuller::PlaneCount && !isOutside; ++planeIndex)
+				{
+					const float* pPlane = frustum.GetPlane(planeIndex);
+					float distance = pPlane[3];
+					float radius = 0.0f;
+					for (size_t axis = 0; axis < 3; ++axis)
+					{
+						distance += pPlane[axis] * (node.min[axis] + node.max[axis]) * 0.5f;
+						radius += std::fabs(pPlane[axis]) * (node.max[axis] - node.min[axis]) * 0.5f;
+					}
+					isOutside = distance + radius < 0.0f;
+					isInside = isInside && distance - radius >= 0.0f;
+				}
+
+				if (isOutside)
+				{
+					continue;
+				}
+			}
+
+			if (node.IsLeaf())
+			{
+				func(node.entity);
+			}
+			else
+			{
+				stack.emplace_back(node.child1, isInside);
+				stack.emplace_back(node.child2, isInside);
+			}
+		}
+	}
+
+	// func(Entity, float maxDistance) -> float for leaves whose fat box is hit by the ray before maxDistance.
+	// The returned value clips the ray so that a closest hit search skips farther subtrees.
+	template<typename Func>
+	void QueryRay(const float* pOrigin, const float* pDirection, float maxDistance, Func&& func) const
+	{
+		float inverseDirection[3];
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			inverseDirection[axis] = 0.0f == pDirection[axis] ? std::numeric_limits<float>::infinity() : 1.0f / pDirection[axis];
+		}
+
+		Traverse([pOrigin, &inverseDirection, &maxDistance](const Node& node)
+		{
+			float enter = 0.0f;
+			float exit = maxDistance;
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				float t0 = (node.min[axis] - pOrigin[axis]) * inverseDirection[axis];
+				float t1 = (node.max[axis] - pOrigin[axis]) * inverseDirection[axis];
+				enter = std::max(enter, std::min(t0, t1));
+				exit = std::min(exit, std::max(t0, t1));
+			}
+			return enter <= exit;
+		}, [&func, &maxDistance](Entity entity) { maxDistance = func(entity, maxDistance); });
+	}
+
+private:
+	struct Node
+	{
+		float min[3];
+		float max[3];
+		Entity entity = INVALID_ENTITY;
+
+		// Next free node when the node is free.
+		uint32_t parent = NullNode;
+		uint32_t child1 = NullNode;
+		uint32_t child2 = NullNode;
+
+		// Leaf is 0, free node is -1.
+		int32_t height = -1;
+
+		bool IsLeaf() const { return NullNode == child1; }
+	};
+
+	bool IsLeaf(uint32_t nodeIndex) const { return nodeIndex < m_nodes.size() && 0 == m_nodes[nodeIndex].height; }
+
+	static bool Contains(const float* pOuterMin, const float* pOuterMax, const float* pInnerMin, const float* pInnerMax)
+	{
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			if (pInnerMin[axis] < pOuterMin[axis] || pInnerMax[axis] > pOuterMax[axis])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static bool Overlaps(const float* pMinA, const float* pMaxA, const float* pMinB, const float* pMaxB)
+	{
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			if (pMaxA[axis] < pMinB[axis] || pMaxB[axis] < pMinA[axis])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Half of the surface area, which is enough to compare costs.
+	static float GetArea(const float* pMin, const float* pMax)
+	{
+		float x = pMax[0] - pMin[0];
+		float y = pMax[1] - pMin[1];
+		float z = pMax[2] - pMin[2];
+		return x * y + y * z + z * x;
+	}
+
+	static void Union(const Node& a, const Node& b, float* pMin, float* pMax)
+	{
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			pMin[axis] = std::min(a.min[axis], b.min[axis]);
+			pMax[axis] = std::max(a.max[axis], b.max[axis]);
+		}
+	}
+
+	static void SetFatBox(Node& node, const float* pMin, const float* pMax)
+	{
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			float margin = FatRatio * (pMax[axis] - pMin[axis]);
+			node.min[axis] = pMin[axis] - margin;
+			node.max[axis] = pMax[axis] + margin;
+		}
+	}
+
+	// isHit(const Node&) decides if a subtree should be visited. func(Entity) is called for hit leaves.
+	template<typename HitFunc, typename Func>
+	void Traverse(HitFunc&& isHit, Func&& func) const
+	{
+		if (NullNode == m_root)
+		{
+			return;
+		}
+
+		std::vector<uint32_t> stack;
+		stack.push_back(m_root);
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+			if (!isHit(node))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				func(node.entity);
+			}
+			else
+			{
+				stack.push_back(node.child1);
+				stack.push_back(node.child2);
+			}
+		}
+	}
+
+	uint32_t AllocateNode()
+	{
+		uint32_t nodeIndex = m_freeList;
+		if (NullNode == nodeIndex)
+		{
+			nodeIndex = static_cast<uint32_t>(m_nodes.size());
+			m_nodes.emplace_back();
+		}
+		else
+		{
+			m_freeList = m_nodes[nodeIndex].parent;
+		}
+
+		m_nodes[nodeIndex] = Node{};
+		return nodeIndex;
+	}
+
+	void FreeNode(uint32_t nodeIndex)
+	{
+		Node& node = m_nodes[nodeIndex];
+		node.parent = m_freeList;
+		node.child1 = NullNode;
+		node.child2 = NullNode;
+		node.height = -1;
+		node.entity = INVALID_ENTITY;
+		m_freeList = nodeIndex;
+	}
+
+	void InsertLeaf(uint32_t leaf)
+	{
+		if (NullNode == m_root)
+		{
+			m_root = leaf;
+			m_nodes[leaf].parent = NullNode;
+			return;
+		}
+
+		// Descend to the sibling which adds the least area, counting the growth of all ancestors.
+		float combinedMin[3];
+		float combinedMax[3];
+		uint32_t sibling = m_root;
+		while (!m_nodes[sibling].IsLeaf())
+		{
+			const Node& node = m_nodes[sibling];
+			Union(node, m_nodes[leaf], combinedMin, combinedMax);
+			float combinedArea = GetArea(combinedMin, combinedMax);
+
+			// Cost of making a new parent for this node and the leaf.
+			float cost = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - GetArea(node.min, node.max));
+
+			auto GetDescendCost = [this, leaf, inheritanceCost](uint32_t child)
+			{
+				const Node& childNode = m_nodes[child];
+				float childMin[3];
+				float childMax[3];
+				Union(m_nodes[leaf], childNode, childMin, childMax);
+				float childCost = GetArea(childMin, childMax);
+				if (!childNode.IsLeaf())
+				{
+					childCost -= GetArea(childNode.min, childNode.max);
+				}
+				return childCost + inheritanceCost;
+			};
+
+			float cost1 = GetDescendCost(node.child1);
+			float cost2 = GetDescendCost(node.child2);
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+			sibling = cost1 < cost2 ? node.child1 : node.child2;
+		}
+
+		uint32_t oldParent = m_nodes[sibling].parent;
+		uint32_t newParent = AllocateNode();
+		{
+			Node& parentNode = m_nodes[newParent];
+			parentNode.parent = oldParent;
+			Union(m_nodes[leaf], m_nodes[sibling], parentNode.min, parentNode.max);
+			parentNode.height = m_nodes[sibling].height + 1;
+			parentNode.child1 = sibling;
+			parentNode.child2 = leaf;
+		}
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+
+		if (NullNode == oldParent)
+		{
+			m_root = newParent;
+		}
+		else
+		{
+			ReplaceChild(oldParent, sibling, newParent);
+		}
+
+		Refit(newParent);
+	}
+
+	void RemoveLeaf(uint32_t leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = NullNode;
+			return;
+		}
+
+		uint32_t parent = m_nodes[leaf].parent;
+		uint32_t grandParent = m_nodes[parent].parent;
+		uint32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+		FreeNode(parent);
+		m_nodes[sibling].parent = grandParent;
+		m_nodes[leaf].parent = NullNode;
+
+		if (NullNode == grandParent)
+		{
+			m_root = sibling;
+			return;
+		}
+
+		ReplaceChild(grandParent, parent, sibling);
+		Refit(grandParent);
+	}
+
+	void ReplaceChild(uint32_t parent, uint32_t oldChild, uint32_t newChild)
+	{
+		Node& parentNode = m_nodes[parent];
+		if (parentNode.child1 == oldChild)
+		{
+			parentNode.child1 = newChild;
+		}
+		else
+		{
+			assert(parentNode.child2 == oldChild);
+			parentNode.child2 = newChild;
+		}
+	}
+
+	// Walk up from nodeIndex to fix boxes and heights, rotating unbalanced nodes on the way.
+	void Refit(uint32_t nodeIndex)
+	{
+		while (nodeIndex != NullNode)
+		{
+			nodeIndex = Balance(nodeIndex);
+
+			Node& node = m_nodes[nodeIndex];
+			const Node& child1 = m_nodes[node.child1];
+			const Node& child2 = m_nodes[node.child2];
+			node.height = 1 + std::max(child1.height, child2.height);
+			Union(child1, child2, node.min, node.max);
+
+			nodeIndex = node.parent;
+		}
+	}
+
+	// Promote the taller grandchild if the subtree heights of a node differ by more than 1.
+	// Returns the node which now takes the place of a.
+	uint32_t Balance(uint32_t a)
+	{
+		Node& nodeA = m_nodes[a];
+		if (nodeA.IsLeaf() || nodeA.height < 2)
+		{
+			return a;
+		}
+
+		int32_t balance = m_nodes[nodeA.child2].height - m_nodes[nodeA.child1].height;
+		if (balance > 1)
+		{
+			return Rotate(a, nodeA.child2, nodeA.child1, false);
+		}
+		else if (balance < -1)
+		{
+			return Rotate(a, nodeA.child1, nodeA.child2, true);
+		}
+
+		return a;
+	}
+
+	// Rotate up child of a. The shorter grandchild under child moves under a in place of child.
+	uint32_t Rotate(uint32_t a, uint32_t child, uint32_t otherChild, bool isChild1)
+	{
+		Node& nodeA = m_nodes[a];
+		Node& nodeChild = m_nodes[child];
+		uint32_t grandChild1 = nodeChild.child1;
+		uint32_t grandChild2 = nodeChild.child2;
+
+		nodeChild.child1 = a;
+		nodeChild.parent = nodeA.parent;
+		nodeA.parent = child;
+		if (NullNode == nodeChild.parent)
+		{
+			m_root = child;
+		}
+		else
+		{
+			ReplaceChild(nodeChild.parent, a, child);
+		}
+
+		uint32_t tallGrandChild = grandChild1;
+		uint32_t shortGrandChild = grandChild2;
+		if (m_nodes[grandChild1].height <= m_nodes[grandChild2].height)
+		{
+			std::swap(tallGrandChild, shortGrandChild);
+		}
+
+		nodeChild.child2 = tallGrandChild;
+		if (isChild1)
+		{
+			nodeA.child1 = shortGrandChild;
+		}
+		else
+		{
+			nodeA.child2 = shortGrandChild;
+		}
+		m_nodes[shortGrandChild].parent = a;
+
+		const Node& nodeOther = m_nodes[otherChild];
+		const Node& nodeShort = m_nodes[shortGrandChild];
+		const Node& nodeTall = m_nodes[tallGrandChild];
+		Union(nodeOther, nodeShort, nodeA.min, nodeA.max);
+		nodeA.height = 1 + std::max(nodeOther.height, nodeShort.height);
+		Union(nodeA, nodeTall, nodeChild.min, nodeChild.max);
+		nodeChild.height = 1 + std::max(nodeA.height, nodeTall.height);
+
+		return child;
+	}
+
+private:
+	std::vector<Node> m_nodes;
+	uint32_t m_root = NullNode;
+	uint32_t m_freeList = NullNode;
+	size_t m_proxyCount = 0;
+};
+
+}
\ No newline at end of file
@@ -5,8 +5,24 @@
 namespace engine
 {
 
-// Entity is a global unique unsigned integer identifier [0, max - 1] in the engine runtime.
+// Entity is a unique unsigned integer identifier in one World which packs [generation : 8 | index : 24].
+// Index is recycled after the entity is destroyed and generation increases to tell stale handles from alive ones.
 using Entity = uint32_t;
 static constexpr Entity INVALID_ENTITY = static_cast<uint32_t>(-1);
 
+static constexpr uint32_t ENTITY_INDEX_BITS = 24U;
+static constexpr uint32_t ENTITY_INDEX_MASK = (1U << ENTITY_INDEX_BITS) - 1U;
+static constexpr uint32_t ENTITY_GENERATION_BITS = 32U - ENTITY_INDEX_BITS;
+static constexpr uint32_t ENTITY_GENERATION_MASK = (1U << ENTITY_GENERATION_BITS) - 1U;
+
+// The max index is reserved so that INVALID_ENTITY never maps to an alive entity.
+static constexpr uint32_t MAX_ENTITY_INDEX = ENTITY_INDEX_MASK - 1U;
+
+constexpr uint32_t GetEntityIndex(Entity entity) { return entity & ENTITY_INDEX_MASK; }
+constexpr uint32_t GetEntityGeneration(Entity entity) { return entity >> ENTITY_INDEX_BITS; }
+constexpr Entity MakeEntity(uint32_t index, uint32_t generation)
+{
+	return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+}
+
 }
\ No newline at end of file
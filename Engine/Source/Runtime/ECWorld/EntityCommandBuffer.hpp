@@ -0,0 +1,195 @@
+#pragma once
+
+#include "Entity.h"
+#include "World.h"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace engine
+{
+
+// EntityCommandBuffer records World mutations from any thread and applies them later at a sync point.
+// Every thread records into its own command stream so that recording doesn't lock after the first command on a thread.
+// Playback applies streams in the order threads started recording, commands of one thread keep their order.
+// Record all commands of one entity on the same thread if their order matters.
+class EntityCommandBuffer final
+{
+public:
+	EntityCommandBuffer() = delete;
+	explicit EntityCommandBuffer(World* pWorld)
+		: m_pWorld(pWorld)
+		, m_bufferID(s_nextBufferID.fetch_add(1U, std::memory_order_relaxed))
+	{
+		assert(pWorld);
+	}
+	EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+	EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+	EntityCommandBuffer(EntityCommandBuffer&&) = delete;
+	EntityCommandBuffer& operator=(EntityCommandBuffer&&) = delete;
+	~EntityCommandBuffer() = default;
+
+	// Thread safe. Entity id is reserved immediately so that following commands can refer to it.
+	Entity CreateEntity() { return m_pWorld->CreateEntity(); }
+
+	// Thread safe. Creates a default Component for entity at playback.
+	template<typename Component>
+	void AddComponent(Entity entity)
+	{
+		AddComponent<Component>(entity, [](Component&) {});
+	}
+
+	// Thread safe. Creates Component for entity at playback and calls initializer(Component&) on the main thread.
+	// If entity already owns Component, initializer is applied to the existing one.
+	template<typename Component, typename Func>
+	void AddComponent(Entity entity, Func&& initializer)
+	{
+		using Command = AddComponentCommand<Component, std::decay_t<Func>>;
+		GetThreadStream().emplace_back(std::make_unique<Command>(entity, std::forward<Func>(initializer)));
+	}
+
+	// Thread safe.
+	template<typename Component>
+	void RemoveComponent(Entity entity)
+	{
+		GetThreadStream().emplace_back(std::make_unique<RemoveComponentCommand<Component>>(entity));
+	}
+
+	// Thread safe. Destroy callbacks registered to World by systems run at playback.
+	void DestroyEntity(Entity entity)
+	{
+		GetThreadStream().emplace_back(std::make_unique<DestroyEntityCommand>(entity));
+	}
+
+	// Not thread safe. Call it on the main thread when no other thread is recording.
+	void Playback()
+	{
+		for (std::unique_ptr<CommandStream>& pStream : m_streams)
+		{
+			for (std::unique_ptr<ICommand>& pCommand : *pStream)
+			{
+				pCommand->Execute(*m_pWorld);
+			}
+
+			// Keep streams alive as recording threads cache them.
+			pStream->clear();
+		}
+	}
+
+	// Not thread safe. Returns recorded commands count which are waiting for playback.
+	size_t GetCommandCount() const
+	{
+		size_t commandCount = 0;
+		for (const std::unique_ptr<CommandStream>& pStream : m_streams)
+		{
+			commandCount += pStream->size();
+		}
+		return commandCount;
+	}
+
+private:
+	class ICommand
+	{
+	public:
+		virtual ~ICommand() = default;
+
+		virtual void Execute(World& world) = 0;
+	};
+
+	template<typename Component, typename Func>
+	class AddComponentCommand final : public ICommand
+	{
+	public:
+		template<typename InitFunc>
+		AddComponentCommand(Entity entity, InitFunc&& initializer) : m_entity(entity), m_initializer(std::forward<InitFunc>(initializer)) {}
+
+		virtual void Execute(World& world) override
+		{
+			if (!world.IsAlive(m_entity))
+			{
+				return;
+			}
+
+			ComponentsStorage<Component>* pStorage = world.GetComponents<Component>();
+			Component* pComponent = pStorage->GetComponent(m_entity);
+			m_initializer(pComponent ? *pComponent : pStorage->CreateComponent(m_entity));
+		}
+
+	private:
+		Entity m_entity;
+		Func m_initializer;
+	};
+
+	template<typename Component>
+	class RemoveComponentCommand final : public ICommand
+	{
+	public:
+		explicit RemoveComponentCommand(Entity entity) : m_entity(entity) {}
+
+		virtual void Execute(World& world) override
+		{
+			ComponentsStorage<Component>* pStorage = world.GetComponents<Component>();
+			if (pStorage->Contains(m_entity))
+			{
+				pStorage->RemoveComponent(m_entity);
+			}
+		}
+
+	private:
+		Entity m_entity;
+	};
+
+	class DestroyEntityCommand final : public ICommand
+	{
+	public:
+		explicit DestroyEntityCommand(Entity entity) : m_entity(entity) {}
+
+		virtual void Execute(World& world) override { world.DestroyEntity(m_entity); }
+
+	private:
+		Entity m_entity;
+	};
+
+	using CommandStream = std::vector<std::unique_ptr<ICommand>>;
+
+	CommandStream& GetThreadStream()
+	{
+		// Cache the stream of the last used buffer per thread. Buffer ids are never reused so a stale cache can't match.
+		thread_local uint32_t tlsBufferID = InvalidBufferID;
+		thread_local CommandStream* tlsStream = nullptr;
+		if (tlsBufferID != m_bufferID)
+		{
+			std::lock_guard<std::mutex> lock(m_streamMutex);
+			auto itStream = m_threadToStream.find(std::this_thread::get_id());
+			if (itStream == m_threadToStream.end())
+			{
+				m_streams.emplace_back(std::make_unique<CommandStream>());
+				itStream = m_threadToStream.emplace(std::this_thread::get_id(), m_streams.back().get()).first;
+			}
+
+			tlsBufferID = m_bufferID;
+			tlsStream = itStream->second;
+		}
+
+		return *tlsStream;
+	}
+
+private:
+	static constexpr uint32_t InvalidBufferID = UINT32_MAX;
+	static inline std::atomic<uint32_t> s_nextBufferID = 0U;
+
+	World* m_pWorld;
+	uint32_t m_bufferID;
+
+	std::mutex m_streamMutex;
+	std::unordered_map<std::thread::id, CommandStream*> m_threadToStream;
+	std::vector<std::unique_ptr<CommandStream>> m_streams;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(__AVX__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CD_FRUSTUM_CULLER_SSE
+#endif
+
+namespace engine
+{
+
+namespace details
+{
+
+// Center and extent of the world space AABB which bounds a local box transformed by a column major affine matrix.
+inline void TransformAABB(const float* pMin, const float* pMax, const float* pWorldMatrix, float* pCenter, float* pExtent)
+{
+	assert(pMin && pMax && pWorldMatrix);
+	for (size_t row = 0; row < 3; ++row)
+	{
+		pCenter[row] = pWorldMatrix[12 + row];
+		pExtent[row] = 0.0f;
+		for (size_t column = 0; column < 3; ++column)
+		{
+			float localCenter = (pMin[column] + pMax[column]) * 0.5f;
+			float localExtent = (pMax[column] - pMin[column]) * 0.5f;
+			float element = pWorldMatrix[column * 4 + row];
+			pCenter[row] += element * localCenter;
+			pExtent[row] += std::fabs(element) * localExtent;
+		}
+	}
+}
+
+}
+
+// FrustumCuller tests world space AABBs against six planes extracted from a column major view projection matrix.
+// Boxes are stored as centers and extents in separate arrays so that SSE tests 4 boxes against a plane at once.
+// Arrays are kept between frames so that refilling them doesn't allocate.
+class FrustumCuller final
+{
+public:
+	static constexpr size_t LaneWidth = 4;
+	static constexpr size_t PlaneCount = 6;
+
+public:
+	FrustumCuller() = default;
+	FrustumCuller(const FrustumCuller&) = delete;
+	FrustumCuller& operator=(const FrustumCuller&) = delete;
+	FrustumCuller(FrustumCuller&&) = default;
+	FrustumCuller& operator=(FrustumCuller&&) = default;
+	~FrustumCuller() = default;
+
+	// Gribb-Hartmann plane extraction. Planes point inside and are not normalized
+	// because the box test only compares signs of distances to the same plane.
+	void SetViewProjection(const float* pViewProjection, bool isDepthZeroToOne)
+	{
+		auto Row = [pViewProjection](size_t row, size_t column) { return pViewProjection[column * 4 + row]; };
+		for (size_t column = 0; column < 4; ++column)
+		{
+			float row0 = Row(0, column);
+			float row1 = Row(1, column);
+			float row2 = Row(2, column);
+			float row3 = Row(3, column);
+			m_planes[0][column] = row3 + row0;
+			m_planes[1][column] = row3 - row0;
+			m_planes[2][column] = row3 + row1;
+			m_planes[3][column] = row3 - row1;
+			m_planes[4][column] = isDepthZeroToOne ? row2 : row3 + row2;
+			m_planes[5][column] = row3 - row2;
+		}
+	}
+
+	void Clear()
+	{
+		for (std::vector<float>& channel : m_channels)
+		{
+			channel.clear();
+		}
+		m_visibility.clear();
+	}
+
+	size_t GetCount() const { return m_channels[CenterX].size(); }
+
+	// pMin and pMax are 3 floats of a local space box. pWorldMatrix is a column major affine matrix.
+	// The world space box is the AABB of the transformed local box.
+	void Add(const float* pMin, const float* pMax, const float* pWorldMatrix)
+	{
+		float center[3];
+		float extent[3];
+		details::TransformAABB(pMin, pMax, pWorldMatrix, center, extent);
+		m_channels[CenterX].push_back(center[0]);
+		m_channels[CenterY].push_back(center[1]);
+		m_channels[CenterZ].push_back(center[2]);
+		m_channels[ExtentX].push_back(extent[0]);
+		m_channels[ExtentY].push_back(extent[1]);
+		m_channels[ExtentZ].push_back(extent[2]);
+	}
+
+	// Test all added boxes. Results are valid until the next Clear.
+	void Cull()
+	{
+		size_t count = GetCount();
+		m_visibility.resize(count);
+
+		size_t simdCount = 0;
+#if defined(CD_FRUSTUM_CULLER_SSE)
+		simdCount = count - count % LaneWidth;
+		CullSSE(simdCount);
+#endif
+		CullScalar(simdCount, count);
+	}
+
+	bool IsVisible(size_t index) const { return m_visibility[index] != 0U; }
+
+	// Left, right, bottom, top, near, far. Each is (a, b, c, d) of a * x + b * y + c * z + d >= 0 inside.
+	const float* GetPlane(size_t planeIndex) const { return m_planes[planeIndex]; }
+
+private:
+	enum Channel
+	{
+		CenterX, CenterY, CenterZ,
+		ExtentX, ExtentY, ExtentZ,
+		ChannelCount
+	};
+
+	// A box is outside if it is completely behind any plane : dot(n, c) + d + dot(|n|, e) < 0.
+	void CullScalar(size_t beginIndex, size_t endIndex)
+	{
+		for (size_t index = beginIndex; index < endIndex; ++index)
+		{
+			bool isVisible = true;
+			for (size_t planeIndex = 0; planeIndex < PlaneCount && isVisible; ++planeIndex)
+			{
+				const float* pPlane = m_planes[planeIndex];
+				float distance = pPlane[0] * m_channels[CenterX][index] + pPlane[1] * m_channels[CenterY][index] +
+					pPlane[2] * m_channels[CenterZ][index] + pPlane[3];
+				float radius = std::fabs(pPlane[0]) * m_channels[ExtentX][index] + std::fabs(pPlane[1]) * m_channels[ExtentY][index] +
+					std::fabs(pPlane[2]) * m_channels[ExtentZ][index];
+				isVisible = distance + radius >= 0.0f;
+			}
+			m_visibility[index] = isVisible ? 1U : 0U;
+		}
+	}
+
+#if defined(CD_FRUSTUM_CULLER_SSE)
+	void CullSSE(size_t endIndex)
+	{
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		for (size_t index = 0; index < endIndex; index += LaneWidth)
+		{
+			__m128 cx = _mm_loadu_ps(&m_channels[CenterX][index]);
+			__m128 cy = _mm_loadu_ps(&m_channels[CenterY][index]);
+			__m128 cz = _mm_loadu_ps(&m_channels[CenterZ][index]);
+			__m128 ex = _mm_loadu_ps(&m_channels[ExtentX][index]);
+			__m128 ey = _mm_loadu_ps(&m_channels[ExtentY][index]);
+			__m128 ez = _mm_loadu_ps(&m_channels[ExtentZ][index]);
+
+			// Lanes set in outside are boxes completely behind at least one plane.
+			__m128 outside = _mm_setzero_ps();
+			for (const float* pPlane : m_planes)
+			{
+				__m128 nx = _mm_set1_ps(pPlane[0]);
+				__m128 ny = _mm_set1_ps(pPlane[1]);
+				__m128 nz = _mm_set1_ps(pPlane[2]);
+				__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+					_mm_add_ps(_mm_mul_ps(nz, cz), _mm_set1_ps(pPlane[3])));
+				__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, nx), ex), _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey)),
+					_mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+			}
+
+			int outsideMask = _mm_movemask_ps(outside);
+			for (size_t lane = 0; lane < LaneWidth; ++lane)
+			{
+				m_visibility[index + lane] = (outsideMask >> lane) & 1 ? 0U : 1U;
+			}
+		}
+	}
+#endif
+
+private:
+	float m_planes[PlaneCount][4] = {};
+	std::vector<float> m_channels[ChannelCount];
+	std::vector<uint8_t> m_visibility;
+};
+
+}
\ No newline at end of file
@@ -23,11 +23,30 @@ public:
 	HierarchyComponent& operator=(HierarchyComponent&&) = default;
 	~HierarchyComponent() = default;
 
+	// Links are maintained by TransformSystem. Children of one parent are chained by sibling links.
 	void SetParentEntity(Entity entity) { m_parentEntity = entity; }
 	Entity GetParentEntity() const { return m_parentEntity; }
 
+	void SetFirstChildEntity(Entity entity) { m_firstChildEntity = entity; }
+	Entity GetFirstChildEntity() const { return m_firstChildEntity; }
+	bool HasChildren() const { return m_firstChildEntity != INVALID_ENTITY; }
+
+	void SetPrevSiblingEntity(Entity entity) { m_prevSiblingEntity = entity; }
+	Entity GetPrevSiblingEntity() const { return m_prevSiblingEntity; }
+
+	void SetNextSiblingEntity(Entity entity) { m_nextSiblingEntity = entity; }
+	Entity GetNextSiblingEntity() const { return m_nextSiblingEntity; }
+
+	// Root entities are in depth 0.
+	void SetDepth(uint32_t depth) { m_depth = depth; }
+	uint32_t GetDepth() const { return m_depth; }
+
 private:
 	Entity m_parentEntity = INVALID_ENTITY;
+	Entity m_firstChildEntity = INVALID_ENTITY;
+	Entity m_prevSiblingEntity = INVALID_ENTITY;
+	Entity m_nextSiblingEntity = INVALID_ENTITY;
+	uint32_t m_depth = 0U;
 };
 
 }
\ No newline at end of file
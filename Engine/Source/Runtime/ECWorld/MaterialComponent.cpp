@@ -141,16 +141,19 @@ const MaterialComponent::TextureInfo* MaterialComponent::GetTextureInfo(cd::Mate
 void MaterialComponent::ActiveShaderFeature(engine::ShaderFeature feature)
 {
 	m_shaderFeatures.insert(feature);
+	++m_version;
 }
 
 void MaterialComponent::DeactiveShaderFeature(engine::ShaderFeature feature)
 {
 	m_shaderFeatures.erase(feature);
+	++m_version;
 }
 
 void MaterialComponent::MatchUberShaderCrc()
 {
 	m_uberShaderCrc = m_pMaterialType->GetShaderSchema().GetFeaturesCrc(m_shaderFeatures);
+	++m_version;
 }
 
 uint16_t MaterialComponent::GetShadreProgram() const
@@ -158,6 +161,11 @@ uint16_t MaterialComponent::GetShadreProgram() const
 	return m_pMaterialType->GetShaderSchema().GetCompiledProgram(m_uberShaderCrc);
 }
 
+uint16_t MaterialComponent::GetInstanceShaderProgram() const
+{
+	return m_pMaterialType->GetShaderSchema().GetCompiledInstanceProgram(m_uberShaderCrc);
+}
+
 void MaterialComponent::Reset()
 {
 	m_pMaterialData = nullptr;
@@ -174,6 +182,7 @@ void MaterialComponent::Reset()
 	m_alphaCutOff = 1.0f;
 	m_textureResources.clear();
 	m_skyType = SkyType::None;
+	++m_version;
 }
 
 std::string MaterialComponent::GetVertexShaderName() const
@@ -210,6 +219,7 @@ void MaterialComponent::AddTextureBlob(cd::MaterialTextureType textureType, cd::
 	
 	// TODO : generic CPU/GPU resource manager.
 	m_cacheTextureBlobs.emplace_back(cd::MoveTemp(textureBlob));
+	++m_version;
 }
 
 void MaterialComponent::AddTextureFileBlob(cd::MaterialTextureType textureType, const cd::Material* pMaterial, const cd::Texture& texture, TextureBlob textureBlob)
@@ -239,6 +249,7 @@ void MaterialComponent::AddTextureFileBlob(cd::MaterialTextureType textureType,
 		textureInfo.uvOffset = optUVOffset.value();
 	}
 	m_textureResources[textureType] = cd::MoveTemp(textureInfo);
+	++m_version;
 }
 
 void MaterialComponent::Build()
@@ -260,6 +271,8 @@ void MaterialComponent::Build()
 		assert(textureInfo.textureHandle != bgfx::kInvalidHandle);
 		assert(textureInfo.samplerHandle != bgfx::kInvalidHandle);
 	}
+
+	++m_version;
 }
 
 void MaterialComponent::SetSkyType(SkyType crtType)
@@ -283,6 +296,7 @@ void MaterialComponent::SetSkyType(SkyType crtType)
 
 	m_uberShaderCrc = m_pMaterialType->GetShaderSchema().GetFeaturesCrc(m_shaderFeatures);
 	m_skyType = crtType;
+	++m_version;
 }
 
 }
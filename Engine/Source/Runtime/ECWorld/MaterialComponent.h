@@ -97,6 +97,8 @@ public:
 	void DeactiveShaderFeature(ShaderFeature feature);
 	void MatchUberShaderCrc();
 	uint16_t GetShadreProgram() const;
+	// Program variant which reads world matrices from instance data. It can be invalid.
+	uint16_t GetInstanceShaderProgram() const;
 
 	void SetShaderFeatures(std::set<ShaderFeature> options) { m_shaderFeatures = cd::MoveTemp(m_shaderFeatures); }
 	std::set<ShaderFeature>& GetShaderFeatures() { return m_shaderFeatures; }
@@ -148,6 +150,10 @@ public:
 	const SkyType GetSkyType() const { return m_skyType; }
 	SkyType GetSkyType() { return m_skyType; }
 
+	// Increased when textures, shader features or the program change. Renderers compare it to know when resolved handles are stale.
+	// Parameters edited through references, like colors and uv transforms, don't change it.
+	uint32_t GetVersion() const { return m_version; }
+
 private:
 	// Input
 	const cd::Material* m_pMaterialData = nullptr;
@@ -169,6 +175,7 @@ private:
 
 	// Output
 	std::map<cd::MaterialTextureType, TextureInfo> m_textureResources;
+	uint32_t m_version = 0U;
 };
 
 }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace engine
+{
+
+// PagedSparseArray maps a sparse integer key range to values by splitting it into fixed size pages.
+// Pages are allocated on first write so memory is proportional to the touched key ranges, not the max key.
+// A lookup is two array loads : page table -> page -> value.
+template<typename T, T InvalidValue, uint32_t PageSize = 4096U>
+class PagedSparseArray final
+{
+public:
+	static_assert(PageSize > 0U && 0U == (PageSize & (PageSize - 1U)), "PageSize should be power of two.");
+
+	using Page = std::array<T, PageSize>;
+
+public:
+	PagedSparseArray() = default;
+	PagedSparseArray(const PagedSparseArray&) = delete;
+	PagedSparseArray& operator=(const PagedSparseArray&) = delete;
+	PagedSparseArray(PagedSparseArray&&) = default;
+	PagedSparseArray& operator=(PagedSparseArray&&) = default;
+	~PagedSparseArray() = default;
+
+	// Returns InvalidValue if key was never assigned.
+	T Get(uint32_t key) const
+	{
+		uint32_t pageIndex = key / PageSize;
+		if (pageIndex >= m_pages.size() || !m_pages[pageIndex])
+		{
+			return InvalidValue;
+		}
+
+		return (*m_pages[pageIndex])[key & (PageSize - 1U)];
+	}
+
+	void Set(uint32_t key, T value)
+	{
+		uint32_t pageIndex = key / PageSize;
+		if (pageIndex >= m_pages.size())
+		{
+			m_pages.resize(pageIndex + 1U);
+		}
+
+		std::unique_ptr<Page>& pPage = m_pages[pageIndex];
+		if (!pPage)
+		{
+			pPage = std::make_unique<Page>();
+			pPage->fill(InvalidValue);
+		}
+
+		(*pPage)[key & (PageSize - 1U)] = value;
+	}
+
+	void Reset(uint32_t key)
+	{
+		uint32_t pageIndex = key / PageSize;
+		if (pageIndex < m_pages.size() && m_pages[pageIndex])
+		{
+			(*m_pages[pageIndex])[key & (PageSize - 1U)] = InvalidValue;
+		}
+	}
+
+	void Clear() { m_pages.clear(); }
+
+	size_t GetPageCount() const { return m_pages.size(); }
+
+private:
+	std::vector<std::unique_ptr<Page>> m_pages;
+};
+
+}
\ No newline at end of file
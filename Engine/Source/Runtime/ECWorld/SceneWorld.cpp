@@ -20,6 +20,7 @@ SceneWorld::SceneWorld()
 	m_pSceneDatabase = std::make_unique<cd::SceneDatabase>();
 
 	m_pWorld = std::make_unique<engine::World>();
+	m_pCommandBuffer = std::make_unique<engine::EntityCommandBuffer>(m_pWorld.get());
 
 	// To add a new component : 2. Init component type here.
 	m_pAnimationComponentStorage = m_pWorld->Register<engine::AnimationComponent>();
@@ -40,6 +41,14 @@ SceneWorld::SceneWorld()
 	m_pParticleEmitterComponentStorage = m_pWorld->Register<engine::ParticleEmitterComponent>();
 	m_pTerrainComponentStorage = m_pWorld->Register<engine::TerrainComponent>();
 	m_pTransformComponentStorage = m_pWorld->Register<engine::TransformComponent>();
+
+	// Renderers upload terrain elevation only when it changes.
+	m_pTerrainComponentStorage->EnableChangeTracking();
+
+	m_pTransformSystem = std::make_unique<engine::TransformSystem>(m_pWorld.get());
+	m_pSpatialSystem = std::make_unique<engine::SpatialSystem>(m_pWorld.get());
+	m_pCullingSystem = std::make_unique<engine::CullingSystem>(m_pWorld.get(), m_pSpatialSystem.get());
+	m_pAnimationSystem = std::make_unique<engine::AnimationSystem>(m_pWorld.get(), m_pCullingSystem.get());
 	
 #ifdef ENABLE_DDGI
 	CreateDDGIMaterialType();
@@ -52,6 +61,7 @@ void SceneWorld::CreatePBRMaterialType(bool isAtmosphericScatteringEnable)
 	m_pPBRMaterialType->SetMaterialName("CD_PBR");
 
 	ShaderSchema shaderSchema(Path::GetBuiltinShaderInputPath("shaders/vs_PBR"), Path::GetBuiltinShaderInputPath("shaders/fs_PBR"));
+	shaderSchema.SetInstanceVertexShaderPath(Path::GetBuiltinShaderInputPath("shaders/vs_PBR_instance"));
 	shaderSchema.AddFeatureSet({ ShaderFeature::ALBEDO_MAP });
 	shaderSchema.AddFeatureSet({ ShaderFeature::NORMAL_MAP });
 	shaderSchema.AddFeatureSet({ ShaderFeature::ORM_MAP });
@@ -278,6 +288,15 @@ void SceneWorld::InitDDGISDK()
 
 void SceneWorld::Update()
 {
+	// Sync point for commands recorded by worker threads in the last frame.
+	m_pCommandBuffer->Playback();
+	m_pTransformSystem->BuildAll();
+	m_pTransformSystem->Update();
+	m_pSpatialSystem->Update();
+
+	// Systems above have consumed changes recorded since the last Update.
+	m_pWorld->ClearChangedComponents();
+
 #ifdef ENABLE_DDGI
 	// Send request 30 times per second.
 	static auto startTime = std::chrono::steady_clock::now();
@@ -309,4 +328,21 @@ void SceneWorld::Update()
 #endif
 }
 
+void SceneWorld::UpdateVisibility()
+{
+	const CameraComponent* pCameraComponent = GetCameraComponent(GetMainCameraEntity());
+	if (!pCameraComponent)
+	{
+		return;
+	}
+
+	m_pCullingSystem->Update(pCameraComponent->GetProjectionMatrix() * pCameraComponent->GetViewMatrix(),
+		cd::NDCDepth::MinusOneToOne != pCameraComponent->GetNDCDepth());
+}
+
+void SceneWorld::UpdateAnimation(float deltaTime)
+{
+	m_pAnimationSystem->Update(deltaTime);
+}
+
 }
\ No newline at end of file
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "ECWorld/AllComponentsHeader.h"
+#include "ECWorld/AnimationSystem.hpp"
+#include "ECWorld/CullingSystem.hpp"
+#include "ECWorld/EntityCommandBuffer.hpp"
+#include "ECWorld/SpatialSystem.hpp"
+#include "ECWorld/TransformSystem.hpp"
 #include "ECWorld/World.h"
 #include "Log/Log.h"
 #include "Material/MaterialType.h"
@@ -22,6 +27,7 @@ private: \
 public: \
 	CD_FORCEINLINE const std::vector<engine::Entity>& Get##ComponentType##Entities() const { return m_p##ComponentType##ComponentStorage->GetEntities(); } \
 	CD_FORCEINLINE ComponentType##Component* Get##ComponentType##Component(engine::Entity entity) const { return m_p##ComponentType##ComponentStorage->GetComponent(entity); } \
+	CD_FORCEINLINE ComponentType##Component* Modify##ComponentType##Component(engine::Entity entity) { return m_p##ComponentType##ComponentStorage->ModifyComponent(entity); } \
 	CD_FORCEINLINE void Delete##ComponentType##Component(engine::Entity entity) { m_p##ComponentType##ComponentStorage->RemoveComponent(entity); }
 
 class SceneWorld
@@ -58,6 +64,22 @@ public:
 	CD_FORCEINLINE engine::World* GetWorld() { return m_pWorld.get(); }
 	CD_FORCEINLINE const engine::World* GetWorld() const { return m_pWorld.get(); }
 
+	// Record World mutations from worker threads. They are applied at the beginning of Update.
+	CD_FORCEINLINE engine::EntityCommandBuffer* GetCommandBuffer() { return m_pCommandBuffer.get(); }
+
+	// Parent-child links and world matrix propagation. Dirty subtrees are rebuilt in Update.
+	CD_FORCEINLINE engine::TransformSystem* GetTransformSystem() { return m_pTransformSystem.get(); }
+	CD_FORCEINLINE const engine::TransformSystem* GetTransformSystem() const { return m_pTransformSystem.get(); }
+
+	// Bounding volume tree over CollisionMeshComponent bounds for picking and culling queries. It is synced in Update.
+	CD_FORCEINLINE const engine::SpatialSystem* GetSpatialSystem() const { return m_pSpatialSystem.get(); }
+
+	// Visibility of entities against the main camera frustum. It is refreshed by UpdateVisibility.
+	CD_FORCEINLINE const engine::CullingSystem* GetCullingSystem() const { return m_pCullingSystem.get(); }
+
+	// Playback and bone matrices of AnimationComponents. They are refreshed by UpdateAnimation.
+	CD_FORCEINLINE const engine::AnimationSystem* GetAnimationSystem() const { return m_pAnimationSystem.get(); }
+
 	void SetSelectedEntity(engine::Entity entity);
 	CD_FORCEINLINE engine::Entity GetSelectedEntity() const { return m_selectedEntity; }
 
@@ -88,25 +110,9 @@ public:
 			m_selectedEntity = engine::INVALID_ENTITY;
 		}
 
-		// To add a new component : 3. Delete component here when removing an entity.
-		DeleteAnimationComponent(entity);
-		DeleteBlendShapeComponent(entity);
-		DeleteCameraComponent(entity);
-		DeleteCollisionMeshComponent(entity);
-#ifdef ENABLE_DDGI
-		DeleteDDGIComponent(entity);
-#endif
-		DeleteHierarchyComponent(entity);
-		DeleteLightComponent(entity);
-		DeleteMaterialComponent(entity);
-		DeleteNameComponent(entity);
-		DeleteShaderVariantCollectionsComponent(entity);
-		DeleteSkyComponent(entity);
-		DeleteStaticMeshComponent(entity);
-		DeleteParticleComponent(entity);
-		DeleteParticleEmitterComponent(entity);
-		DeleteTerrainComponent(entity);
-		DeleteTransformComponent(entity);
+		// Systems unlink entity in their destroy callbacks. Components are removed by the entity's signature
+		// so only owned storages are visited.
+		m_pWorld->DestroyEntity(entity);
 	}
 
 	void CreatePBRMaterialType(bool isAtmosphericScatteringEnable = false);
@@ -133,9 +139,20 @@ public:
 
 	void Update();
 
+	// Call it after the main camera is updated and before renderers.
+	void UpdateVisibility();
+
+	// Call it after UpdateVisibility. Bone matrices are evaluated only for visible entities.
+	void UpdateAnimation(float deltaTime);
+
 private:
 	std::unique_ptr<cd::SceneDatabase> m_pSceneDatabase;
 	std::unique_ptr<engine::World> m_pWorld;
+	std::unique_ptr<engine::EntityCommandBuffer> m_pCommandBuffer;
+	std::unique_ptr<engine::TransformSystem> m_pTransformSystem;
+	std::unique_ptr<engine::SpatialSystem> m_pSpatialSystem;
+	std::unique_ptr<engine::CullingSystem> m_pCullingSystem;
+	std::unique_ptr<engine::AnimationSystem> m_pAnimationSystem;
 
 	std::unique_ptr<engine::MaterialType> m_pPBRMaterialType;
 	std::unique_ptr<engine::MaterialType> m_pAnimationMaterialType;
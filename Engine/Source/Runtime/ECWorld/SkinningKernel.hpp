@@ -0,0 +1,308 @@
+#pragma once
+
+#include "Base/Template.h"
+#include "ECWorld/FrustumCuller.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CD_SKINNING_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CD_SKINNING_SSE
+#endif
+
+namespace engine
+{
+
+// SkinningKernel keeps bind pose positions, normals and bone influences of a skin mesh and skins them on the CPU
+// for consumers which can't read the vertex shader result, e.g. picking or tests without a renderer.
+// A vertex blends its column major 4x4 palette matrices, two columns per register with AVX and one with SSE,
+// then transforms its position and normal by the blended matrix. Vertices are skinned in ranges which write
+// disjoint outputs, so ranges of many meshes can run in parallel.
+//
+// Bounds don't need skinned vertices. Every bone keeps the bind pose AABB of vertices it influences, and a skinned vertex
+// is a weighted average of its bind position transformed by its bones, so it is inside the union of the bones' transformed AABBs.
+class SkinningKernel final
+{
+public:
+	static constexpr uint32_t InfluenceCount = 4U;
+	static constexpr uint32_t VertexRangeSize = 4096U;
+
+public:
+	SkinningKernel() = default;
+	SkinningKernel(const SkinningKernel&) = default;
+	SkinningKernel& operator=(const SkinningKernel&) = default;
+	SkinningKernel(SkinningKernel&&) = default;
+	SkinningKernel& operator=(SkinningKernel&&) = default;
+	~SkinningKernel() = default;
+
+	// Positions and normals are 3 floats per vertex, normals can be empty. Bone indices and weights are InfluenceCount per vertex.
+	// Weights of a vertex are expected to be positive and sum to 1, influences with weight 0 are unused.
+	void Build(std::vector<float> positions, std::vector<float> normals, std::vector<uint16_t> boneIndices, std::vector<float> boneWeights)
+	{
+		assert(0U == positions.size() % 3U);
+		assert(normals.empty() || normals.size() == positions.size());
+		assert(boneIndices.size() == positions.size() / 3U * InfluenceCount && boneWeights.size() == boneIndices.size());
+
+		m_positions = cd::MoveTemp(positions);
+		m_normals = cd::MoveTemp(normals);
+		m_boneIndices = cd::MoveTemp(boneIndices);
+		m_boneWeights = cd::MoveTemp(boneWeights);
+		m_skinnedPositions = m_positions;
+		m_skinnedNormals = m_normals;
+
+		m_boneBounds.clear();
+		uint32_t vertexCount = GetVertexCount();
+		for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			const float* pPosition = &m_positions[vertexIndex * 3U];
+			for (uint32_t influence = 0U; influence < InfluenceCount; ++influence)
+			{
+				// Unused influences still blend a matrix, point them to the first one with weight 0.
+				uint16_t& boneIndex = m_boneIndices[vertexIndex * InfluenceCount + influence];
+				float& boneWeight = m_boneWeights[vertexIndex * InfluenceCount + influence];
+				if (!(boneWeight > 0.0f))
+				{
+					boneIndex = 0U;
+					boneWeight = 0.0f;
+					continue;
+				}
+
+				if (boneIndex >= m_boneBounds.size())
+				{
+					m_boneBounds.resize(boneIndex + 1U);
+				}
+
+				BoneBounds& bounds = m_boneBounds[boneIndex];
+				for (uint32_t axis = 0U; axis < 3U; ++axis)
+				{
+					bounds.min[axis] = std::min(bounds.min[axis], pPosition[axis]);
+					bounds.max[axis] = std::max(bounds.max[axis], pPosition[axis]);
+				}
+			}
+		}
+
+		m_rangeIndices.resize(GetVertexRangeCount());
+		std::iota(m_rangeIndices.begin(), m_rangeIndices.end(), 0U);
+	}
+
+	bool IsValid() const { return !m_boneBounds.empty(); }
+	bool HasNormals() const { return !m_normals.empty(); }
+	uint32_t GetVertexCount() const { return static_cast<uint32_t>(m_positions.size() / 3U); }
+	uint32_t GetVertexRangeCount() const { return (GetVertexCount() + VertexRangeSize - 1U) / VertexRangeSize; }
+
+	// The largest used bone index + 1. Palettes need to hold at least this number of matrices.
+	uint32_t GetPaletteSize() const { return static_cast<uint32_t>(m_boneBounds.size()); }
+
+	// pPalette points to GetPaletteSize() column major 4x4 matrices, e.g. AnimationComponent::GetBoneMatrices.
+	void SkinRange(const float* pPalette, uint32_t rangeIndex)
+	{
+		uint32_t beginVertex = rangeIndex * VertexRangeSize;
+		uint32_t endVertex = std::min(beginVertex + VertexRangeSize, GetVertexCount());
+#if defined(CD_SKINNING_AVX) || defined(CD_SKINNING_SSE)
+		SkinSIMD(pPalette, beginVertex, endVertex);
+#else
+		SkinScalar(pPalette, beginVertex, endVertex);
+#endif
+	}
+
+	void Skin(const float* pPalette)
+	{
+		std::for_each(std::execution::par, m_rangeIndices.begin(), m_rangeIndices.end(), [this, pPalette](uint32_t rangeIndex)
+		{
+			SkinRange(pPalette, rangeIndex);
+		});
+	}
+
+	// Normals are transformed by the blended matrix and normalized, which is exact for rotations and uniform scales.
+	const std::vector<float>& GetSkinnedPositions() const { return m_skinnedPositions; }
+	const std::vector<float>& GetSkinnedNormals() const { return m_skinnedNormals; }
+
+	// pMin and pMax receive 3 floats of an AABB which contains the mesh skinned by pPalette. Returns false if it is empty.
+	bool ComputeBounds(const float* pPalette, float* pMin, float* pMax) const
+	{
+		bool isEmpty = true;
+		for (uint32_t boneIndex = 0U; boneIndex < m_boneBounds.size(); ++boneIndex)
+		{
+			const BoneBounds& bounds = m_boneBounds[boneIndex];
+			if (bounds.IsEmpty())
+			{
+				continue;
+			}
+
+			float center[3];
+			float extent[3];
+			details::TransformAABB(bounds.min, bounds.max, pPalette + boneIndex * 16U, center, extent);
+			for (uint32_t axis = 0U; axis < 3U; ++axis)
+			{
+				pMin[axis] = isEmpty ? center[axis] - extent[axis] : std::min(pMin[axis], center[axis] - extent[axis]);
+				pMax[axis] = isEmpty ? center[axis] + extent[axis] : std::max(pMax[axis], center[axis] + extent[axis]);
+			}
+			isEmpty = false;
+		}
+
+		return !isEmpty;
+	}
+
+private:
+	struct BoneBounds
+	{
+		bool IsEmpty() const { return min[0] > max[0]; }
+
+		float min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	};
+
+	void SkinScalar(const float* pPalette, uint32_t beginVertex, uint32_t endVertex)
+	{
+		const bool hasNormals = HasNormals();
+		for (uint32_t vertexIndex = beginVertex; vertexIndex < endVertex; ++vertexIndex)
+		{
+			// Rows 0 to 2 of the blended matrix, row r and column c at [c * 3 + r].
+			float matrix[12] = {};
+			for (uint32_t influence = 0U; influence < InfluenceCount; ++influence)
+			{
+				const float* pBone = pPalette + m_boneIndices[vertexIndex * InfluenceCount + influence] * 16U;
+				float weight = m_boneWeights[vertexIndex * InfluenceCount + influence];
+				for (uint32_t column = 0U; column < 4U; ++column)
+				{
+					matrix[column * 3U + 0U] += weight * pBone[column * 4U + 0U];
+					matrix[column * 3U + 1U] += weight * pBone[column * 4U + 1U];
+					matrix[column * 3U + 2U] += weight * pBone[column * 4U + 2U];
+				}
+			}
+
+			const float* pPosition = &m_positions[vertexIndex * 3U];
+			float* pSkinnedPosition = &m_skinnedPositions[vertexIndex * 3U];
+			for (uint32_t row = 0U; row < 3U; ++row)
+			{
+				pSkinnedPosition[row] = matrix[row] * pPosition[0] + matrix[3U + row] * pPosition[1] + matrix[6U + row] * pPosition[2] + matrix[9U + row];
+			}
+
+			if (hasNormals)
+			{
+				const float* pNormal = &m_normals[vertexIndex * 3U];
+				float* pSkinnedNormal = &m_skinnedNormals[vertexIndex * 3U];
+				for (uint32_t row = 0U; row < 3U; ++row)
+				{
+					pSkinnedNormal[row] = matrix[row] * pNormal[0] + matrix[3U + row] * pNormal[1] + matrix[6U + row] * pNormal[2];
+				}
+
+				float length = std::sqrt(pSkinnedNormal[0] * pSkinnedNormal[0] + pSkinnedNormal[1] * pSkinnedNormal[1] + pSkinnedNormal[2] * pSkinnedNormal[2]);
+				if (length > 0.0f)
+				{
+					pSkinnedNormal[0] /= length;
+					pSkinnedNormal[1] /= length;
+					pSkinnedNormal[2] /= length;
+				}
+			}
+		}
+	}
+
+#if defined(CD_SKINNING_AVX) || defined(CD_SKINNING_SSE)
+	void SkinSIMD(const float* pPalette, uint32_t beginVertex, uint32_t endVertex)
+	{
+		const bool hasNormals = HasNormals();
+		for (uint32_t vertexIndex = beginVertex; vertexIndex < endVertex; ++vertexIndex)
+		{
+			const uint16_t* pBoneIndices = &m_boneIndices[vertexIndex * InfluenceCount];
+			const float* pBoneWeights = &m_boneWeights[vertexIndex * InfluenceCount];
+			const float* pPosition = &m_positions[vertexIndex * 3U];
+			const float* pNormal = hasNormals ? &m_normals[vertexIndex * 3U] : nullptr;
+
+			__m128 position;
+			__m128 normal = _mm_setzero_ps();
+#if defined(CD_SKINNING_AVX)
+			// Columns 0 and 1, columns 2 and 3 of the blended matrix.
+			__m256 column01 = _mm256_setzero_ps();
+			__m256 column23 = _mm256_setzero_ps();
+			for (uint32_t influence = 0U; influence < InfluenceCount; ++influence)
+			{
+				const float* pBone = pPalette + pBoneIndices[influence] * 16U;
+				__m256 weight = _mm256_set1_ps(pBoneWeights[influence]);
+				column01 = _mm256_add_ps(column01, _mm256_mul_ps(weight, _mm256_loadu_ps(pBone)));
+				column23 = _mm256_add_ps(column23, _mm256_mul_ps(weight, _mm256_loadu_ps(pBone + 8)));
+			}
+
+			position = Fold(_mm256_add_ps(_mm256_mul_ps(column01, Splat(pPosition[0], pPosition[1])),
+				_mm256_mul_ps(column23, Splat(pPosition[2], 1.0f))));
+			if (hasNormals)
+			{
+				normal = Fold(_mm256_add_ps(_mm256_mul_ps(column01, Splat(pNormal[0], pNormal[1])),
+					_mm256_mul_ps(column23, Splat(pNormal[2], 0.0f))));
+			}
+#else
+			__m128 columns[4] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+			for (uint32_t influence = 0U; influence < InfluenceCount; ++influence)
+			{
+				const float* pBone = pPalette + pBoneIndices[influence] * 16U;
+				__m128 weight = _mm_set1_ps(pBoneWeights[influence]);
+				for (uint32_t column = 0U; column < 4U; ++column)
+				{
+					columns[column] = _mm_add_ps(columns[column], _mm_mul_ps(weight, _mm_loadu_ps(pBone + column * 4U)));
+				}
+			}
+
+			position = _mm_add_ps(_mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(pPosition[0])), _mm_mul_ps(columns[1], _mm_set1_ps(pPosition[1]))),
+				_mm_add_ps(_mm_mul_ps(columns[2], _mm_set1_ps(pPosition[2])), columns[3]));
+			if (hasNormals)
+			{
+				normal = _mm_add_ps(_mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(pNormal[0])), _mm_mul_ps(columns[1], _mm_set1_ps(pNormal[1]))),
+					_mm_mul_ps(columns[2], _mm_set1_ps(pNormal[2])));
+			}
+#endif
+
+			Store3(&m_skinnedPositions[vertexIndex * 3U], position);
+			if (hasNormals)
+			{
+				Store3(&m_skinnedNormals[vertexIndex * 3U], Normalize3(normal));
+			}
+		}
+	}
+
+#if defined(CD_SKINNING_AVX)
+	// (low, low, low, low, high, high, high, high) multiplies two columns at once.
+	static __m256 Splat(float low, float high) { return _mm256_setr_ps(low, low, low, low, high, high, high, high); }
+	static __m128 Fold(__m256 value) { return _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1)); }
+#endif
+
+	// Writes xyz without touching the float after them, which belongs to the next vertex.
+	static void Store3(float* pData, __m128 value)
+	{
+		_mm_storel_pi(reinterpret_cast<__m64*>(pData), value);
+		_mm_store_ss(pData + 2, _mm_movehl_ps(value, value));
+	}
+
+	static __m128 Normalize3(__m128 value)
+	{
+		__m128 squared = _mm_mul_ps(value, value);
+		__m128 lengthSquared = _mm_add_ss(_mm_add_ss(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(1, 1, 1, 1))),
+			_mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 2, 2, 2)));
+		__m128 length = _mm_sqrt_ss(_mm_max_ss(lengthSquared, _mm_set_ss(FLT_MIN)));
+		return _mm_div_ps(value, _mm_shuffle_ps(length, length, _MM_SHUFFLE(0, 0, 0, 0)));
+	}
+#endif
+
+private:
+	std::vector<float> m_positions;
+	std::vector<float> m_normals;
+	std::vector<uint16_t> m_boneIndices;
+	std::vector<float> m_boneWeights;
+	std::vector<float> m_skinnedPositions;
+	std::vector<float> m_skinnedNormals;
+
+	// Indexed by bone index, bones which influence no vertex are empty.
+	std::vector<BoneBounds> m_boneBounds;
+	std::vector<uint32_t> m_rangeIndices;
+};
+
+}
\ No newline at end of file
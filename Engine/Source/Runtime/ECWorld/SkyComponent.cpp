@@ -20,7 +20,9 @@ void SkyComponent::SetSkyType(SkyType crtType)
 	else if(preRadPath != m_radianceTexturePath)
 	{
 		m_radianceTexturePath = preRadPath;
-	} 
+	}
+
+	++m_version;
 }
 
 void SkyComponent::SetSunDirection(cd::Direction dir)
@@ -31,11 +33,13 @@ void SkyComponent::SetSunDirection(cd::Direction dir)
 void SkyComponent::SetIrradianceTexturePath(std::string path)
 {
 	m_irradianceTexturePath = cd::MoveTemp(path);
+	++m_version;
 }
 
 void SkyComponent::SetRadianceTexturePath(std::string path)
 {
 	m_radianceTexturePath = cd::MoveTemp(path);
+	++m_version;
 }
 
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Core/StringCrc.h"
 #include "Math/Vector.hpp"
 
+#include <cstdint>
 #include <string>
 
 namespace engine
@@ -47,15 +48,15 @@ public:
 	bool& GetAtmophericScatteringEnable() { return m_isAtmophericScatteringEnable; }
 	const bool& GetAtmophericScatteringEnable() const { return m_isAtmophericScatteringEnable; }
 
-	void SetATMTransmittanceCrc(StringCrc crc) { m_ATMTransmittanceCrc = crc; }
+	void SetATMTransmittanceCrc(StringCrc crc) { m_ATMTransmittanceCrc = crc; ++m_version; }
 	StringCrc& GetATMTransmittanceCrc() { return m_ATMTransmittanceCrc; }
 	const StringCrc& GetATMTransmittanceCrc() const { return m_ATMTransmittanceCrc; }
 
-	void SetATMIrradianceCrc(StringCrc crc) { m_ATMIrradianceCrc = crc; }
+	void SetATMIrradianceCrc(StringCrc crc) { m_ATMIrradianceCrc = crc; ++m_version; }
 	StringCrc& GetATMIrradianceCrc() { return m_ATMIrradianceCrc; }
 	const StringCrc& GetATMIrradianceCrc() const { return m_ATMIrradianceCrc; }
 
-	void SetATMScatteringCrc(StringCrc crc) { m_ATMScatteringCrc = crc; }
+	void SetATMScatteringCrc(StringCrc crc) { m_ATMScatteringCrc = crc; ++m_version; }
 	StringCrc& GetATMScatteringCrc() { return m_ATMScatteringCrc; }
 	const StringCrc& GetATMScatteringCrc() const { return m_ATMScatteringCrc; }
 
@@ -79,6 +80,9 @@ public:
 	std::string& GetRadianceTexturePath() { return m_radianceTexturePath; }
 	const std::string& GetRadianceTexturePath() const { return m_radianceTexturePath; }
 
+	// Increased when sky type or sky textures change. Renderers compare it to know when resolved texture handles are stale.
+	uint32_t GetVersion() const { return m_version; }
+
 private:
 	SkyType m_type = SkyType::SkyBox;
 	bool m_isAtmophericScatteringEnable = false;
@@ -94,6 +98,8 @@ private:
 
 	std::string m_irradianceTexturePath = DefaultIrradainceTexturePath;
 	std::string m_radianceTexturePath = DefaultRadianceTexturePath;
+
+	uint32_t m_version = 0U;
 };
 
 }
\ No newline at end of file
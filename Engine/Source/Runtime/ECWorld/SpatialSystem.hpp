@@ -0,0 +1,119 @@
+#pragma once
+
+#include "ECWorld/CollisionMeshComponent.h"
+#include "ECWorld/DynamicAABBTree.hpp"
+#include "ECWorld/PagedSparseArray.hpp"
+#include "ECWorld/TransformComponent.h"
+#include "ECWorld/World.h"
+
+#include <cassert>
+
+namespace engine
+{
+
+// SpatialSystem keeps a DynamicAABBTree over world space bounds of entities which own a CollisionMeshComponent and a TransformComponent.
+// Update only visits components marked changed since the last ClearChangedComponents so a static scene costs nothing per frame.
+class SpatialSystem final
+{
+public:
+	SpatialSystem() = delete;
+	explicit SpatialSystem(World* pWorld)
+		: m_pWorld(pWorld)
+		, m_pCollisionMeshStorage(pWorld->GetComponents<CollisionMeshComponent>())
+		, m_pTransformStorage(pWorld->GetComponents<TransformComponent>())
+	{
+		m_pCollisionMeshStorage->EnableChangeTracking();
+		m_pTransformStorage->EnableChangeTracking();
+		m_destroyCallbackID = pWorld->AddDestroyCallback([this](Entity entity) { Remove(entity); });
+	}
+	SpatialSystem(const SpatialSystem&) = delete;
+	SpatialSystem& operator=(const SpatialSystem&) = delete;
+	SpatialSystem(SpatialSystem&&) = delete;
+	SpatialSystem& operator=(SpatialSystem&&) = delete;
+	~SpatialSystem() { m_pWorld->RemoveDestroyCallback(m_destroyCallbackID); }
+
+	// Not thread safe. Call it after world matrices are built and before changed marks are cleared.
+	void Update()
+	{
+		m_pCollisionMeshStorage->ForEachChanged([this](Entity entity, CollisionMeshComponent&) { UpdateProxy(entity); });
+		m_pTransformStorage->ForEachChanged([this](Entity entity, TransformComponent&) { UpdateProxy(entity); });
+	}
+
+	// World::DestroyEntity calls it. Call it when removing CollisionMeshComponent from an alive entity.
+	void Remove(Entity entity)
+	{
+		uint32_t proxy = m_entityToProxy.Get(GetEntityIndex(entity));
+		if (proxy != DynamicAABBTree::NullNode && m_tree.GetEntity(proxy) == entity)
+		{
+			m_tree.DestroyProxy(proxy);
+			m_entityToProxy.Reset(GetEntityIndex(entity));
+		}
+	}
+
+	bool Contains(Entity entity) const
+	{
+		uint32_t proxy = m_entityToProxy.Get(GetEntityIndex(entity));
+		return proxy != DynamicAABBTree::NullNode && m_tree.GetEntity(proxy) == entity;
+	}
+
+	size_t GetEntityCount() const { return m_tree.GetProxyCount(); }
+	const DynamicAABBTree& GetTree() const { return m_tree; }
+
+	// Queries report entities whose fat bounds pass, callers refine with exact bounds if needed.
+	template<typename Func>
+	void QueryBox(const cd::AABB& box, Func&& func) const { m_tree.QueryBox(box.Min().Begin(), box.Max().Begin(), func); }
+
+	template<typename Func>
+	void QueryFrustum(const FrustumCuller& frustum, Func&& func) const { m_tree.QueryFrustum(frustum, func); }
+
+	// func(Entity, float maxDistance) -> float, see DynamicAABBTree::QueryRay.
+	template<typename Func>
+	void QueryRay(const cd::Vec3f& origin, const cd::Vec3f& direction, float maxDistance, Func&& func) const
+	{
+		m_tree.QueryRay(origin.Begin(), direction.Begin(), maxDistance, func);
+	}
+
+private:
+	void UpdateProxy(Entity entity)
+	{
+		const CollisionMeshComponent* pCollisionMesh = m_pCollisionMeshStorage->GetComponent(entity);
+		const TransformComponent* pTransform = m_pTransformStorage->GetComponent(entity);
+		if (!pCollisionMesh || !pTransform || pCollisionMesh->GetAABB().IsEmpty())
+		{
+			Remove(entity);
+			return;
+		}
+
+		float center[3];
+		float extent[3];
+		const cd::AABB& aabb = pCollisionMesh->GetAABB();
+		details::TransformAABB(aabb.Min().Begin(), aabb.Max().Begin(), pTransform->GetWorldMatrix().Begin(), center, extent);
+		float worldMin[3] = { center[0] - extent[0], center[1] - extent[1], center[2] - extent[2] };
+		float worldMax[3] = { center[0] + extent[0], center[1] + extent[1], center[2] + extent[2] };
+
+		uint32_t entityIndex = GetEntityIndex(entity);
+		uint32_t proxy = m_entityToProxy.Get(entityIndex);
+		assert((DynamicAABBTree::NullNode == proxy || m_tree.GetEntity(proxy) == entity) && "Destroyed entity still has a proxy.");
+		if (DynamicAABBTree::NullNode == proxy)
+		{
+			m_entityToProxy.Set(entityIndex, m_tree.CreateProxy(worldMin, worldMax, entity));
+		}
+		else
+		{
+			m_tree.MoveProxy(proxy, worldMin, worldMax);
+		}
+	}
+
+private:
+	World* m_pWorld;
+	uint32_t m_destroyCallbackID;
+	ComponentsStorage<CollisionMeshComponent>* m_pCollisionMeshStorage;
+	ComponentsStorage<TransformComponent>* m_pTransformStorage;
+
+	DynamicAABBTree m_tree;
+
+	// Entity index -> proxy id in m_tree.
+	PagedSparseArray<uint32_t, DynamicAABBTree::NullNode> m_entityToProxy;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CD_TRANSFORM_BATCH_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CD_TRANSFORM_BATCH_SSE
+#endif
+
+namespace engine
+{
+
+namespace details
+{
+
+// Lanes wrap the few vector operations to compose matrices so that one kernel serves all instruction sets.
+struct ScalarLanes
+{
+	using Vector = float;
+	static constexpr size_t Width = 1;
+
+	static Vector Load(const float* pData) { return *pData; }
+	static void Store(float* pData, Vector value) { *pData = value; }
+	static Vector Set(float value) { return value; }
+	static Vector Add(Vector lhs, Vector rhs) { return lhs + rhs; }
+	static Vector Sub(Vector lhs, Vector rhs) { return lhs - rhs; }
+	static Vector Mul(Vector lhs, Vector rhs) { return lhs * rhs; }
+};
+
+#if defined(CD_TRANSFORM_BATCH_AVX)
+struct SIMDLanes
+{
+	using Vector = __m256;
+	static constexpr size_t Width = 8;
+
+	static Vector Load(const float* pData) { return _mm256_loadu_ps(pData); }
+	static void Store(float* pData, Vector value) { _mm256_storeu_ps(pData, value); }
+	static Vector Set(float value) { return _mm256_set1_ps(value); }
+	static Vector Add(Vector lhs, Vector rhs) { return _mm256_add_ps(lhs, rhs); }
+	static Vector Sub(Vector lhs, Vector rhs) { return _mm256_sub_ps(lhs, rhs); }
+	static Vector Mul(Vector lhs, Vector rhs) { return _mm256_mul_ps(lhs, rhs); }
+};
+#elif defined(CD_TRANSFORM_BATCH_SSE)
+struct SIMDLanes
+{
+	using Vector = __m128;
+	static constexpr size_t Width = 4;
+
+	static Vector Load(const float* pData) { return _mm_loadu_ps(pData); }
+	static void Store(float* pData, Vector value) { _mm_storeu_ps(pData, value); }
+	static Vector Set(float value) { return _mm_set1_ps(value); }
+	static Vector Add(Vector lhs, Vector rhs) { return _mm_add_ps(lhs, rhs); }
+	static Vector Sub(Vector lhs, Vector rhs) { return _mm_sub_ps(lhs, rhs); }
+	static Vector Mul(Vector lhs, Vector rhs) { return _mm_mul_ps(lhs, rhs); }
+};
+#else
+using SIMDLanes = ScalarLanes;
+#endif
+
+}
+
+// TransformBatch stores translation, rotation and scale of many transforms in separate arrays
+// and composes them to column major T * R * S matrices SIMDLanes::Width at a time, 8 with AVX, 4 with SSE, 1 otherwise.
+// Arrays are kept between batches so that refilling them doesn't allocate.
+class TransformBatch final
+{
+public:
+	static constexpr size_t LaneWidth = details::SIMDLanes::Width;
+
+public:
+	TransformBatch() = default;
+	TransformBatch(const TransformBatch&) = delete;
+	TransformBatch& operator=(const TransformBatch&) = delete;
+	TransformBatch(TransformBatch&&) = default;
+	TransformBatch& operator=(TransformBatch&&) = default;
+	~TransformBatch() = default;
+
+	void Clear()
+	{
+		for (std::vector<float>& channel : m_channels)
+		{
+			channel.clear();
+		}
+		m_outputMatrices.clear();
+	}
+
+	size_t GetCount() const { return m_outputMatrices.size(); }
+
+	// Rotation is a normalized quaternion. pOutputMatrix points to 16 floats which receive the result in Build.
+	void Add(float tx, float ty, float tz, float qx, float qy, float qz, float qw, float sx, float sy, float sz, float* pOutputMatrix)
+	{
+		assert(pOutputMatrix);
+		const float values[ChannelCount] = { tx, ty, tz, qx, qy, qz, qw, sx, sy, sz };
+		for (size_t channelIndex = 0; channelIndex < ChannelCount; ++channelIndex)
+		{
+			m_channels[channelIndex].push_back(values[channelIndex]);
+		}
+		m_outputMatrices.push_back(pOutputMatrix);
+	}
+
+	void Build()
+	{
+		size_t count = GetCount();
+		size_t simdCount = count - count % LaneWidth;
+		Compose<details::SIMDLanes>(0, simdCount);
+		Compose<details::ScalarLanes>(simdCount, count);
+	}
+
+private:
+	enum Channel
+	{
+		TranslationX, TranslationY, TranslationZ,
+		RotationX, RotationY, RotationZ, RotationW,
+		ScaleX, ScaleY, ScaleZ,
+		ChannelCount
+	};
+
+	template<typename Lanes>
+	void Compose(size_t beginIndex, size_t endIndex)
+	{
+		using Vector = typename Lanes::Vector;
+		const Vector one = Lanes::Set(1.0f);
+		const Vector two = Lanes::Set(2.0f);
+
+		// Rows of the 3x4 part of matrices which vary per lane. The last row is always (0, 0, 0, 1).
+		float lanes[12][Lanes::Width];
+		for (size_t index = beginIndex; index < endIndex; index += Lanes::Width)
+		{
+			Vector qx = Lanes::Load(&m_channels[RotationX][index]);
+			Vector qy = Lanes::Load(&m_channels[RotationY][index]);
+			Vector qz = Lanes::Load(&m_channels[RotationZ][index]);
+			Vector qw = Lanes::Load(&m_channels[RotationW][index]);
+			Vector x2 = Lanes::Mul(qx, two);
+			Vector y2 = Lanes::Mul(qy, two);
+			Vector z2 = Lanes::Mul(qz, two);
+			Vector xx = Lanes::Mul(qx, x2);
+			Vector yy = Lanes::Mul(qy, y2);
+			Vector zz = Lanes::Mul(qz, z2);
+			Vector xy = Lanes::Mul(qx, y2);
+			Vector xz = Lanes::Mul(qx, z2);
+			Vector yz = Lanes::Mul(qy, z2);
+			Vector wx = Lanes::Mul(qw, x2);
+			Vector wy = Lanes::Mul(qw, y2);
+			Vector wz = Lanes::Mul(qw, z2);
+
+			Vector sx = Lanes::Load(&m_channels[ScaleX][index]);
+			Vector sy = Lanes::Load(&m_channels[ScaleY][index]);
+			Vector sz = Lanes::Load(&m_channels[ScaleZ][index]);
+
+			// Row r, column c is stored at lanes[c * 3 + r] and written to matrix[c * 4 + r].
+			Lanes::Store(lanes[0], Lanes::Mul(Lanes::Sub(one, Lanes::Add(yy, zz)), sx));
+			Lanes::Store(lanes[1], Lanes::Mul(Lanes::Add(xy, wz), sx));
+			Lanes::Store(lanes[2], Lanes::Mul(Lanes::Sub(xz, wy), sx));
+			Lanes::Store(lanes[3], Lanes::Mul(Lanes::Sub(xy, wz), sy));
+			Lanes::Store(lanes[4], Lanes::Mul(Lanes::Sub(one, Lanes::Add(xx, zz)), sy));
+			Lanes::Store(lanes[5], Lanes::Mul(Lanes::Add(yz, wx), sy));
+			Lanes::Store(lanes[6], Lanes::Mul(Lanes::Add(xz, wy), sz));
+			Lanes::Store(lanes[7], Lanes::Mul(Lanes::Sub(yz, wx), sz));
+			Lanes::Store(lanes[8], Lanes::Mul(Lanes::Sub(one, Lanes::Add(xx, yy)), sz));
+			Lanes::Store(lanes[9], Lanes::Load(&m_channels[TranslationX][index]));
+			Lanes::Store(lanes[10], Lanes::Load(&m_channels[TranslationY][index]));
+			Lanes::Store(lanes[11], Lanes::Load(&m_channels[TranslationZ][index]));
+
+			for (size_t lane = 0; lane < Lanes::Width; ++lane)
+			{
+				float* pMatrix = m_outputMatrices[index + lane];
+				for (size_t column = 0; column < 4; ++column)
+				{
+					pMatrix[column * 4 + 0] = lanes[column * 3 + 0][lane];
+					pMatrix[column * 4 + 1] = lanes[column * 3 + 1][lane];
+					pMatrix[column * 4 + 2] = lanes[column * 3 + 2][lane];
+					pMatrix[column * 4 + 3] = 3 == column ? 1.0f : 0.0f;
+				}
+			}
+		}
+	}
+
+private:
+	std::vector<float> m_channels[ChannelCount];
+	std::vector<float*> m_outputMatrices;
+};
+
+}
\ No newline at end of file
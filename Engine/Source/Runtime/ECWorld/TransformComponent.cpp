@@ -10,14 +10,6 @@ void TransformComponent::Reset()
 	m_isMatrixDirty = true;
 }
 
-void TransformComponent::Build()
-{
-	if (m_isMatrixDirty)
-	{
-		m_localToWorldMatrix = m_transform.GetMatrix();
-		m_isMatrixDirty = false;
-	}
-}
 #ifdef EDITOR_MODE
 bool TransformComponent::m_doUseUniformScale = true;
 #endif
@@ -28,11 +28,32 @@ public:
 	void SetTransform(cd::Transform transform) { m_transform = cd::MoveTemp(transform); m_isMatrixDirty = true;  }
 
 	const cd::Matrix4x4& GetWorldMatrix() const { return m_localToWorldMatrix; }
+	cd::Matrix4x4& GetWorldMatrix() { return m_localToWorldMatrix; }
 
 	void Dirty() const { m_isMatrixDirty = true; }
+	bool IsDirty() const { return m_isMatrixDirty; }
+
+	// Batched builders write world matrix in place and then mark it as built.
+	void MarkBuilt() const { m_isMatrixDirty = false; }
 
 	void Reset();
-	void Build();
+
+	// Build world matrix of a root.
+	void Build()
+	{
+		if (m_isMatrixDirty)
+		{
+			m_localToWorldMatrix = m_transform.GetMatrix();
+			m_isMatrixDirty = false;
+		}
+	}
+
+	// Build world matrix under the parent's world matrix.
+	void Build(const cd::Matrix4x4& parentWorldMatrix)
+	{
+		m_localToWorldMatrix = parentWorldMatrix * m_transform.GetMatrix();
+		m_isMatrixDirty = false;
+	}
 
 #ifdef EDITOR_MODE
 	static bool DoUseUniformScale() { return m_doUseUniformScale; }
@@ -44,7 +65,7 @@ private:
 	cd::Transform m_transform;
 
 	// Status
-	mutable bool m_isMatrixDirty;
+	mutable bool m_isMatrixDirty = true;
 
 	// Output
 	cd::Matrix4x4 m_localToWorldMatrix;
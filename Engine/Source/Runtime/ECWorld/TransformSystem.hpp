@@ -0,0 +1,351 @@
+#pragma once
+
+#include "ECWorld/HierarchyComponent.h"
+#include "ECWorld/PagedSparseArray.hpp"
+#include "ECWorld/TransformBatch.hpp"
+#include "ECWorld/TransformComponent.h"
+#include "ECWorld/World.h"
+
+#include <algorithm>
+#include <cassert>
+#include <execution>
+#include <vector>
+
+namespace engine
+{
+
+// TransformSystem maintains parent-child links in HierarchyComponents and propagates world matrices of TransformComponents.
+// Children are chained by first-child/next-sibling links so that walking a subtree never scans unrelated entities.
+// Update only rebuilds subtrees under entities marked dirty, shallowest first, and independent subtrees are built in parallel.
+// BuildAll composes world matrices of roots marked dirty in SIMD batches before that.
+// Rebuilt TransformComponents are marked changed if their storage tracks changes.
+class TransformSystem final
+{
+public:
+	TransformSystem() = delete;
+	explicit TransformSystem(World* pWorld)
+		: m_pWorld(pWorld)
+		, m_pHierarchyStorage(pWorld->GetComponents<HierarchyComponent>())
+		, m_pTransformStorage(pWorld->GetComponents<TransformComponent>())
+	{
+		// Children of destroyed entities become roots instead of pointing to a destroyed parent.
+		m_destroyCallbackID = pWorld->AddDestroyCallback([this](Entity entity) { RemoveFromHierarchy(entity); });
+	}
+	TransformSystem(const TransformSystem&) = delete;
+	TransformSystem& operator=(const TransformSystem&) = delete;
+	TransformSystem(TransformSystem&&) = delete;
+	TransformSystem& operator=(TransformSystem&&) = delete;
+	~TransformSystem() { m_pWorld->RemoveDestroyCallback(m_destroyCallbackID); }
+
+	// Attach child to parent. Pass INVALID_ENTITY as parent to make child a root.
+	// Returns false if parent is in the subtree of child.
+	bool SetParent(Entity child, Entity parent)
+	{
+		assert(child != INVALID_ENTITY && child != parent);
+		for (Entity ancestor = parent; ancestor != INVALID_ENTITY; ancestor = GetParent(ancestor))
+		{
+			if (ancestor == child)
+			{
+				return false;
+			}
+		}
+
+		// Create components before taking pointers as it may reallocate the storage.
+		if (!m_pHierarchyStorage->Contains(child))
+		{
+			m_pHierarchyStorage->CreateComponent(child);
+		}
+		if (parent != INVALID_ENTITY && !m_pHierarchyStorage->Contains(parent))
+		{
+			m_pHierarchyStorage->CreateComponent(parent);
+		}
+
+		HierarchyComponent* pChild = m_pHierarchyStorage->GetComponent(child);
+		if (pChild->GetParentEntity() == parent)
+		{
+			return true;
+		}
+
+		Unlink(child, *pChild);
+		if (parent != INVALID_ENTITY)
+		{
+			HierarchyComponent* pParent = m_pHierarchyStorage->GetComponent(parent);
+			Entity oldFirstChild = pParent->GetFirstChildEntity();
+			if (oldFirstChild != INVALID_ENTITY)
+			{
+				m_pHierarchyStorage->GetComponent(oldFirstChild)->SetPrevSiblingEntity(child);
+			}
+			pChild->SetNextSiblingEntity(oldFirstChild);
+			pChild->SetParentEntity(parent);
+			pParent->SetFirstChildEntity(child);
+		}
+
+		UpdateDepth(child);
+		MarkDirty(child);
+		return true;
+	}
+
+	// Detach entity from its parent and make its children roots. World::DestroyEntity calls it.
+	void RemoveFromHierarchy(Entity entity)
+	{
+		HierarchyComponent* pHierarchy = m_pHierarchyStorage->GetComponent(entity);
+		if (!pHierarchy)
+		{
+			return;
+		}
+
+		Unlink(entity, *pHierarchy);
+		Entity child = pHierarchy->GetFirstChildEntity();
+		pHierarchy->SetFirstChildEntity(INVALID_ENTITY);
+		while (child != INVALID_ENTITY)
+		{
+			HierarchyComponent* pChild = m_pHierarchyStorage->GetComponent(child);
+			Entity nextSibling = pChild->GetNextSiblingEntity();
+			pChild->SetParentEntity(INVALID_ENTITY);
+			pChild->SetPrevSiblingEntity(INVALID_ENTITY);
+			pChild->SetNextSiblingEntity(INVALID_ENTITY);
+			UpdateDepth(child);
+			MarkDirty(child);
+			child = nextSibling;
+		}
+	}
+
+	Entity GetParent(Entity entity) const
+	{
+		const HierarchyComponent* pHierarchy = m_pHierarchyStorage->GetComponent(entity);
+		return pHierarchy ? pHierarchy->GetParentEntity() : INVALID_ENTITY;
+	}
+
+	bool HasChildren(Entity entity) const
+	{
+		const HierarchyComponent* pHierarchy = m_pHierarchyStorage->GetComponent(entity);
+		return pHierarchy && pHierarchy->HasChildren();
+	}
+
+	uint32_t GetDepth(Entity entity) const
+	{
+		const HierarchyComponent* pHierarchy = m_pHierarchyStorage->GetComponent(entity);
+		return pHierarchy ? pHierarchy->GetDepth() : 0U;
+	}
+
+	// func(Entity). It is safe to detach the visited child in func.
+	template<typename Func>
+	void ForEachChild(Entity parent, Func&& func) const
+	{
+		const HierarchyComponent* pParent = m_pHierarchyStorage->GetComponent(parent);
+		Entity child = pParent ? pParent->GetFirstChildEntity() : INVALID_ENTITY;
+		while (child != INVALID_ENTITY)
+		{
+			Entity nextSibling = m_pHierarchyStorage->GetComponent(child)->GetNextSiblingEntity();
+			func(child);
+			child = nextSibling;
+		}
+	}
+
+	// func(Entity) is called on root and its descendants in pre-order so parents are always visited before children.
+	template<typename Func>
+	void ForEachInSubtree(Entity root, Func&& func) const
+	{
+		Entity current = root;
+		while (true)
+		{
+			func(current);
+
+			const HierarchyComponent* pCurrent = m_pHierarchyStorage->GetComponent(current);
+			if (pCurrent && pCurrent->HasChildren())
+			{
+				current = pCurrent->GetFirstChildEntity();
+				continue;
+			}
+
+			// Climb up until there is a sibling to visit. Siblings of root are not in the subtree.
+			while (current != root && INVALID_ENTITY == m_pHierarchyStorage->GetComponent(current)->GetNextSiblingEntity())
+			{
+				current = m_pHierarchyStorage->GetComponent(current)->GetParentEntity();
+			}
+
+			if (current == root)
+			{
+				break;
+			}
+			current = m_pHierarchyStorage->GetComponent(current)->GetNextSiblingEntity();
+		}
+	}
+
+	// Local transform of entity changed so its subtree will be rebuilt in the next BuildAll or Update.
+	// Call it after editing a TransformComponent, otherwise only lazy TransformComponent::Build picks the change up.
+	void MarkDirty(Entity entity) { m_dirtyEntities.push_back(entity); }
+
+	// Not thread safe. Build world matrices of roots marked dirty, so the cost follows edits instead of the scene size.
+	// Roots are composed from TRS in SIMD batches. Children need their parents' matrices so they are left to Update.
+	void BuildAll()
+	{
+		m_batch.Clear();
+
+		// Children marked below are appended after dirtyCount.
+		size_t dirtyCount = m_dirtyEntities.size();
+		for (size_t dirtyIndex = 0; dirtyIndex < dirtyCount; ++dirtyIndex)
+		{
+			Entity entity = m_dirtyEntities[dirtyIndex];
+			TransformComponent* pTransform = m_pTransformStorage->GetComponent(entity);
+			if (!pTransform || GetParent(entity) != INVALID_ENTITY)
+			{
+				continue;
+			}
+
+			// Batched roots leave the list, Update only rebuilds below them. A root marked twice is composed twice.
+			m_dirtyEntities[dirtyIndex] = INVALID_ENTITY;
+
+			const cd::Transform& transform = pTransform->GetTransform();
+			const cd::Vec3f& translation = transform.GetTranslation();
+			const cd::Quaternion& rotation = transform.GetRotation();
+			const cd::Vec3f& scale = transform.GetScale();
+			m_batch.Add(translation.x(), translation.y(), translation.z(), rotation.x(), rotation.y(), rotation.z(), rotation.w(),
+				scale.x(), scale.y(), scale.z(), pTransform->GetWorldMatrix().Begin());
+			pTransform->MarkBuilt();
+			m_pTransformStorage->MarkChanged(entity);
+
+			ForEachChild(entity, [this](Entity child) { MarkDirty(child); });
+		}
+
+		// No storage changes above so output pointers are still valid.
+		m_batch.Build();
+		std::erase(m_dirtyEntities, INVALID_ENTITY);
+	}
+
+	// Not thread safe. Rebuild world matrices of dirty subtrees.
+	void Update()
+	{
+		if (m_dirtyEntities.empty())
+		{
+			return;
+		}
+
+		// Shallow entities first so that a dirty ancestor covers dirty descendants.
+		// Storages are not kept in depth order, sorting the few dirty entities is cheaper.
+		++m_updateIndex;
+		std::sort(m_dirtyEntities.begin(), m_dirtyEntities.end(), [this](Entity lhs, Entity rhs) { return GetDepth(lhs) < GetDepth(rhs); });
+		for (Entity entity : m_dirtyEntities)
+		{
+			if (!m_pTransformStorage->Contains(entity) && !m_pHierarchyStorage->Contains(entity))
+			{
+				// Destroyed after it was marked.
+				continue;
+			}
+
+			bool isCovered = false;
+			for (Entity ancestor = entity; ancestor != INVALID_ENTITY; ancestor = GetParent(ancestor))
+			{
+				if (m_subtreeRootMarks.Get(GetEntityIndex(ancestor)) == m_updateIndex)
+				{
+					isCovered = true;
+					break;
+				}
+			}
+
+			if (!isCovered)
+			{
+				m_subtreeRootMarks.Set(GetEntityIndex(entity), m_updateIndex);
+				m_dirtySubtreeRoots.push_back(entity);
+			}
+		}
+		m_dirtyEntities.clear();
+
+		// Subtrees are disjoint and only read matrices of clean ancestors.
+		auto BuildSubtree = [this](Entity root) { BuildWorldMatrices(root); };
+		if (m_dirtySubtreeRoots.size() >= ParallelSubtreeCount)
+		{
+			std::for_each(std::execution::par, m_dirtySubtreeRoots.begin(), m_dirtySubtreeRoots.end(), BuildSubtree);
+		}
+		else
+		{
+			std::for_each(m_dirtySubtreeRoots.begin(), m_dirtySubtreeRoots.end(), BuildSubtree);
+		}
+
+		// Changed marks share bit words between entities so they are recorded serially.
+		if (m_pTransformStorage->IsChangeTrackingEnabled())
+		{
+			for (Entity root : m_dirtySubtreeRoots)
+			{
+				ForEachInSubtree(root, [this](Entity entity) { m_pTransformStorage->MarkChanged(entity); });
+			}
+		}
+		m_dirtySubtreeRoots.clear();
+	}
+
+private:
+	// Too few subtrees don't pay for the task dispatch.
+	static constexpr size_t ParallelSubtreeCount = 16U;
+
+	void Unlink(Entity entity, HierarchyComponent& hierarchy)
+	{
+		Entity parent = hierarchy.GetParentEntity();
+		if (INVALID_ENTITY == parent)
+		{
+			return;
+		}
+
+		Entity prevSibling = hierarchy.GetPrevSiblingEntity();
+		Entity nextSibling = hierarchy.GetNextSiblingEntity();
+		if (prevSibling != INVALID_ENTITY)
+		{
+			m_pHierarchyStorage->GetComponent(prevSibling)->SetNextSiblingEntity(nextSibling);
+		}
+		else
+		{
+			assert(m_pHierarchyStorage->GetComponent(parent)->GetFirstChildEntity() == entity);
+			m_pHierarchyStorage->GetComponent(parent)->SetFirstChildEntity(nextSibling);
+		}
+
+		if (nextSibling != INVALID_ENTITY)
+		{
+			m_pHierarchyStorage->GetComponent(nextSibling)->SetPrevSiblingEntity(prevSibling);
+		}
+
+		hierarchy.SetParentEntity(INVALID_ENTITY);
+		hierarchy.SetPrevSiblingEntity(INVALID_ENTITY);
+		hierarchy.SetNextSiblingEntity(INVALID_ENTITY);
+	}
+
+	void UpdateDepth(Entity root)
+	{
+		ForEachInSubtree(root, [this](Entity entity)
+		{
+			HierarchyComponent* pHierarchy = m_pHierarchyStorage->GetComponent(entity);
+			Entity parent = pHierarchy->GetParentEntity();
+			pHierarchy->SetDepth(INVALID_ENTITY == parent ? 0U : m_pHierarchyStorage->GetComponent(parent)->GetDepth() + 1U);
+		});
+	}
+
+	void BuildWorldMatrices(Entity root)
+	{
+		ForEachInSubtree(root, [this](Entity entity)
+		{
+			TransformComponent* pTransform = m_pTransformStorage->GetComponent(entity);
+			if (!pTransform)
+			{
+				return;
+			}
+
+			// Parent without TransformComponent is treated as identity.
+			const TransformComponent* pParentTransform = m_pTransformStorage->GetComponent(GetParent(entity));
+			pTransform->Build(pParentTransform ? pParentTransform->GetWorldMatrix() : cd::Matrix4x4::Identity());
+		});
+	}
+
+private:
+	World* m_pWorld;
+	uint32_t m_destroyCallbackID;
+	ComponentsStorage<HierarchyComponent>* m_pHierarchyStorage;
+	ComponentsStorage<TransformComponent>* m_pTransformStorage;
+
+	TransformBatch m_batch;
+	std::vector<Entity> m_dirtyEntities;
+	std::vector<Entity> m_dirtySubtreeRoots;
+
+	// Entity index -> last Update which picked entity as a subtree root.
+	PagedSparseArray<uint32_t, 0U> m_subtreeRootMarks;
+	uint32_t m_updateIndex = 0U;
+};
+
+}
\ No newline at end of file
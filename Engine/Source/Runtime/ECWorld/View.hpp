@@ -0,0 +1,143 @@
+#pragma once
+
+#include "ComponentSignature.h"
+#include "ComponentsStorage.hpp"
+#include "Entity.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+namespace engine
+{
+
+// Type list of component types which entities in the View should not own.
+template<typename... Components>
+struct Exclude final
+{
+};
+
+template<typename TExclude, typename... Components>
+class View;
+
+// View iterates entities which own all Components and none of Excludes.
+// It drives iteration by the smallest included storage and filters by others, so components are fetched only once.
+// When storages are registered in a World, entity signatures reject mismatched entities before touching any storage.
+// Adding or removing components of viewed types while iterating is not allowed.
+template<typename... Excludes, typename... Components>
+class View<Exclude<Excludes...>, Components...> final
+{
+public:
+	static_assert(sizeof...(Components) > 0, "View needs at least one included component type.");
+
+public:
+	View() = delete;
+	explicit View(const ComponentSignatureTable* pSignatureTable, ComponentsStorage<Components>*... pStorages, ComponentsStorage<Excludes>*... pExcludeStorages)
+		: m_includeStorages(pStorages...)
+		, m_excludeStorages(pExcludeStorages...)
+		, m_pSignatureTable(pSignatureTable)
+		, m_includeSignature(GetComponentSignature<Components...>())
+		, m_excludeSignature(GetComponentSignature<Excludes...>())
+	{
+		m_pDrivingEntities = &std::get<0>(m_includeStorages)->GetEntities();
+		std::apply([this](auto*... pStorage)
+		{
+			((m_pDrivingEntities = pStorage->GetEntities().size() < m_pDrivingEntities->size() ? &pStorage->GetEntities() : m_pDrivingEntities), ...);
+		}, m_includeStorages);
+	}
+	View(const View&) = default;
+	View& operator=(const View&) = default;
+	View(View&&) = default;
+	View& operator=(View&&) = default;
+	~View() = default;
+
+	// Upper bound of entities count in the View. Use it to split [0, count) into ranges for parallel iteration.
+	size_t GetCandidateCount() const { return m_pDrivingEntities->size(); }
+	Entity GetCandidateEntity(size_t index) const { return (*m_pDrivingEntities)[index]; }
+
+	bool Contains(Entity entity) const
+	{
+		if (m_pSignatureTable)
+		{
+			// Signature is stored per entity index so validate the handle generation by one storage.
+			ComponentSignature signature = m_pSignatureTable->Get(entity);
+			return (signature & m_includeSignature) == m_includeSignature && 0U == (signature & m_excludeSignature) &&
+				std::get<0>(m_includeStorages)->Contains(entity);
+		}
+
+		return std::apply([entity](auto*... pStorage) { return (pStorage->Contains(entity) && ...); }, m_includeStorages) &&
+			!IsExcluded(entity);
+	}
+
+	// func(Entity, Components&...)
+	template<typename Func>
+	void Each(Func&& func) const
+	{
+		Each(0, GetCandidateCount(), func);
+	}
+
+	// Iterate candidates in the range [beginIndex, endIndex) which is safe to run on different threads for disjoint ranges.
+	template<typename Func>
+	void Each(size_t beginIndex, size_t endIndex, Func&& func) const
+	{
+		assert(beginIndex <= endIndex && endIndex <= GetCandidateCount());
+		for (size_t index = beginIndex; index < endIndex; ++index)
+		{
+			Entity entity = (*m_pDrivingEntities)[index];
+			if (m_pSignatureTable)
+			{
+				ComponentSignature signature = m_pSignatureTable->Get(entity);
+				if ((signature & m_includeSignature) != m_includeSignature || (signature & m_excludeSignature) != 0U)
+				{
+					continue;
+				}
+
+				std::apply([&func, entity](auto*... pStorage) { func(entity, *pStorage->GetComponent(entity)...); }, m_includeStorages);
+				continue;
+			}
+
+			std::tuple<Components*...> components(std::get<ComponentsStorage<Components>*>(m_includeStorages)->GetComponent(entity)...);
+			if (!std::apply([](auto*... pComponent) { return ((pComponent != nullptr) && ...); }, components) || IsExcluded(entity))
+			{
+				continue;
+			}
+
+			std::apply([&func, entity](auto*... pComponent) { func(entity, *pComponent...); }, components);
+		}
+	}
+
+	// Collect entities in the View.
+	std::vector<Entity> GetEntities() const
+	{
+		std::vector<Entity> entities;
+		entities.reserve(GetCandidateCount());
+		Each([&entities](Entity entity, Components&...) { entities.push_back(entity); });
+		return entities;
+	}
+
+private:
+	bool IsExcluded(Entity entity) const
+	{
+		if constexpr (0 == sizeof...(Excludes))
+		{
+			return false;
+		}
+		else
+		{
+			return std::apply([entity](auto*... pStorage) { return (pStorage->Contains(entity) || ...); }, m_excludeStorages);
+		}
+	}
+
+private:
+	std::tuple<ComponentsStorage<Components>*...> m_includeStorages;
+	std::tuple<ComponentsStorage<Excludes>*...> m_excludeStorages;
+	const std::vector<Entity>* m_pDrivingEntities = nullptr;
+
+	const ComponentSignatureTable* m_pSignatureTable = nullptr;
+	ComponentSignature m_includeSignature = 0U;
+	ComponentSignature m_excludeSignature = 0U;
+};
+
+}
\ No newline at end of file
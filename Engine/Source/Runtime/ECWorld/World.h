@@ -1,12 +1,14 @@
 #pragma once
 
 #include "ComponentsStorage.hpp"
+#include "ComponentTypeID.h"
 #include "Entity.h"
-#include "Core/StringCrc.h"
+#include "View.hpp"
 
-#include <atomic>
 #include <cassert>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace engine
@@ -16,50 +18,195 @@ namespace engine
 // Usually, there is only one world shared between multiple threads.
 class World
 {
+public:
+	using DestroyCallback = std::function<void(Entity)>;
+
 public:
 	World() = default;
 	World(const World&) = delete;
 	World& operator=(const World&) = delete;
-	World(World&&) = default;
-	World& operator=(World&&) = default;
+	World(World&&) = delete;
+	World& operator=(World&&) = delete;
 	~World() = default;
 
+	// Thread safe. Reuses the index of destroyed entities first.
 	Entity CreateEntity()
 	{
-		// Overflow is expected as I want to use the max value of EntityID as invalid value.
-		// So I allocate entity id from 0.
-		static std::atomic<Entity> nextEntity = INVALID_ENTITY + 1;
-		return nextEntity.fetch_add(1);
+		std::lock_guard<std::mutex> lock(m_entityMutex);
+		return AllocateEntity();
 	}
 
+	// Thread safe. Reserves count entities under one lock which is useful to import large scenes.
+	std::vector<Entity> CreateEntities(size_t count)
+	{
+		std::vector<Entity> entities;
+		entities.reserve(count);
+
+		std::lock_guard<std::mutex> lock(m_entityMutex);
+		m_entitySlots.reserve(m_entitySlots.size() + (count > m_freeEntityIndexes.size() ? count - m_freeEntityIndexes.size() : 0));
+		for (size_t index = 0; index < count; ++index)
+		{
+			entities.push_back(AllocateEntity());
+		}
+
+		return entities;
+	}
+
+	// Removes all components owned by entity and releases its id.
+	// Not thread safe as it modifies ComponentsStorages.
+	void DestroyEntity(Entity entity)
+	{
+		if (!IsAlive(entity))
+		{
+			return;
+		}
+
+		// Components are still there so that systems can unlink entity from what they keep.
+		for (const DestroyCallback& callback : m_destroyCallbacks)
+		{
+			if (callback)
+			{
+				callback(entity);
+			}
+		}
+
+		// Only visit storages which entity owns.
+		ComponentSignature signature = m_signatureTable.Get(entity);
+		while (signature != 0U)
+		{
+			ComponentTypeID typeID = GetLowestBitIndex(signature);
+			m_componentsLib[typeID]->RemoveComponent(entity);
+			signature &= signature - 1U;
+		}
+		assert(0U == m_signatureTable.Get(entity));
+
+		std::lock_guard<std::mutex> lock(m_entityMutex);
+
+		// Increase generation so that old handles become stale.
+		uint32_t entityIndex = GetEntityIndex(entity);
+		m_entitySlots[entityIndex] = static_cast<uint16_t>((GetEntityGeneration(entity) + 1U) & ENTITY_GENERATION_MASK);
+		m_freeEntityIndexes.push_back(entityIndex);
+	}
+
+	// Returns false for INVALID_ENTITY, destroyed entities and stale handles whose index was recycled.
+	// It doesn't lock so don't call it together with CreateEntity/DestroyEntity on other threads.
+	bool IsAlive(Entity entity) const
+	{
+		uint32_t entityIndex = GetEntityIndex(entity);
+		return entity != INVALID_ENTITY && entityIndex < m_entitySlots.size() &&
+			m_entitySlots[entityIndex] == (AliveSlotBit | GetEntityGeneration(entity));
+	}
+
+	// Returns alive entities count.
+	size_t GetEntityCount() const { return m_entitySlots.size() - m_freeEntityIndexes.size(); }
+
 	template<typename Component>
 	ComponentsStorage<Component>* Register()
 	{
-		StringCrc componentName = Component::GetClassName();
-		assert(m_componentsLib.find(componentName.Value()) == m_componentsLib.end());
-		m_componentsLib[componentName.Value()] = std::make_unique<ComponentsStorage<Component>>();
-		return static_cast<ComponentsStorage<Component>*>(m_componentsLib[componentName.Value()].get());
+		ComponentTypeID typeID = GetComponentTypeID<Component>();
+		assert(typeID < MAX_COMPONENT_TYPE_COUNT && "Too many component types.");
+		if (typeID >= m_componentsLib.size())
+		{
+			m_componentsLib.resize(typeID + 1);
+		}
+
+		assert(!m_componentsLib[typeID] && "Component storage is already registered.");
+		auto pStorage = std::make_unique<ComponentsStorage<Component>>();
+		pStorage->BindSignatureTable(&m_signatureTable, typeID);
+		m_componentsLib[typeID] = cd::MoveTemp(pStorage);
+		return static_cast<ComponentsStorage<Component>*>(m_componentsLib[typeID].get());
 	}
 
 	template<typename Component>
 	ComponentsStorage<Component>* GetComponents()
 	{
-		StringCrc componentName = Component::GetClassName();
-		assert(m_componentsLib.find(componentName.Value()) != m_componentsLib.end());
-		return static_cast<ComponentsStorage<Component>*>(m_componentsLib[componentName.Value()].get());
+		ComponentTypeID typeID = GetComponentTypeID<Component>();
+		assert(typeID < m_componentsLib.size() && m_componentsLib[typeID] && "Component storage is not registered.");
+		return static_cast<ComponentsStorage<Component>*>(m_componentsLib[typeID].get());
 	}
 
 	template<typename Component>
 	Component& CreateComponent(Entity entity)
 	{
-		StringCrc componentName = Component::GetClassName();
-		assert(m_componentsLib.find(componentName.Value()) != m_componentsLib.end());
-		ComponentsStorage<Component>* pStorage = static_cast<ComponentsStorage<Component>*>(m_componentsLib[componentName.Value()].get());
-		return pStorage->CreateComponent(entity);
+		return GetComponents<Component>()->CreateComponent(entity);
+	}
+
+	// Systems which keep data about entities register a callback to clean it up however entities are destroyed,
+	// e.g. by EntityCommandBuffer. Returns an id to remove the callback before the system is destroyed.
+	uint32_t AddDestroyCallback(DestroyCallback callback)
+	{
+		m_destroyCallbacks.push_back(cd::MoveTemp(callback));
+		return static_cast<uint32_t>(m_destroyCallbacks.size() - 1);
+	}
+
+	// Keeps ids of other callbacks valid.
+	void RemoveDestroyCallback(uint32_t callbackID) { m_destroyCallbacks[callbackID] = nullptr; }
+
+	// Reset changed marks of all storages which track changes. Call it after systems have consumed the changes of a frame.
+	void ClearChangedComponents()
+	{
+		for (std::unique_ptr<IComponentsStorage>& pStorage : m_componentsLib)
+		{
+			if (pStorage)
+			{
+				pStorage->ClearChanged();
+			}
+		}
+	}
+
+	// Returns which component types entity owns.
+	ComponentSignature GetSignature(Entity entity) const { return IsAlive(entity) ? m_signatureTable.Get(entity) : 0U; }
+
+	// Returns if entity owns all Components.
+	template<typename... Components>
+	bool Has(Entity entity) const
+	{
+		ComponentSignature mask = GetComponentSignature<Components...>();
+		return (GetSignature(entity) & mask) == mask;
+	}
+
+	// Query entities which own all Components and none of Excludes. For example :
+	// View<TransformComponent, StaticMeshComponent>(Exclude<AnimationComponent>{}).Each([](Entity, TransformComponent&, StaticMeshComponent&) {});
+	template<typename... Components, typename... Excludes>
+	engine::View<Exclude<Excludes...>, Components...> View(Exclude<Excludes...> = {})
+	{
+		return engine::View<Exclude<Excludes...>, Components...>(&m_signatureTable, GetComponents<Components>()..., GetComponents<Excludes>()...);
+	}
+
+private:
+	// Slot bits : [alive : 1 | generation : ENTITY_GENERATION_BITS].
+	static constexpr uint16_t AliveSlotBit = 1U << ENTITY_GENERATION_BITS;
+
+	Entity AllocateEntity()
+	{
+		uint32_t entityIndex;
+		if (!m_freeEntityIndexes.empty())
+		{
+			entityIndex = m_freeEntityIndexes.back();
+			m_freeEntityIndexes.pop_back();
+		}
+		else
+		{
+			assert(m_entitySlots.size() <= MAX_ENTITY_INDEX && "Entity index overflow.");
+			entityIndex = static_cast<uint32_t>(m_entitySlots.size());
+			m_entitySlots.push_back(0U);
+		}
+
+		uint16_t& slot = m_entitySlots[entityIndex];
+		slot |= AliveSlotBit;
+		return MakeEntity(entityIndex, slot & ENTITY_GENERATION_MASK);
 	}
 
 private:
-	std::unordered_map<size_t, std::unique_ptr<IComponentsStorage>> m_componentsLib;
+	std::mutex m_entityMutex;
+	std::vector<uint16_t> m_entitySlots;
+	std::vector<uint32_t> m_freeEntityIndexes;
+
+	// Indexed by ComponentTypeID.
+	std::vector<std::unique_ptr<IComponentsStorage>> m_componentsLib;
+	ComponentSignatureTable m_signatureTable;
+
+	std::vector<DestroyCallback> m_destroyCallbacks;
 };
 
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Profiler.h"
+#include "ECWorld/SceneWorld.h"
 #include "ImGui/IconFont/IconsMaterialDesignIcons.h"
+#include "Rendering/RenderContext.h"
 
 #include <bgfx/bgfx.h>
 #include <bx/string.h>
@@ -72,6 +74,7 @@ void Profiler::Update()
     static bool showFrameTime = true;
     static bool showViewStats = true;
     static bool showGPUMemory = true;
+    static bool showCulling = true;
 
     // title
     ImGui::Text("Stats");
@@ -88,6 +91,21 @@ void Profiler::Update()
     ImGui::Text("Triangles: %u", stats->numPrims[bgfx::Topology::TriList]);
     ImGui::Text("Draw calls: %u", stats->numDraw);
     ImGui::Text("Compute calls: %u", stats->numCompute);
+    if (const RenderContext* pRenderContext = GetRenderContext())
+    {
+        ImGui::Text("State changes: %u", pRenderContext->GetStateChangeCount());
+    }
+
+    if (showCulling)
+    {
+        if (const SceneWorld* pSceneWorld = GetSceneWorld())
+        {
+            const CullingSystem* pCullingSystem = pSceneWorld->GetCullingSystem();
+            ImGui::Separator();
+            ImGui::Text("Visible entities: %zu", pCullingSystem->GetVisibleCount());
+            ImGui::Text("Culled entities: %zu", pCullingSystem->GetCulledCount());
+        }
+    }
 
     // plots
     static constexpr size_t GRAPH_HISTORY = 100;
@@ -235,6 +253,7 @@ void Profiler::Update()
         ImGui::Checkbox("Frame time", &showFrameTime);
         ImGui::Checkbox("View stats", &showViewStats);
         ImGui::Checkbox("GPU memory", &showGPUMemory);
+        ImGui::Checkbox("Culling", &showCulling);
         ImGui::EndPopup();
     }
     ImGui::End();
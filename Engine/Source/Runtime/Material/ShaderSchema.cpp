@@ -43,6 +43,11 @@ ShaderSchema::ShaderSchema(std::string vsPath, std::string fsPath)
 	m_isDirty = false;
 }
 
+void ShaderSchema::SetInstanceVertexShaderPath(std::string vsPath)
+{
+	m_instanceVertexShaderPath = cd::MoveTemp(vsPath);
+}
+
 void ShaderSchema::AddFeatureSet(ShaderFeatureSet featureSet)
 {
 	for (const auto& existingFeatureSet : m_shaderFeatureSets)
@@ -118,6 +123,7 @@ void ShaderSchema::CleanBuild()
 {
 	m_featureCombines.clear();
 	m_compiledProgramHandles.clear();
+	m_compiledInstanceProgramHandles.clear();
 	m_isDirty = true;
 }
 
@@ -156,6 +162,18 @@ uint16_t ShaderSchema::GetCompiledProgram(StringCrc shaderFeaturesCrc) const
 	return programHandle;
 }
 
+void ShaderSchema::SetCompiledInstanceProgram(StringCrc shaderFeaturesCrc, uint16_t programHandle)
+{
+	assert(IsFeaturesValid(shaderFeaturesCrc));
+	m_compiledInstanceProgramHandles[shaderFeaturesCrc.Value()] = programHandle;
+}
+
+uint16_t ShaderSchema::GetCompiledInstanceProgram(StringCrc shaderFeaturesCrc) const
+{
+	auto itProgram = m_compiledInstanceProgramHandles.find(shaderFeaturesCrc.Value());
+	return itProgram != m_compiledInstanceProgramHandles.end() ? itProgram->second : InvalidProgramHandle;
+}
+
 StringCrc ShaderSchema::GetFeaturesCrc(const ShaderFeatureSet& featureSet) const
 {
 	if (m_shaderFeatureSets.empty() || featureSet.empty())
@@ -196,6 +214,16 @@ void ShaderSchema::AddUberVSBlob(ShaderBlob shaderBlob)
 	m_pVSBlob = std::make_unique<ShaderBlob>(cd::MoveTemp(shaderBlob));
 }
 
+void ShaderSchema::AddInstanceVSBlob(ShaderBlob shaderBlob)
+{
+	if (m_pInstanceVSBlob)
+	{
+		return;
+	}
+
+	m_pInstanceVSBlob = std::make_unique<ShaderBlob>(cd::MoveTemp(shaderBlob));
+}
+
 void ShaderSchema::AddUberFSBlob(StringCrc shaderFeaturesCrc, ShaderBlob shaderBlob)
 {
 	if (m_shaderFeaturesToFSBlobs.find(shaderFeaturesCrc.Value()) != m_shaderFeaturesToFSBlobs.end())
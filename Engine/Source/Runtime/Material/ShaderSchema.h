@@ -62,6 +62,11 @@ public:
 	const char* GetVertexShaderPath() const { return m_vertexShaderPath.c_str(); }
 	const char* GetFragmentShaderPath() const { return m_fragmentShaderPath.c_str(); }
 
+	// Optional vertex shader which reads world matrices from instance data. It links with every fragment shader variant.
+	void SetInstanceVertexShaderPath(std::string vsPath);
+	const char* GetInstanceVertexShaderPath() const { return m_instanceVertexShaderPath.c_str(); }
+	bool HasInstanceVertexShader() const { return !m_instanceVertexShaderPath.empty(); }
+
 	void AddFeatureSet(ShaderFeatureSet featureSet);
 
 	// Calling "AddFeatureSet/SetConflictOptions and Build" after Build will cause unnecessary performance overhead.
@@ -72,6 +77,10 @@ public:
 	void SetCompiledProgram(StringCrc shaderFeaturesCrc, uint16_t programHandle);
 	uint16_t GetCompiledProgram(StringCrc shaderFeaturesCrc) const;
 
+	void SetCompiledInstanceProgram(StringCrc shaderFeaturesCrc, uint16_t programHandle);
+	// Returns InvalidProgramHandle if the instance vertex shader is not used or not compiled.
+	uint16_t GetCompiledInstanceProgram(StringCrc shaderFeaturesCrc) const;
+
 	StringCrc GetFeaturesCrc(const ShaderFeatureSet& featureSet) const;
 	bool IsFeaturesValid(StringCrc shaderFeaturesCrc) const;
 
@@ -85,11 +94,14 @@ public:
 	void AddUberVSBlob(ShaderBlob shaderBlob);
 	void AddUberFSBlob(StringCrc shaderFeaturesCrc, ShaderBlob shaderBlob);
 	const ShaderBlob& GetVSBlob() const { return *m_pVSBlob.get(); }
+	void AddInstanceVSBlob(ShaderBlob shaderBlob);
+	const ShaderBlob& GetInstanceVSBlob() const { return *m_pInstanceVSBlob.get(); }
 	const ShaderBlob& GetFSBlob(StringCrc shaderFeaturesCrc) const;
 
 private:
 	std::string m_vertexShaderPath;
 	std::string m_fragmentShaderPath;
+	std::string m_instanceVertexShaderPath;
 
 	bool m_isDirty = false;
 	// Adding order of shaer features.
@@ -99,8 +111,10 @@ private:
 
 	// Key: StringCrc(feature combine), Value: shader handle.
 	std::map<uint32_t, uint16_t> m_compiledProgramHandles;
+	std::map<uint32_t, uint16_t> m_compiledInstanceProgramHandles;
 
 	std::unique_ptr<ShaderBlob> m_pVSBlob;
+	std::unique_ptr<ShaderBlob> m_pInstanceVSBlob;
 	std::map<uint32_t, std::unique_ptr<ShaderBlob>> m_shaderFeaturesToFSBlobs;
 };
 
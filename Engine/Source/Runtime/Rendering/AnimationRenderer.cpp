@@ -4,133 +4,23 @@
 #include "ECWorld/SceneWorld.h"
 #include "ECWorld/StaticMeshComponent.h"
 #include "ECWorld/TransformComponent.h"
+#include "Log/Log.h"
 #include "RenderContext.h"
 #include "Scene/Texture.h"
+#include "U_Animation.sh"
 
-#include <cmath>
+#include <algorithm>
 //#include <format>
 
 namespace engine
 {
 
-namespace details
+AnimationRenderer::~AnimationRenderer()
 {
-
-float CustomFModf(float dividend, float divisor)
-{
-	if (divisor == 0.0f)
-		return 0.0f;
-
-	int quotient = static_cast<int>(dividend / divisor);
-	float result = dividend - static_cast<float>(quotient) * divisor;
-
-	// Handle potential precision issues near zero
-	if (result == 0.0f && dividend != 0.0f)
-		result = 0.0f;
-
-	// Ensure the result has the same sign as the divisor
-	if ((dividend < 0 && divisor > 0) || (dividend > 0 && divisor < 0))
-		result = -result;
-
-	return result;
-}
-
-void CalculateBoneTransform(std::vector<cd::Matrix4x4>& boneMatrices, const cd::SceneDatabase* pSceneDatabase,
-	float animationTime, const cd::Bone& bone, const cd::Matrix4x4& parentBoneTransform, const cd::Matrix4x4& globalInverse)
-{
-	auto CalculateInterpolatedTranslation = [&animationTime](const cd::Track* pTrack) -> cd::Vec3f
-	{
-		if (1U == pTrack->GetTranslationKeyCount())
-		{
-			const auto& firstKey = pTrack->GetTranslationKeys()[0];
-			return firstKey.GetValue();
-		}
-
-		for (uint32_t keyIndex = 0U; keyIndex < pTrack->GetTranslationKeyCount() - 1; ++keyIndex)
-		{
-			const auto& nextKey = pTrack->GetTranslationKeys()[keyIndex + 1];
-			if (animationTime < nextKey.GetTime())
-			{
-				const auto& currentKey = pTrack->GetTranslationKeys()[keyIndex];
-				float keyFrameDeltaTime = nextKey.GetTime() - currentKey.GetTime();
-				float keyFrameRate = (animationTime - currentKey.GetTime()) / keyFrameDeltaTime;
-				assert(keyFrameRate >= 0.0f && keyFrameRate <= 1.0f);
-
-				return cd::Vec3f::Lerp(currentKey.GetValue(), nextKey.GetValue(), keyFrameRate);
-			}
-		}
-
-		return cd::Vec3f::Zero();
-	};
-
-	auto CalculateInterpolatedRotation = [&animationTime](const cd::Track* pTrack) -> cd::Quaternion
-	{
-		if (1U == pTrack->GetRotationKeyCount())
-		{
-			const auto& firstKey = pTrack->GetRotationKeys()[0];
-			return firstKey.GetValue();
-		}
-
-		for (uint32_t keyIndex = 0U; keyIndex < pTrack->GetRotationKeyCount() - 1; ++keyIndex)
-		{
-			const auto& nextKey = pTrack->GetRotationKeys()[keyIndex + 1];
-			if (animationTime < nextKey.GetTime())
-			{
-				const auto& currentKey = pTrack->GetRotationKeys()[keyIndex];
-				float keyFrameDeltaTime = nextKey.GetTime() - currentKey.GetTime();
-				float keyFrameRate = (animationTime - currentKey.GetTime()) / keyFrameDeltaTime;
-				assert(keyFrameRate >= 0.0f && keyFrameRate <= 1.0f);
-
-				return cd::Quaternion::Lerp(currentKey.GetValue(), nextKey.GetValue(), keyFrameRate).Normalize();
-			}
-		}
-
-		return cd::Quaternion::Identity();
-	};
-
-	auto CalculateInterpolatedScale = [&animationTime](const cd::Track* pTrack) -> cd::Vec3f
-	{
-		if (1U == pTrack->GetScaleKeyCount())
-		{
-			const auto& firstKey = pTrack->GetScaleKeys()[0];
-			return firstKey.GetValue();
-		}
-
-		for (uint32_t keyIndex = 0U; keyIndex < pTrack->GetScaleKeyCount() - 1; ++keyIndex)
-		{
-			const auto& nextKey = pTrack->GetScaleKeys()[keyIndex + 1];
-			if (animationTime < nextKey.GetTime())
-			{
-				const auto& currentKey = pTrack->GetScaleKeys()[keyIndex];
-				float keyFrameDeltaTime = nextKey.GetTime() - currentKey.GetTime();
-				float keyFrameRate = (animationTime - currentKey.GetTime()) / keyFrameDeltaTime;
-				assert(keyFrameRate >= 0.0f && keyFrameRate <= 1.0f);
-
-				return cd::Vec3f::Lerp(currentKey.GetValue(), nextKey.GetValue(), keyFrameRate);
-			}
-		}
-
-		return cd::Vec3f::One();
-	};
-
-	cd::Matrix4x4 boneLocalTransform = bone.GetTransform().GetMatrix();
-	if (const cd::Track* pTrack = pSceneDatabase->GetTrackByName(bone.GetName()))
-	{
-		boneLocalTransform = cd::Transform(CalculateInterpolatedTranslation(pTrack),
-									  CalculateInterpolatedRotation(pTrack),
-									  CalculateInterpolatedScale(pTrack)).GetMatrix();
-	}
-
-	cd::Matrix4x4 globalTransform = parentBoneTransform * boneLocalTransform;
-	boneMatrices[bone.GetID().Data()] = globalInverse * globalTransform * bone.GetOffset();
-
-	for (cd::BoneID boneID : bone.GetChildIDs())
+	if (bgfx::isValid(m_bonePaletteTexture))
 	{
-		const cd::Bone& childBone = pSceneDatabase->GetBone(boneID.Data());
-		CalculateBoneTransform(boneMatrices, pSceneDatabase, animationTime, childBone, globalTransform, globalInverse);
+		bgfx::destroy(m_bonePaletteTexture);
 	}
-};
-
 }
 
 void AnimationRenderer::Init()
@@ -142,6 +32,9 @@ void AnimationRenderer::Init()
 	GetRenderContext()->CreateProgram("AnimationProgram", "vs_animation.bin", "fs_animation.bin");
 #endif
 
+	m_bonePaletteSampler = GetRenderContext()->CreateUniform("s_texBonePalette", bgfx::UniformType::Sampler);
+	m_bonePaletteUniform = GetRenderContext()->CreateUniform("u_bonePalette", bgfx::UniformType::Vec4, 1);
+
 	bgfx::setViewName(GetViewID(), "AnimationRenderer");
 }
 
@@ -172,48 +65,93 @@ void AnimationRenderer::Render(float deltaTime)
 	bgfx::setUniform(m_pRenderContext->GetUniform(boneIndexUniform), selectedBoneIndex, 1);
 #endif
 
-	static float animationRunningTime = 0.0f;
-	animationRunningTime += deltaTime;
+	m_draws.clear();
+	m_bonePaletteData.clear();
 
-	const cd::SceneDatabase* pSceneDatabase = m_pCurrentSceneWorld->GetSceneDatabase();
-	for (Entity entity : m_pCurrentSceneWorld->GetAnimationEntities())
+	auto animationView = m_pCurrentSceneWorld->GetWorld()->View<AnimationComponent, StaticMeshComponent, TransformComponent>();
+	const CullingSystem* pCullingSystem = m_pCurrentSceneWorld->GetCullingSystem();
+	animationView.Each([&](Entity entity, AnimationComponent& animationComponent, StaticMeshComponent& meshComponent, TransformComponent& transformComponent)
 	{
-		StaticMeshComponent* pMeshComponent = m_pCurrentSceneWorld->GetStaticMeshComponent(entity);
-		if (!pMeshComponent)
+		// Bone matrices are evaluated by AnimationSystem for visible entities.
+		if (!pCullingSystem->IsVisible(entity) || !animationComponent.GetSampler().IsValid())
 		{
-			continue;
+			return;
 		}
 
-		TransformComponent* pTransformComponent = m_pCurrentSceneWorld->GetTransformComponent(entity);
-		bgfx::setTransform(pTransformComponent->GetWorldMatrix().Begin());
+		uint32_t firstTexel = static_cast<uint32_t>(m_bonePaletteData.size() / 4U);
+		for (const cd::Matrix4x4& boneMatrix : animationComponent.GetBoneMatrices())
+		{
+			// Store the first three rows. Element (row, column) of the matrix is at [column * 4 + row],
+			// which is the same layout a mat4 uniform is read with.
+			const float* pData = boneMatrix.Begin();
+			for (uint32_t row = 0U; row < 3U; ++row)
+			{
+				m_bonePaletteData.insert(m_bonePaletteData.end(), { pData[row], pData[4 + row], pData[8 + row], pData[12 + row] });
+			}
+		}
+		m_draws.push_back(AnimationDraw{ &meshComponent, &transformComponent, firstTexel });
+	});
 
-		AnimationComponent* pAnimationComponent = m_pCurrentSceneWorld->GetAnimationComponent(entity);
+	if (m_draws.empty() || !UpdateBonePaletteTexture(static_cast<uint32_t>(m_bonePaletteData.size() / 4U)))
+	{
+		return;
+	}
 
-		const cd::Animation* pAnimation = pAnimationComponent->GetAnimationData();
-		float ticksPerSecond = pAnimation->GetTicksPerSecnod();
-		assert(ticksPerSecond > 1.0f);
-		float animationTime = details::CustomFModf(animationRunningTime * ticksPerSecond, pAnimation->GetDuration());
+	constexpr StringCrc animationProgram("AnimationProgram");
+	bgfx::ProgramHandle programHandle = GetRenderContext()->GetProgram(animationProgram);
+	for (const AnimationDraw& draw : m_draws)
+	{
+		bgfx::setTransform(draw.pTransformComponent->GetWorldMatrix().Begin());
 
-		static std::vector<cd::Matrix4x4> boneMatrices;
-		boneMatrices.clear();
-		for (uint16_t boneIndex = 0; boneIndex < 128; ++boneIndex)
-		{
-			boneMatrices.push_back(cd::Matrix4x4::Identity());
-		}
+		float bonePalette[4] = { static_cast<float>(draw.firstTexel), 1.0f / BONE_PALETTE_TEXTURE_WIDTH, 1.0f / m_bonePaletteHeight, 0.0f };
+		bgfx::setUniform(m_bonePaletteUniform, bonePalette, 1);
+		bgfx::setTexture(BONE_PALETTE_MAP_SLOT, m_bonePaletteSampler, m_bonePaletteTexture);
 
-		const cd::Bone& rootBone = pSceneDatabase->GetBone(0);
-		details::CalculateBoneTransform(boneMatrices, pSceneDatabase, animationTime, rootBone,
-			cd::Matrix4x4::Identity(), pTransformComponent->GetWorldMatrix().Inverse());
-		bgfx::setUniform(bgfx::UniformHandle{pAnimationComponent->GetBoneMatrixsUniform()}, boneMatrices.data(), static_cast<uint16_t>(boneMatrices.size()));
-		bgfx::setVertexBuffer(0, bgfx::VertexBufferHandle{pMeshComponent->GetVertexBuffer()});
-		bgfx::setIndexBuffer(bgfx::IndexBufferHandle{pMeshComponent->GetIndexBuffer()});
+		bgfx::setVertexBuffer(0, bgfx::VertexBufferHandle{draw.pMeshComponent->GetVertexBuffer()});
+		bgfx::setIndexBuffer(bgfx::IndexBufferHandle{draw.pMeshComponent->GetIndexBuffer()});
 
 		constexpr uint64_t state = BGFX_STATE_WRITE_MASK | BGFX_STATE_CULL_CCW | BGFX_STATE_MSAA | BGFX_STATE_DEPTH_TEST_LESS;
 		bgfx::setState(state);
 
-		constexpr StringCrc animationProgram("AnimationProgram");
-		bgfx::submit(GetViewID(), GetRenderContext()->GetProgram(animationProgram));
+		bgfx::submit(GetViewID(), programHandle);
+	}
+}
+
+bool AnimationRenderer::UpdateBonePaletteTexture(uint32_t texelCount)
+{
+	uint32_t rowCount = (texelCount + BONE_PALETTE_TEXTURE_WIDTH - 1U) / BONE_PALETTE_TEXTURE_WIDTH;
+	if (rowCount > m_bonePaletteHeight)
+	{
+		uint32_t maxHeight = bgfx::getCaps()->limits.maxTextureSize;
+		if (rowCount > maxHeight)
+		{
+			CD_ENGINE_WARN("Too many bone matrices to fit in the bone palette texture!");
+			return false;
+		}
+
+		// Grow in powers of two so that a growing crowd doesn't recreate the texture every frame.
+		uint32_t height = 16U;
+		while (height < rowCount)
+		{
+			height *= 2U;
+		}
+		height = std::min(height, maxHeight);
+
+		if (bgfx::isValid(m_bonePaletteTexture))
+		{
+			bgfx::destroy(m_bonePaletteTexture);
+		}
+		m_bonePaletteTexture = bgfx::createTexture2D(BONE_PALETTE_TEXTURE_WIDTH, static_cast<uint16_t>(height), false, 1,
+			bgfx::TextureFormat::RGBA32F, BGFX_SAMPLER_POINT | BGFX_SAMPLER_UVW_CLAMP);
+		m_bonePaletteHeight = static_cast<uint16_t>(height);
 	}
+
+	// Only whole rows are uploaded, pad the last one.
+	m_bonePaletteData.resize(static_cast<size_t>(rowCount) * BONE_PALETTE_TEXTURE_WIDTH * 4U, 0.0f);
+	bgfx::updateTexture2D(m_bonePaletteTexture, 0, 0, 0, 0, BONE_PALETTE_TEXTURE_WIDTH, static_cast<uint16_t>(rowCount),
+		bgfx::copy(m_bonePaletteData.data(), static_cast<uint32_t>(m_bonePaletteData.size() * sizeof(float))));
+
+	return true;
 }
 
 }
\ No newline at end of file
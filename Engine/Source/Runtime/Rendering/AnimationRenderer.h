@@ -2,17 +2,25 @@
 
 #include "Renderer.h"
 
+#include <bgfx/bgfx.h>
+
 #include <vector>
 
 namespace engine
 {
 
 class SceneWorld;
+class StaticMeshComponent;
+class TransformComponent;
 
+// AnimationRenderer draws skin meshes with bone matrices evaluated by AnimationSystem.
+// Bone matrices of all drawn characters are packed as 3x4 matrices into one texture which is updated once per frame.
+// A draw only sets the offset of its matrices in the texture, so skeletons have no bone count limit.
 class AnimationRenderer final : public Renderer
 {
 public:
 	using Renderer::Renderer;
+	virtual ~AnimationRenderer();
 
 	virtual void Init() override;
 	virtual void UpdateView(const float* pViewMatrix, const float* pProjectionMatrix) override;
@@ -20,8 +28,30 @@ public:
 
 	void SetSceneWorld(SceneWorld* pSceneWorld) { m_pCurrentSceneWorld = pSceneWorld; }
 
+private:
+	struct AnimationDraw
+	{
+		const StaticMeshComponent* pMeshComponent;
+		const TransformComponent* pTransformComponent;
+		uint32_t firstTexel;
+	};
+
+	// Returns false if the texture can't hold texelCount texels.
+	bool UpdateBonePaletteTexture(uint32_t texelCount);
+
 private:
 	SceneWorld* m_pCurrentSceneWorld = nullptr;
+
+	// Resolved once in Init.
+	bgfx::UniformHandle m_bonePaletteSampler = BGFX_INVALID_HANDLE;
+	bgfx::UniformHandle m_bonePaletteUniform = BGFX_INVALID_HANDLE;
+
+	bgfx::TextureHandle m_bonePaletteTexture = BGFX_INVALID_HANDLE;
+	uint16_t m_bonePaletteHeight = 0;
+
+	// Rows of bone matrices drawn in this frame, 4 floats per texel.
+	std::vector<float> m_bonePaletteData;
+	std::vector<AnimationDraw> m_draws;
 };
 
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "MaterialDrawPacket.h"
 #include "Renderer.h"
 
 namespace engine
@@ -20,6 +21,10 @@ public:
 
 private:
 	SceneWorld* m_pCurrentSceneWorld = nullptr;
+
+	// Handles resolved once, or again when a material version changes.
+	MaterialUniforms m_materialUniforms;
+	MaterialDrawPacketCache m_drawPackets;
 };
 
 }
\ No newline at end of file
@@ -23,7 +23,6 @@ namespace engine
 
 		for (int i = 0; i < TEX_CHAIN_LEN; i++) m_sampleChainFB[i] = BGFX_INVALID_HANDLE;
 		for (int i = 0; i < 2; i++) m_blurChainFB[i] = BGFX_INVALID_HANDLE;
-		m_combineFB = BGFX_INVALID_HANDLE;
 
 		start_dowmSamplePassID = GetRenderContext()->CreateView();
 		for (int i = 0; i < TEX_CHAIN_LEN - 2; i++) GetRenderContext()->CreateView();
@@ -33,11 +32,27 @@ namespace engine
 		start_upSamplePassID = GetRenderContext()->CreateView();
 		for (int i = 0; i < TEX_CHAIN_LEN - 2; i++) GetRenderContext()->CreateView();
 		combinePassID = GetRenderContext()->CreateView();
-		blit_colorPassID = GetRenderContext()->CreateView();
 	}
 
 	BloomRenderer::~BloomRenderer()
 	{
+		ReleaseFrameBuffers();
+	}
+
+	void BloomRenderer::ReleaseFrameBuffers()
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			GetRenderContext()->ReleaseFrameBuffer(m_blurChainFB[i]);
+			m_blurChainFB[i] = BGFX_INVALID_HANDLE;
+		}
+	}
+
+	void BloomRenderer::OnCulled()
+	{
+		// Disabled bloom keeps nothing, so the pool destroys the blur chain after a few frames.
+		// The render graph releases the sample chain itself.
+		ReleaseFrameBuffers();
 	}
 
 	void BloomRenderer::SetEnable(bool value)
@@ -70,19 +85,13 @@ namespace engine
 			tempH = GetRenderContext()->GetBackBufferHeight();
 		}
 
-		if (width != tempW || height != tempH) {
-			width = tempW;
-			height = tempH;
-
-			const uint64_t tsFlags = 0 | BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
-			for (int ii = 0; ii < TEX_CHAIN_LEN; ++ii) 
-			{
-				if (bgfx::isValid(m_sampleChainFB[ii])) bgfx::destroy(m_sampleChainFB[ii]);
-				if ((height >> ii) < 2 || (width >> ii) < 2) break;
-				m_sampleChainFB[ii] = bgfx::createFrameBuffer(width >> ii, height >> ii, bgfx::TextureFormat::RGBA32F, tsFlags);
-			}
+		width = tempW;
+		height = tempH;
 
-			m_combineFB = bgfx::createFrameBuffer(width, height, bgfx::TextureFormat::RGBA32F, tsFlags);
+		// The render graph resizes the sample chain with the scene render target.
+		for (int i = 0; i < TEX_CHAIN_LEN; i++)
+		{
+			m_sampleChainFB[i] = GetRenderContext()->GetFrameBuffer(SampleChainNames[i]);
 		}
 	}
 
@@ -93,21 +102,10 @@ namespace engine
 		const RenderTarget* pInputRT = GetRenderContext()->GetRenderTarget(sceneRenderTarget);
 		const RenderTarget* pOutputRT = GetRenderTarget();
 
-		bgfx::TextureHandle screenEmissColorTextureHandle;
-		bgfx::TextureHandle screenTextureHandle;
-		if (pInputRT == pOutputRT)
-		{
-			constexpr StringCrc sceneRenderTargetBlitSRV("SceneRenderTargetBlitSRV");
-			screenTextureHandle = GetRenderContext()->GetTexture(sceneRenderTargetBlitSRV);
-
-			constexpr StringCrc sceneRenderTargetBlitEmissColor("SceneRenderTargetBlitEmissColor");
-			screenEmissColorTextureHandle = GetRenderContext()->GetTexture(sceneRenderTargetBlitEmissColor);
-		}
-		else
-		{
-			screenTextureHandle = pInputRT->GetTextureHandle(0);
-			screenEmissColorTextureHandle = pInputRT->GetTextureHandle(1);
-		}
+		// Bloom chain passes draw to their own frame buffers and the combine pass only draws to a scene color,
+		// so scene attachments are sampled without copies.
+		bgfx::TextureHandle screenTextureHandle = pInputRT->GetTextureHandle(0);
+		bgfx::TextureHandle screenEmissColorTextureHandle = pInputRT->GetTextureHandle(1);
 
 		Entity entity = m_pCurrentSceneWorld->GetMainCameraEntity();
 		CameraComponent* pCameraComponent = m_pCurrentSceneWorld->GetCameraComponent(entity);
@@ -205,7 +203,15 @@ namespace engine
 		}
 
 		// combine 
-		bgfx::setViewFrameBuffer(combinePassID, m_combineFB);
+		if (pInputRT == pOutputRT)
+		{
+			// Draw to the other color of the scene render target.
+			screenTextureHandle = SwapViewRenderTargetColor(combinePassID);
+		}
+		else
+		{
+			bgfx::setViewFrameBuffer(combinePassID, pOutputRT ? *pOutputRT->GetFrameBufferHandle() : bgfx::FrameBufferHandle{bgfx::kInvalidHandle});
+		}
 		bgfx::setViewRect(combinePassID, 0, 0, width, height);
 		bgfx::setViewTransform(combinePassID, nullptr, orthoMatrix.Begin());
 
@@ -220,8 +226,6 @@ namespace engine
 
 		constexpr StringCrc CombineprogramName("CombineProgram");
 		bgfx::submit(combinePassID, GetRenderContext()->GetProgram(CombineprogramName));
-
-		bgfx::blit(blit_colorPassID, screenTextureHandle, 0, 0, bgfx::getTexture(m_combineFB));
 	}
 
 	void BloomRenderer::Blur(uint16_t width, uint16_t height, int iteration,float blursize, int blurscaling,cd::Matrix4x4 ortho,bgfx::TextureHandle texture)
@@ -229,11 +233,11 @@ namespace engine
 		width = static_cast<int>(width / blurscaling);
 		height = static_cast<int>(height / blurscaling);
 
-		const uint64_t tsFlags = 0 | BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
 		for (int ii = 0; ii < 2; ++ii)
 		{
-			if (bgfx::isValid(m_blurChainFB[ii])) bgfx::destroy(m_blurChainFB[ii]);
-			m_blurChainFB[ii] = bgfx::createFrameBuffer(width, height, bgfx::TextureFormat::RGBA32F, tsFlags);
+			// Released and acquired every frame, the pool gives back the same frame buffers while the size is the same.
+			GetRenderContext()->ReleaseFrameBuffer(m_blurChainFB[ii]);
+			m_blurChainFB[ii] = GetRenderContext()->AcquireFrameBuffer(width, height, BloomChainFormat, BloomChainFlags);
 		}
 
 		uint16_t vertical = start_verticalBlurPassID;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Core/StringCrc.h"
 #include "ECWorld/SceneWorld.h"
 #include "Renderer.h"
 #include<bgfx/bgfx.h>
@@ -22,26 +23,44 @@ namespace engine
 
 		virtual void SetEnable(bool value) override;
 		virtual bool IsEnable() const override;
+		virtual void OnCulled() override;
 
 		void SetSceneWorld(SceneWorld* pSceneWorld) { m_pCurrentSceneWorld = pSceneWorld; }
 
+		// Bloom only needs HDR colors without alpha.
+		static constexpr bgfx::TextureFormat::Enum BloomChainFormat = bgfx::TextureFormat::RG11B10F;
+		static constexpr uint64_t BloomChainFlags = BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
+
+		// The sample chain is made of render graph frame buffers written by bloom, level i has 1/2^i of the scene size.
+		static constexpr StringCrc SampleChainNames[TEX_CHAIN_LEN] =
+		{
+			StringCrc("BloomSampleChain0"),
+			StringCrc("BloomSampleChain1"),
+			StringCrc("BloomSampleChain2"),
+			StringCrc("BloomSampleChain3"),
+			StringCrc("BloomSampleChain4"),
+			StringCrc("BloomSampleChain5"),
+			StringCrc("BloomSampleChain6"),
+			StringCrc("BloomSampleChain7"),
+			StringCrc("BloomSampleChain8"),
+		};
+
 	private:
+		void ReleaseFrameBuffers();
 		void Blur(uint16_t width , uint16_t height,int iteration, float blursize, int blurscaling,cd::Matrix4x4 ortho, bgfx::TextureHandle texture);
 
 		SceneWorld* m_pCurrentSceneWorld = nullptr;
 
 		bgfx::FrameBufferHandle m_blurChainFB[2];
 		bgfx::FrameBufferHandle m_sampleChainFB[TEX_CHAIN_LEN];
-		bgfx::FrameBufferHandle m_combineFB;
 
-		uint16_t width;
-		uint16_t height;
+		uint16_t width = 0;
+		uint16_t height = 0;
 
 		uint16_t start_dowmSamplePassID;
 		uint16_t start_verticalBlurPassID;
 		uint16_t start_horizontalBlurPassID;
 		uint16_t start_upSamplePassID;
-		uint16_t blit_colorPassID;
 		uint16_t combinePassID;
 	};
 
@@ -29,9 +29,6 @@ constexpr const char* volumeProbeCounts      = "u_volumeProbeCounts";
 constexpr const char* ambientMultiplier      = "u_ambientMultiplier";
 constexpr const char* normalAndViewBias      = "u_normalAndViewBias";
 
-constexpr const char* lightCountAndStride    = "u_lightCountAndStride";
-constexpr const char* lightParams            = "u_lightParams";
-constexpr const char* cameraPos              = "u_cameraPos";
 constexpr const char* albedoColor            = "u_albedoColor";
 constexpr const char* albedoUVOffsetAndScale = "u_albedoUVOffsetAndScale";
 
@@ -167,9 +164,6 @@ void DDGIRenderer::Init()
 	GetRenderContext()->CreateUniform(ambientMultiplier, bgfx::UniformType::Vec4, 1);
 	GetRenderContext()->CreateUniform(normalAndViewBias, bgfx::UniformType::Vec4, 1);
 
-	GetRenderContext()->CreateUniform(lightCountAndStride, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(lightParams, bgfx::UniformType::Vec4, LightUniform::VEC4_COUNT);
-	GetRenderContext()->CreateUniform(cameraPos, bgfx::UniformType::Vec4, 1);
 	GetRenderContext()->CreateUniform(albedoColor, bgfx::UniformType::Vec4, 1);
 	GetRenderContext()->CreateUniform(albedoUVOffsetAndScale, bgfx::UniformType::Vec4, 1);
 
@@ -204,8 +198,10 @@ void DDGIRenderer::UpdateView(const float* pViewMatrix, const float* pProjection
 
 void DDGIRenderer::Render(float deltaTime)
 {
+	// Camera and light uniforms are shared by all draws.
+	GetRenderContext()->GetFrameConstants().Submit();
+
 	const engine::CameraComponent *pCameraComponent = m_pCurrentSceneWorld->GetCameraComponent(m_pCurrentSceneWorld->GetMainCameraEntity());
-	const engine::TransformComponent* pCameraTransformComponent = m_pCurrentSceneWorld->GetTransformComponent(m_pCurrentSceneWorld->GetMainCameraEntity());
 
 	for(Entity entity : m_pCurrentSceneWorld->GetMaterialEntities())
 	{
@@ -250,21 +246,6 @@ void DDGIRenderer::Render(float deltaTime)
 		cd::Vec3f tmpAlbedoColor = cd::Vec3f(1.0f, 1.0f, 1.0f);
 		GetRenderContext()->FillUniform(StringCrc(albedoColor), tmpAlbedoColor.Begin(), 1);
 
-		GetRenderContext()->FillUniform(StringCrc(cameraPos), &pCameraTransformComponent->GetTransform().GetTranslation().x(), 1);
-
-		auto lightEntities = m_pCurrentSceneWorld->GetLightEntities();
-		size_t lightEntityCount = lightEntities.size();
-		static cd::Vec4f lightInfoData(0.0f, LightUniform::LIGHT_STRIDE, 0.0f, 0.0f);
-		lightInfoData.x() = static_cast<float>(lightEntityCount);
-		GetRenderContext()->FillUniform(StringCrc(lightCountAndStride), lightInfoData.Begin(), 1);
-
-		if (lightEntityCount > 0)
-		{
-			// Light component storage has continus memory address and layout.
-			float *pLightDataBegin = reinterpret_cast<float *>(m_pCurrentSceneWorld->GetLightComponent(lightEntities[0]));
-			GetRenderContext()->FillUniform(StringCrc(lightParams), pLightDataBegin, static_cast<uint16_t>(lightEntityCount * LightUniform::LIGHT_STRIDE));
-		}
-
 		GetRenderContext()->FillUniform(StringCrc(volumeOrigin), &m_pDDGIComponent->GetVolumeOrigin().x(), 1);
 		GetRenderContext()->FillUniform(StringCrc(volumeProbeSpacing), &m_pDDGIComponent->GetProbeSpacing().x(), 1);
 		GetRenderContext()->FillUniform(StringCrc(volumeProbeCounts), &m_pDDGIComponent->GetProbeCount().x(), 1);
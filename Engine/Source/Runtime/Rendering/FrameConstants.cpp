@@ -0,0 +1,161 @@
+#include "FrameConstants.h"
+
+#include "ECWorld/LightComponent.h"
+#include "ECWorld/SceneWorld.h"
+#include "ECWorld/SkyComponent.h"
+#include "ECWorld/TransformComponent.h"
+#include "LightUniforms.h"
+#include "RenderContext.h"
+#include "U_AtmophericScattering.sh"
+#include "U_IBL.sh"
+
+#include <algorithm>
+#include <cstring>
+
+namespace engine
+{
+
+namespace
+{
+
+constexpr const char* cameraPos                   = "u_cameraPos";
+constexpr const char* lightCountAndStride         = "u_lightCountAndStride";
+constexpr const char* lightParams                 = "u_lightParams";
+constexpr const char* LightDir                    = "u_LightDir";
+constexpr const char* HeightOffsetAndshadowLength = "u_HeightOffsetAndshadowLength";
+
+constexpr const char* lutSampler                  = "s_texLUT";
+constexpr const char* cubeIrradianceSampler       = "s_texCubeIrr";
+constexpr const char* cubeRadianceSampler         = "s_texCubeRad";
+
+constexpr const char* lutTexture                  = "Textures/lut/ibl_brdf_lut.dds";
+
+constexpr uint64_t samplerFlags = BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP | BGFX_SAMPLER_W_CLAMP;
+
+}
+
+void FrameConstants::Init(RenderContext* pRenderContext)
+{
+	m_pRenderContext = pRenderContext;
+
+	m_cameraPosUniform = m_pRenderContext->CreateUniform(cameraPos, bgfx::UniformType::Vec4, 1);
+	m_lightCountAndStrideUniform = m_pRenderContext->CreateUniform(lightCountAndStride, bgfx::UniformType::Vec4, 1);
+	m_lightParamsUniform = m_pRenderContext->CreateUniform(lightParams, bgfx::UniformType::Vec4, LightUniform::VEC4_COUNT);
+	m_lightDirUniform = m_pRenderContext->CreateUniform(LightDir, bgfx::UniformType::Vec4, 1);
+	m_heightOffsetAndShadowLengthUniform = m_pRenderContext->CreateUniform(HeightOffsetAndshadowLength, bgfx::UniformType::Vec4, 1);
+
+	m_lightParameters.resize(LightUniform::VEC4_COUNT, cd::Vec4f::Zero());
+
+	m_lutSampler = m_pRenderContext->CreateUniform(lutSampler, bgfx::UniformType::Sampler);
+	m_irradianceSampler = m_pRenderContext->CreateUniform(cubeIrradianceSampler, bgfx::UniformType::Sampler);
+	m_radianceSampler = m_pRenderContext->CreateUniform(cubeRadianceSampler, bgfx::UniformType::Sampler);
+	m_lutTexture = m_pRenderContext->CreateTexture(lutTexture);
+}
+
+void FrameConstants::Update(SceneWorld* pSceneWorld)
+{
+	// Camera
+	const cd::Vec3f& cameraPosition = pSceneWorld->GetTransformComponent(pSceneWorld->GetMainCameraEntity())->GetTransform().GetTranslation();
+	m_cameraPosition = cd::Vec4f(cameraPosition.x(), cameraPosition.y(), cameraPosition.z(), 1.0f);
+
+	// Sky
+	const SkyComponent* pSkyComponent = pSceneWorld->GetSkyComponent(pSceneWorld->GetSkyEntity());
+	m_isAtmosphericScattering = pSkyComponent && SkyType::AtmosphericScattering == pSkyComponent->GetSkyType();
+	if (m_isAtmosphericScattering)
+	{
+		const cd::Direction& sunDirection = pSkyComponent->GetSunDirection();
+		m_sunDirection = cd::Vec4f(sunDirection.x(), sunDirection.y(), sunDirection.z(), 0.0f);
+		m_heightOffsetAndShadowLength = cd::Vec4f(pSkyComponent->GetHeightOffset(), pSkyComponent->GetShadowLength(), 0.0f, 0.0f);
+	}
+
+	UpdateSkyTextures(pSkyComponent);
+
+	// Lights
+	static_assert(sizeof(U_Light) <= LightUniform::LIGHT_STRIDE * sizeof(cd::Vec4f));
+	const auto& lightEntities = pSceneWorld->GetLightEntities();
+	m_lightCount = static_cast<uint16_t>(std::min<size_t>(lightEntities.size(), MAX_LIGHT_COUNT));
+	m_lightCountAndStride = cd::Vec4f(static_cast<float>(m_lightCount), LightUniform::LIGHT_STRIDE, 0.0f, 0.0f);
+	for (uint16_t lightIndex = 0; lightIndex < m_lightCount; ++lightIndex)
+	{
+		// Light uniform data is at the beginning of LightComponent.
+		const LightComponent* pLightComponent = pSceneWorld->GetLightComponent(lightEntities[lightIndex]);
+		std::memcpy(&m_lightParameters[lightIndex * LightUniform::LIGHT_STRIDE], pLightComponent, sizeof(U_Light));
+	}
+}
+
+void FrameConstants::Submit(bgfx::Encoder* pEncoder) const
+{
+	// bgfx::begin returns the main thread encoder.
+	bgfx::Encoder* pTargetEncoder = pEncoder ? pEncoder : bgfx::begin();
+	pTargetEncoder->setUniform(m_cameraPosUniform, m_cameraPosition.Begin(), 1);
+
+	if (m_isAtmosphericScattering)
+	{
+		pTargetEncoder->setUniform(m_lightDirUniform, m_sunDirection.Begin(), 1);
+		pTargetEncoder->setUniform(m_heightOffsetAndShadowLengthUniform, m_heightOffsetAndShadowLength.Begin(), 1);
+	}
+
+	pTargetEncoder->setUniform(m_lightCountAndStrideUniform, m_lightCountAndStride.Begin(), 1);
+	if (m_lightCount > 0)
+	{
+		pTargetEncoder->setUniform(m_lightParamsUniform, m_lightParameters.data(), static_cast<uint16_t>(m_lightCount * LightUniform::LIGHT_STRIDE));
+	}
+}
+
+void FrameConstants::SubmitSkyTextures(bgfx::Encoder* pEncoder) const
+{
+	bgfx::Encoder* pTargetEncoder = pEncoder ? pEncoder : bgfx::begin();
+	if (SkyType::SkyBox == m_skyType)
+	{
+		pTargetEncoder->setTexture(IBL_IRRADIANCE_SLOT, m_irradianceSampler, m_irradianceTexture);
+		pTargetEncoder->setTexture(IBL_RADIANCE_SLOT, m_radianceSampler, m_radianceTexture);
+		pTargetEncoder->setTexture(BRDF_LUT_SLOT, m_lutSampler, m_lutTexture);
+	}
+	else if (SkyType::AtmosphericScattering == m_skyType)
+	{
+		pTargetEncoder->setImage(ATM_TRANSMITTANCE_SLOT, m_ATMTransmittanceTexture, 0, bgfx::Access::Read, bgfx::TextureFormat::RGBA32F);
+		pTargetEncoder->setImage(ATM_IRRADIANCE_SLOT, m_ATMIrradianceTexture, 0, bgfx::Access::Read, bgfx::TextureFormat::RGBA32F);
+		pTargetEncoder->setImage(ATM_SCATTERING_SLOT, m_ATMScatteringTexture, 0, bgfx::Access::Read, bgfx::TextureFormat::RGBA32F);
+	}
+}
+
+void FrameConstants::UpdateSkyTextures(const SkyComponent* pSkyComponent)
+{
+	if (!pSkyComponent)
+	{
+		m_pSkyComponent = nullptr;
+		m_skyType = SkyType::None;
+		return;
+	}
+
+	if (m_isSkyTexturesResolved && m_pSkyComponent == pSkyComponent && m_skyVersion == pSkyComponent->GetVersion())
+	{
+		return;
+	}
+
+	m_pSkyComponent = pSkyComponent;
+	m_skyVersion = pSkyComponent->GetVersion();
+	m_skyType = pSkyComponent->GetSkyType();
+
+	// RenderContext::CreateTexture returns the cached handle if the texture is already loaded.
+	m_irradianceTexture = m_pRenderContext->CreateTexture(pSkyComponent->GetIrradianceTexturePath().c_str(), samplerFlags);
+	m_radianceTexture = m_pRenderContext->CreateTexture(pSkyComponent->GetRadianceTexturePath().c_str(), samplerFlags);
+
+	// ATM textures are created by PBRSkyRenderer.
+	m_ATMTransmittanceTexture = m_pRenderContext->GetTexture(pSkyComponent->GetATMTransmittanceCrc());
+	m_ATMIrradianceTexture = m_pRenderContext->GetTexture(pSkyComponent->GetATMIrradianceCrc());
+	m_ATMScatteringTexture = m_pRenderContext->GetTexture(pSkyComponent->GetATMScatteringCrc());
+
+	// Missing textures are looked up again next frame until they exist.
+	m_isSkyTexturesResolved = true;
+	if (SkyType::SkyBox == m_skyType)
+	{
+		m_isSkyTexturesResolved = bgfx::isValid(m_irradianceTexture) && bgfx::isValid(m_radianceTexture);
+	}
+	else if (SkyType::AtmosphericScattering == m_skyType)
+	{
+		m_isSkyTexturesResolved = bgfx::isValid(m_ATMTransmittanceTexture) && bgfx::isValid(m_ATMIrradianceTexture) && bgfx::isValid(m_ATMScatteringTexture);
+	}
+}
+
+}
\ No newline at end of file
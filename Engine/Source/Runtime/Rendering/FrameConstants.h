@@ -0,0 +1,85 @@
+#pragma once
+
+#include "ECWorld/SkyComponent.h"
+#include "Math/Vector.hpp"
+
+#include <bgfx/bgfx.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+class RenderContext;
+class SceneWorld;
+
+// FrameConstants holds uniform values shared by every draw of a frame : camera, sky and lights.
+// Update packs them once per frame. Renderers call Submit once before their first draw instead of filling them per draw.
+// bgfx applies uniform values in view order, so each view submits them again rather than relying on another view.
+// Sky texture handles are also kept here. They are resolved again only when SkyComponent::GetVersion changes.
+class FrameConstants final
+{
+public:
+	FrameConstants() = default;
+	FrameConstants(const FrameConstants&) = delete;
+	FrameConstants& operator=(const FrameConstants&) = delete;
+	FrameConstants(FrameConstants&&) = default;
+	FrameConstants& operator=(FrameConstants&&) = default;
+	~FrameConstants() = default;
+
+	// Call it after bgfx is initialized.
+	void Init(RenderContext* pRenderContext);
+
+	// Call it once per frame after camera and lights are final.
+	void Update(SceneWorld* pSceneWorld);
+
+	// Set all frame uniforms for the next draws of the current view.
+	// Pass the encoder of a submit thread, or nullptr for the main thread.
+	void Submit(bgfx::Encoder* pEncoder = nullptr) const;
+
+	// Bind environment lighting textures of the sky for the next draw. Texture bindings are reset by submit.
+	void SubmitSkyTextures(bgfx::Encoder* pEncoder = nullptr) const;
+
+	SkyType GetSkyType() const { return m_skyType; }
+
+	uint16_t GetLightCount() const { return m_lightCount; }
+
+private:
+	void UpdateSkyTextures(const SkyComponent* pSkyComponent);
+
+private:
+	RenderContext* m_pRenderContext = nullptr;
+
+	bgfx::UniformHandle m_cameraPosUniform = BGFX_INVALID_HANDLE;
+	bgfx::UniformHandle m_lightCountAndStrideUniform = BGFX_INVALID_HANDLE;
+	bgfx::UniformHandle m_lightParamsUniform = BGFX_INVALID_HANDLE;
+	bgfx::UniformHandle m_lightDirUniform = BGFX_INVALID_HANDLE;
+	bgfx::UniformHandle m_heightOffsetAndShadowLengthUniform = BGFX_INVALID_HANDLE;
+
+	cd::Vec4f m_cameraPosition = cd::Vec4f::Zero();
+
+	bool m_isAtmosphericScattering = false;
+	cd::Vec4f m_sunDirection = cd::Vec4f::Zero();
+	cd::Vec4f m_heightOffsetAndShadowLength = cd::Vec4f::Zero();
+
+	uint16_t m_lightCount = 0;
+	cd::Vec4f m_lightCountAndStride = cd::Vec4f::Zero();
+	std::vector<cd::Vec4f> m_lightParameters;
+
+	const SkyComponent* m_pSkyComponent = nullptr;
+	uint32_t m_skyVersion = 0U;
+	bool m_isSkyTexturesResolved = false;
+	SkyType m_skyType = SkyType::None;
+	bgfx::UniformHandle m_lutSampler = BGFX_INVALID_HANDLE;
+	bgfx::UniformHandle m_irradianceSampler = BGFX_INVALID_HANDLE;
+	bgfx::UniformHandle m_radianceSampler = BGFX_INVALID_HANDLE;
+	bgfx::TextureHandle m_lutTexture = BGFX_INVALID_HANDLE;
+	bgfx::TextureHandle m_irradianceTexture = BGFX_INVALID_HANDLE;
+	bgfx::TextureHandle m_radianceTexture = BGFX_INVALID_HANDLE;
+	bgfx::TextureHandle m_ATMTransmittanceTexture = BGFX_INVALID_HANDLE;
+	bgfx::TextureHandle m_ATMIrradianceTexture = BGFX_INVALID_HANDLE;
+	bgfx::TextureHandle m_ATMScatteringTexture = BGFX_INVALID_HANDLE;
+};
+
+}
\ No newline at end of file
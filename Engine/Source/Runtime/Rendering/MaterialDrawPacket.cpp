@@ -0,0 +1,110 @@
+#include "MaterialDrawPacket.h"
+
+#include "ECWorld/MaterialComponent.h"
+#include "Material/ShaderSchema.h"
+#include "RenderContext.h"
+
+#include <cassert>
+
+namespace engine
+{
+
+namespace
+{
+
+constexpr const char* albedoColor                 = "u_albedoColor";
+constexpr const char* emissiveColor               = "u_emissiveColor";
+constexpr const char* metallicRoughnessFactor     = "u_metallicRoughnessFactor";
+constexpr const char* albedoUVOffsetAndScale      = "u_albedoUVOffsetAndScale";
+constexpr const char* alphaCutOff                 = "u_alphaCutOff";
+
+constexpr uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t fnvPrime = 1099511628211ULL;
+
+}
+
+void MaterialUniforms::Init(RenderContext* pRenderContext)
+{
+	m_albedoColor = pRenderContext->CreateUniform(albedoColor, bgfx::UniformType::Vec4, 1);
+	m_emissiveColor = pRenderContext->CreateUniform(emissiveColor, bgfx::UniformType::Vec4, 1);
+	m_metallicRoughnessFactor = pRenderContext->CreateUniform(metallicRoughnessFactor, bgfx::UniformType::Vec4, 1);
+	m_albedoUVOffsetAndScale = pRenderContext->CreateUniform(albedoUVOffsetAndScale, bgfx::UniformType::Vec4, 1);
+	m_alphaCutOff = pRenderContext->CreateUniform(alphaCutOff, bgfx::UniformType::Vec4, 1);
+}
+
+void MaterialUniforms::Submit(const MaterialComponent& materialComponent, bgfx::Encoder* pEncoder) const
+{
+	bgfx::Encoder* pTargetEncoder = pEncoder ? pEncoder : bgfx::begin();
+	if (const MaterialComponent::TextureInfo* pTextureInfo = materialComponent.GetTextureInfo(cd::MaterialTextureType::BaseColor))
+	{
+		cd::Vec4f uvOffsetAndScaleData(pTextureInfo->GetUVOffset().x(), pTextureInfo->GetUVOffset().y(),
+			pTextureInfo->GetUVScale().x(), pTextureInfo->GetUVScale().y());
+		pTargetEncoder->setUniform(m_albedoUVOffsetAndScale, uvOffsetAndScaleData.Begin(), 1);
+	}
+
+	pTargetEncoder->setUniform(m_albedoColor, materialComponent.GetAlbedoColor().Begin(), 1);
+
+	cd::Vec4f metallicRoughnessFactorData(materialComponent.GetMetallicFactor(), materialComponent.GetRoughnessFactor(), 1.0f, 1.0f);
+	pTargetEncoder->setUniform(m_metallicRoughnessFactor, metallicRoughnessFactorData.Begin(), 1);
+
+	pTargetEncoder->setUniform(m_emissiveColor, materialComponent.GetEmissiveColor().Begin(), 1);
+
+	if (cd::BlendMode::Mask == materialComponent.GetBlendMode())
+	{
+		float alphaCutOffValue = materialComponent.GetAlphaCutOff();
+		pTargetEncoder->setUniform(m_alphaCutOff, &alphaCutOffValue, 1);
+	}
+}
+
+uint32_t MaterialDrawPacketCache::Resolve(Entity entity, const MaterialComponent& materialComponent)
+{
+	uint32_t entityIndex = GetEntityIndex(entity);
+	uint32_t packetIndex = m_entityToPacket.Get(entityIndex);
+	if (UINT32_MAX == packetIndex)
+	{
+		packetIndex = static_cast<uint32_t>(m_packets.size());
+		m_packets.emplace_back();
+		m_entityToPacket.Set(entityIndex, packetIndex);
+	}
+
+	// Programs are created by ShaderLoader, so an invalid one is looked up again until it is ready.
+	MaterialDrawPacket& packet = m_packets[packetIndex];
+	if (packet.entity != entity || packet.materialVersion != materialComponent.GetVersion() ||
+		ShaderSchema::InvalidProgramHandle == packet.program)
+	{
+		Build(packet, entity, materialComponent);
+	}
+
+	return packetIndex;
+}
+
+void MaterialDrawPacketCache::Clear()
+{
+	m_packets.clear();
+	m_entityToPacket.Clear();
+}
+
+void MaterialDrawPacketCache::Build(MaterialDrawPacket& packet, Entity entity, const MaterialComponent& materialComponent)
+{
+	packet.entity = entity;
+	packet.materialVersion = materialComponent.GetVersion();
+	packet.program = materialComponent.GetShadreProgram();
+	packet.instanceProgram = materialComponent.GetInstanceShaderProgram();
+
+	packet.textureKey = fnvOffsetBasis;
+	packet.textureCount = 0U;
+	for (const auto& [_, textureInfo] : materialComponent.GetTextureResources())
+	{
+		assert(packet.textureCount < MaterialDrawPacket::MaxTextureCount);
+		if (packet.textureCount >= MaterialDrawPacket::MaxTextureCount)
+		{
+			break;
+		}
+
+		packet.textures[packet.textureCount++] = MaterialDrawPacket::TextureBinding{
+			bgfx::UniformHandle{textureInfo.samplerHandle}, bgfx::TextureHandle{textureInfo.textureHandle}, textureInfo.slot };
+		packet.textureKey = ((packet.textureKey ^ textureInfo.slot) * fnvPrime ^ textureInfo.textureHandle) * fnvPrime;
+	}
+}
+
+}
\ No newline at end of file
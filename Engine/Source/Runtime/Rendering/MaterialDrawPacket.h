@@ -0,0 +1,99 @@
+#pragma once
+
+#include "ECWorld/Entity.h"
+#include "ECWorld/PagedSparseArray.hpp"
+
+#include <bgfx/bgfx.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+class MaterialComponent;
+class RenderContext;
+
+// MaterialUniforms holds handles of PBR material uniforms. They are resolved once when a renderer initializes,
+// so setting material values per draw doesn't look up uniforms by name.
+class MaterialUniforms final
+{
+public:
+	void Init(RenderContext* pRenderContext);
+
+	// Set material values for the next draw. Pass the encoder of a submit thread, or nullptr for the main thread.
+	void Submit(const MaterialComponent& materialComponent, bgfx::Encoder* pEncoder = nullptr) const;
+
+private:
+	bgfx::UniformHandle m_albedoColor = BGFX_INVALID_HANDLE;
+	bgfx::UniformHandle m_emissiveColor = BGFX_INVALID_HANDLE;
+	bgfx::UniformHandle m_metallicRoughnessFactor = BGFX_INVALID_HANDLE;
+	bgfx::UniformHandle m_albedoUVOffsetAndScale = BGFX_INVALID_HANDLE;
+	bgfx::UniformHandle m_alphaCutOff = BGFX_INVALID_HANDLE;
+};
+
+// MaterialDrawPacket is a flat copy of the handles one material needs for a draw.
+struct MaterialDrawPacket
+{
+	static constexpr uint32_t MaxTextureCount = 16U;
+
+	struct TextureBinding
+	{
+		bgfx::UniformHandle sampler;
+		bgfx::TextureHandle texture;
+		uint8_t slot;
+	};
+
+	Entity entity = INVALID_ENTITY;
+	uint32_t materialVersion = 0U;
+	uint16_t program = UINT16_MAX;
+	uint16_t instanceProgram = UINT16_MAX;
+
+	// Hash of texture slots and handles. Materials sharing all textures get the same key.
+	uint64_t textureKey = 0U;
+
+	uint32_t textureCount = 0U;
+	std::array<TextureBinding, MaxTextureCount> textures;
+
+	void SubmitTextures(bgfx::Encoder* pEncoder = nullptr) const
+	{
+		bgfx::Encoder* pTargetEncoder = pEncoder ? pEncoder : bgfx::begin();
+		for (uint32_t textureIndex = 0; textureIndex < textureCount; ++textureIndex)
+		{
+			const TextureBinding& binding = textures[textureIndex];
+			pTargetEncoder->setTexture(binding.slot, binding.sampler, binding.texture);
+		}
+	}
+};
+
+// MaterialDrawPacketCache keeps one packet per entity. A packet is built again only when its entity index is reused
+// or MaterialComponent::GetVersion differs from the version it was built from.
+class MaterialDrawPacketCache final
+{
+public:
+	MaterialDrawPacketCache() = default;
+	MaterialDrawPacketCache(const MaterialDrawPacketCache&) = delete;
+	MaterialDrawPacketCache& operator=(const MaterialDrawPacketCache&) = delete;
+	MaterialDrawPacketCache(MaterialDrawPacketCache&&) = default;
+	MaterialDrawPacketCache& operator=(MaterialDrawPacketCache&&) = default;
+	~MaterialDrawPacketCache() = default;
+
+	// Returns the index of an up to date packet. Indices stay valid, references may move when packets are added.
+	uint32_t Resolve(Entity entity, const MaterialComponent& materialComponent);
+	const MaterialDrawPacket& GetPacket(uint32_t packetIndex) const { return m_packets[packetIndex]; }
+
+	size_t GetPacketCount() const { return m_packets.size(); }
+	void Clear();
+
+private:
+	static void Build(MaterialDrawPacket& packet, Entity entity, const MaterialComponent& materialComponent);
+
+private:
+	std::vector<MaterialDrawPacket> m_packets;
+
+	// Entity index -> index in m_packets.
+	PagedSparseArray<uint32_t, UINT32_MAX> m_entityToPacket;
+};
+
+}
\ No newline at end of file
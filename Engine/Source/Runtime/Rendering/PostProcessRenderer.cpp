@@ -36,8 +36,7 @@ void PostProcessRenderer::Render(float deltaTime)
 	bgfx::TextureHandle screenTextureHandle;
 	if (pInputRT == pOutputRT)
 	{
-		constexpr StringCrc sceneRenderTargetBlitSRV("SceneRenderTargetBlitSRV");
-		screenTextureHandle = GetRenderContext()->GetTexture(sceneRenderTargetBlitSRV);
+		screenTextureHandle = SwapViewRenderTargetColor(GetViewID());
 	}
 	else
 	{
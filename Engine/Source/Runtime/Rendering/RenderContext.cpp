@@ -10,6 +10,7 @@
 #include <bimg/decode.h>
 #include <bx/allocator.h>
 
+#include <algorithm>
 #include <cassert>
 //#include <format>
 #include <fstream>
@@ -50,10 +51,23 @@ namespace engine
 
 RenderContext::~RenderContext()
 {
+	for (const PooledRenderTarget& pooledRenderTarget : m_renderTargetPool)
+	{
+		if (bgfx::isValid(pooledRenderTarget.frameBufferHandle))
+		{
+			bgfx::destroy(pooledRenderTarget.frameBufferHandle);
+		}
+		bgfx::destroy(pooledRenderTarget.textureHandle);
+	}
+	m_renderTargetPool.clear();
+
+	// Render targets release their bgfx resources when destroyed.
+	m_renderTargetCaches.clear();
+
 	bgfx::shutdown();
 }
 
-void RenderContext::Init(GraphicsBackend backend, void* hwnd)
+void RenderContext::Init(GraphicsBackend backend, void* hwnd, uint16_t submitThreadCount)
 {
 	bgfx::Init initDesc;
 	switch (backend)
@@ -97,7 +111,15 @@ void RenderContext::Init(GraphicsBackend backend, void* hwnd)
 	}
 
 	initDesc.platformData.nwh = hwnd;
+
+	// Every submit thread records with its own encoder, the main thread keeps one more.
+	initDesc.limits.maxEncoders = std::max<uint16_t>(initDesc.limits.maxEncoders, submitThreadCount + 1U);
 	bgfx::init(initDesc);
+
+	uint32_t maxSubmitThreadCount = std::max<uint32_t>(bgfx::getCaps()->limits.maxEncoders, 2U) - 1U;
+	m_submitThreadCount = static_cast<uint16_t>(std::clamp<uint32_t>(submitThreadCount, 1U, maxSubmitThreadCount));
+
+	m_frameConstants.Init(this);
 }
 
 void RenderContext::Shutdown()
@@ -131,7 +153,12 @@ void RenderContext::EndFrame()
 {
 	// Advance to next frame. Rendering thread will be kicked to
 	// process submitted rendering primitives.
-	bgfx::frame();
+	m_frameNumber = bgfx::frame();
+
+	m_lastStateChangeCount = m_stateChangeCount;
+	m_stateChangeCount = 0;
+
+	TrimRenderTargetPool();
 }
 
 void RenderContext::OnResize(uint16_t width, uint16_t height)
@@ -147,9 +174,9 @@ uint16_t RenderContext::CreateView()
 	return m_currentViewCount++;
 }
 
-RenderTarget* RenderContext::CreateRenderTarget(StringCrc resourceCrc, uint16_t width, uint16_t height, std::vector<AttachmentDescriptor> attachmentDescs)
+RenderTarget* RenderContext::CreateRenderTarget(StringCrc resourceCrc, uint16_t width, uint16_t height, std::vector<AttachmentDescriptor> attachmentDescs, bool isPingPong)
 {
-	return CreateRenderTarget(resourceCrc, std::make_unique<RenderTarget>(width, height, std::move(attachmentDescs)));
+	return CreateRenderTarget(resourceCrc, std::make_unique<RenderTarget>(width, height, std::move(attachmentDescs), isPingPong));
 }
 
 RenderTarget* RenderContext::CreateRenderTarget(StringCrc resourceCrc, uint16_t width, uint16_t height, void* pWindowHandle)
@@ -460,6 +487,11 @@ void RenderContext::SetTexture(StringCrc resourceCrc, bgfx::TextureHandle textur
 	m_textureHandleCaches[resourceCrc.Value()] = std::move(textureHandle);
 }
 
+void RenderContext::SetFrameBuffer(StringCrc resourceCrc, bgfx::FrameBufferHandle frameBufferHandle)
+{
+	m_frameBufferHandleCaches[resourceCrc.Value()] = frameBufferHandle;
+}
+
 void RenderContext::SetUniform(StringCrc resourceCrc, bgfx::UniformHandle uniformreHandle)
 {
 	m_uniformHandleCaches[resourceCrc.Value()] = std::move(uniformreHandle);
@@ -526,6 +558,17 @@ bgfx::TextureHandle RenderContext::GetTexture(StringCrc resourceCrc) const
 	return bgfx::TextureHandle{bgfx::kInvalidHandle};
 }
 
+bgfx::FrameBufferHandle RenderContext::GetFrameBuffer(StringCrc resourceCrc) const
+{
+	auto itResource = m_frameBufferHandleCaches.find(resourceCrc.Value());
+	if (itResource != m_frameBufferHandleCaches.end())
+	{
+		return itResource->second;
+	}
+
+	return bgfx::FrameBufferHandle{bgfx::kInvalidHandle};
+}
+
 bgfx::UniformHandle RenderContext::GetUniform(StringCrc resourceCrc) const
 {
 	auto itResource = m_uniformHandleCaches.find(resourceCrc.Value());
@@ -550,4 +593,105 @@ void RenderContext::DestoryRenderTarget(StringCrc resourceCrc)
 	m_renderTargetCaches.erase(resourceCrc.Value());
 }
 
+bgfx::FrameBufferHandle RenderContext::AcquireFrameBuffer(uint16_t width, uint16_t height, bgfx::TextureFormat::Enum format, uint64_t flags)
+{
+	return AcquirePooledRenderTarget(width, height, format, flags, true).frameBufferHandle;
+}
+
+void RenderContext::ReleaseFrameBuffer(bgfx::FrameBufferHandle frameBufferHandle)
+{
+	if (!bgfx::isValid(frameBufferHandle))
+	{
+		return;
+	}
+
+	for (PooledRenderTarget& pooledRenderTarget : m_renderTargetPool)
+	{
+		if (pooledRenderTarget.frameBufferHandle.idx == frameBufferHandle.idx)
+		{
+			assert(pooledRenderTarget.isInUse && "Release a frame buffer twice.");
+			pooledRenderTarget.isInUse = false;
+			pooledRenderTarget.releaseFrame = m_frameNumber;
+			return;
+		}
+	}
+
+	assert(false && "Release a frame buffer which is not from the pool.");
+}
+
+bgfx::TextureHandle RenderContext::AcquireTexture(uint16_t width, uint16_t height, bgfx::TextureFormat::Enum format, uint64_t flags)
+{
+	return AcquirePooledRenderTarget(width, height, format, flags, false).textureHandle;
+}
+
+void RenderContext::ReleaseTexture(bgfx::TextureHandle textureHandle)
+{
+	if (!bgfx::isValid(textureHandle))
+	{
+		return;
+	}
+
+	for (PooledRenderTarget& pooledRenderTarget : m_renderTargetPool)
+	{
+		if (!bgfx::isValid(pooledRenderTarget.frameBufferHandle) && pooledRenderTarget.textureHandle.idx == textureHandle.idx)
+		{
+			assert(pooledRenderTarget.isInUse && "Release a texture twice.");
+			pooledRenderTarget.isInUse = false;
+			pooledRenderTarget.releaseFrame = m_frameNumber;
+			return;
+		}
+	}
+
+	assert(false && "Release a texture which is not from the pool.");
+}
+
+RenderContext::PooledRenderTarget& RenderContext::AcquirePooledRenderTarget(uint16_t width, uint16_t height, bgfx::TextureFormat::Enum format, uint64_t flags, bool isFrameBuffer)
+{
+	for (PooledRenderTarget& pooledRenderTarget : m_renderTargetPool)
+	{
+		if (!pooledRenderTarget.isInUse && pooledRenderTarget.width == width && pooledRenderTarget.height == height &&
+			pooledRenderTarget.format == format && pooledRenderTarget.flags == flags &&
+			bgfx::isValid(pooledRenderTarget.frameBufferHandle) == isFrameBuffer)
+		{
+			pooledRenderTarget.isInUse = true;
+			return pooledRenderTarget;
+		}
+	}
+
+	PooledRenderTarget& pooledRenderTarget = m_renderTargetPool.emplace_back();
+	pooledRenderTarget.width = width;
+	pooledRenderTarget.height = height;
+	pooledRenderTarget.format = format;
+	pooledRenderTarget.flags = flags;
+	pooledRenderTarget.textureHandle = bgfx::createTexture2D(width, height, false, 1, format, flags);
+	pooledRenderTarget.frameBufferHandle = BGFX_INVALID_HANDLE;
+	if (isFrameBuffer)
+	{
+		// The pool owns the texture, so the frame buffer doesn't destroy it.
+		pooledRenderTarget.frameBufferHandle = bgfx::createFrameBuffer(1, &pooledRenderTarget.textureHandle, false);
+	}
+	pooledRenderTarget.releaseFrame = m_frameNumber;
+	pooledRenderTarget.isInUse = true;
+
+	return pooledRenderTarget;
+}
+
+void RenderContext::TrimRenderTargetPool()
+{
+	std::erase_if(m_renderTargetPool, [this](const PooledRenderTarget& pooledRenderTarget)
+	{
+		if (pooledRenderTarget.isInUse || m_frameNumber - pooledRenderTarget.releaseFrame <= PooledRenderTargetLifetime)
+		{
+			return false;
+		}
+
+		if (bgfx::isValid(pooledRenderTarget.frameBufferHandle))
+		{
+			bgfx::destroy(pooledRenderTarget.frameBufferHandle);
+		}
+		bgfx::destroy(pooledRenderTarget.textureHandle);
+		return true;
+	});
+}
+
 }
\ No newline at end of file
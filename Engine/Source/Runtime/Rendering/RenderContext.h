@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Core/StringCrc.h"
+#include "FrameConstants.h"
 #include "Graphics/GraphicsBackend.h"
 #include "Math/Matrix.hpp"
 #include "RenderTarget.h"
@@ -12,6 +13,7 @@
 #include <cstdint>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace engine
 {
@@ -34,7 +36,8 @@ public:
 	RenderContext& operator=(RenderContext&&) = delete;
 	~RenderContext();
 
-	void Init(GraphicsBackend backend, void* hwnd = nullptr);
+	// submitThreadCount is how many threads heavy renderers may use to record draws. 1 records on the main thread only.
+	void Init(GraphicsBackend backend, void* hwnd = nullptr, uint16_t submitThreadCount = 1);
 	void OnResize(uint16_t width, uint16_t height);
 	void BeginFrame();
 	void EndFrame();
@@ -48,10 +51,22 @@ public:
 	void ResetViewCount() { m_currentViewCount = 0; }
 	uint16_t GetCurrentViewCount() const { return m_currentViewCount; }
 
+	// Clamped to the encoder count bgfx supports.
+	uint16_t GetSubmitThreadCount() const { return m_submitThreadCount; }
+
+	FrameConstants& GetFrameConstants() { return m_frameConstants; }
+	const FrameConstants& GetFrameConstants() const { return m_frameConstants; }
+
+	// Renderers report how many times they changed program, textures or render state between draws.
+	void AddStateChangeCount(uint32_t count) { m_stateChangeCount += count; }
+	// Count of the last finished frame.
+	uint32_t GetStateChangeCount() const { return m_lastStateChangeCount; }
+
 	/////////////////////////////////////////////////////////////////////
 	// Resource related apis
 	/////////////////////////////////////////////////////////////////////
-	RenderTarget* CreateRenderTarget(StringCrc resourceCrc, uint16_t width, uint16_t height, std::vector<AttachmentDescriptor> attachmentDescs);
+	// Post processing passes read and write a ping-pong render target by swapping its two colors instead of copying it.
+	RenderTarget* CreateRenderTarget(StringCrc resourceCrc, uint16_t width, uint16_t height, std::vector<AttachmentDescriptor> attachmentDescs, bool isPingPong = false);
 	RenderTarget* CreateRenderTarget(StringCrc resourceCrc, uint16_t width, uint16_t height, void* pWindowHandle);
 	RenderTarget* CreateRenderTarget(StringCrc resourceCrc, std::unique_ptr<RenderTarget> pRenderTarget);
 
@@ -71,6 +86,8 @@ public:
 	bgfx::VertexLayout CreateVertexLayout(StringCrc resourceCrc, const cd::VertexAttributeLayout& vertexAttribute);
 	void SetVertexLayout(StringCrc resourceCrc, bgfx::VertexLayout textureHandle);
 	void SetTexture(StringCrc resourceCrc, bgfx::TextureHandle textureHandle);
+	// Named frame buffers are not owned by RenderContext, e.g. transient render targets of RenderGraph.
+	void SetFrameBuffer(StringCrc resourceCrc, bgfx::FrameBufferHandle frameBufferHandle);
 	void SetUniform(StringCrc resourceCrc, bgfx::UniformHandle uniformreHandle);
 	void FillUniform(StringCrc resourceCrc, const void *pData, uint16_t vec4Count = 1) const;
 
@@ -79,19 +96,60 @@ public:
 	bgfx::ShaderHandle GetShader(StringCrc resourceCrc) const;
 	bgfx::ProgramHandle GetProgram(StringCrc resourceCrc) const;
 	bgfx::TextureHandle GetTexture(StringCrc resourceCrc) const;
+	bgfx::FrameBufferHandle GetFrameBuffer(StringCrc resourceCrc) const;
 	bgfx::UniformHandle GetUniform(StringCrc resourceCrc) const;
 
 	void Destory(StringCrc resourceCrc);
 	void DestoryRenderTarget(StringCrc resourceCrc);
 
+	/////////////////////////////////////////////////////////////////////
+	// Render target pool
+	/////////////////////////////////////////////////////////////////////
+	// Pooled frame buffers and textures are recycled by size, format and flags. Release them when they are not used,
+	// e.g. before acquiring ones of a new size. Released ones which are not acquired again for a few frames are destroyed.
+	bgfx::FrameBufferHandle AcquireFrameBuffer(uint16_t width, uint16_t height, bgfx::TextureFormat::Enum format, uint64_t flags);
+	void ReleaseFrameBuffer(bgfx::FrameBufferHandle frameBufferHandle);
+	bgfx::TextureHandle AcquireTexture(uint16_t width, uint16_t height, bgfx::TextureFormat::Enum format, uint64_t flags);
+	void ReleaseTexture(bgfx::TextureHandle textureHandle);
+	size_t GetPooledRenderTargetCount() const { return m_renderTargetPool.size(); }
+
+private:
+	struct PooledRenderTarget
+	{
+		uint16_t width;
+		uint16_t height;
+		bgfx::TextureFormat::Enum format;
+		uint64_t flags;
+		bgfx::TextureHandle textureHandle;
+
+		// Invalid for pooled textures.
+		bgfx::FrameBufferHandle frameBufferHandle;
+
+		uint32_t releaseFrame;
+		bool isInUse;
+	};
+
+	// Frames a released render target stays in the pool.
+	static constexpr uint32_t PooledRenderTargetLifetime = 8U;
+
+	PooledRenderTarget& AcquirePooledRenderTarget(uint16_t width, uint16_t height, bgfx::TextureFormat::Enum format, uint64_t flags, bool isFrameBuffer);
+	void TrimRenderTargetPool();
+
 private:
 	uint8_t m_currentViewCount = 0;
+	uint16_t m_submitThreadCount = 1;
+	uint32_t m_stateChangeCount = 0;
+	uint32_t m_lastStateChangeCount = 0;
+	uint32_t m_frameNumber = 0;
+	FrameConstants m_frameConstants;
 	std::unordered_map<size_t, std::unique_ptr<RenderTarget>> m_renderTargetCaches;
 	std::unordered_map<size_t, bgfx::VertexLayout> m_vertexLayoutCaches;
 	std::unordered_map<size_t, bgfx::ShaderHandle> m_shaderHandleCaches;
 	std::unordered_map<size_t, bgfx::ProgramHandle> m_programHandleCaches;
 	std::unordered_map<size_t, bgfx::TextureHandle> m_textureHandleCaches;
+	std::unordered_map<size_t, bgfx::FrameBufferHandle> m_frameBufferHandleCaches;
 	std::unordered_map<size_t, bgfx::UniformHandle> m_uniformHandleCaches;
+	std::vector<PooledRenderTarget> m_renderTargetPool;
 
 	uint16_t m_backBufferWidth;
 	uint16_t m_backBufferHeight;
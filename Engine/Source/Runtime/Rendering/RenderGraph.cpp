@@ -0,0 +1,209 @@
+#include "RenderGraph.h"
+
+#include "Base/Template.h"
+#include "RenderContext.h"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace engine
+{
+
+RenderGraph::RenderGraph(RenderContext* pRenderContext)
+	: m_pRenderContext(pRenderContext)
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+	for (const PhysicalFrameBuffer& physicalFrameBuffer : m_physicalFrameBuffers)
+	{
+		m_pRenderContext->ReleaseFrameBuffer(physicalFrameBuffer.handle);
+	}
+
+	for (const TransientFrameBuffer& transientFrameBuffer : m_transientFrameBuffers)
+	{
+		m_pRenderContext->SetFrameBuffer(transientFrameBuffer.resourceCrc, BGFX_INVALID_HANDLE);
+	}
+}
+
+void RenderGraph::CreateFrameBuffer(StringCrc resourceCrc, StringCrc sizeSource, uint8_t sizeShift, bgfx::TextureFormat::Enum format, uint64_t flags)
+{
+	assert(!m_resourceIndices.contains(resourceCrc.Value()) && "Declare frame buffers before passes use them.");
+
+	auto itDescriptor = std::find_if(m_frameBufferDescriptors.begin(), m_frameBufferDescriptors.end(), [&](const FrameBufferDescriptor& descriptor)
+	{
+		return descriptor.sizeSource == sizeSource && descriptor.sizeShift == sizeShift && descriptor.format == format && descriptor.flags == flags;
+	});
+	if (itDescriptor == m_frameBufferDescriptors.end())
+	{
+		itDescriptor = m_frameBufferDescriptors.insert(m_frameBufferDescriptors.end(), FrameBufferDescriptor{ sizeSource, sizeShift, format, flags });
+	}
+
+	uint64_t aliasKey = static_cast<uint64_t>(itDescriptor - m_frameBufferDescriptors.begin()) + 1U;
+	uint32_t resourceIndex = m_compiler.AddResource(aliasKey);
+	m_resourceIndices[resourceCrc.Value()] = resourceIndex;
+	m_transientFrameBuffers.push_back(TransientFrameBuffer{ resourceCrc, resourceIndex });
+	m_isCompileNeeded = true;
+}
+
+void RenderGraph::MarkOutput(StringCrc resourceCrc)
+{
+	m_compiler.MarkOutput(GetResourceIndex(resourceCrc));
+	m_isCompileNeeded = true;
+}
+
+Renderer* RenderGraph::AddPass(std::unique_ptr<Renderer> pRenderer, const std::vector<StringCrc>& reads, const std::vector<StringCrc>& writes)
+{
+	// Renderers like BloomRenderer create their extra views in Init.
+	std::vector<uint16_t> views{ pRenderer->GetViewID() };
+	uint16_t firstInitView = m_pRenderContext->GetCurrentViewCount();
+	pRenderer->Init();
+	for (uint16_t viewID = firstInitView; viewID < m_pRenderContext->GetCurrentViewCount(); ++viewID)
+	{
+		views.push_back(viewID);
+	}
+
+	uint32_t passIndex = m_compiler.AddPass(cd::MoveTemp(views));
+	for (StringCrc resourceCrc : reads)
+	{
+		m_compiler.AddRead(passIndex, GetResourceIndex(resourceCrc));
+	}
+	for (StringCrc resourceCrc : writes)
+	{
+		m_compiler.AddWrite(passIndex, GetResourceIndex(resourceCrc));
+	}
+	m_isCompileNeeded = true;
+
+	return m_pPasses.emplace_back(cd::MoveTemp(pRenderer)).get();
+}
+
+void RenderGraph::Compile()
+{
+	UpdatePassEnables();
+	m_compiler.Compile();
+	UpdateViewOrder();
+
+	for (uint32_t passIndex : m_lastPassOrder)
+	{
+		if (!m_compiler.IsPassLive(passIndex))
+		{
+			m_pPasses[passIndex]->OnCulled();
+		}
+	}
+	m_lastPassOrder = m_compiler.GetPassOrder();
+
+	m_compiledViewCount = m_pRenderContext->GetCurrentViewCount();
+	m_isCompileNeeded = false;
+}
+
+void RenderGraph::Execute(float deltaTime, const float* pViewMatrix, const float* pProjectionMatrix)
+{
+	// Renderers are enabled or disabled by camera settings at any time, but the result stays the same for most frames.
+	if (UpdatePassEnables() || m_isCompileNeeded || m_compiledViewCount != m_pRenderContext->GetCurrentViewCount())
+	{
+		Compile();
+	}
+
+	// Sizes follow render targets which are resized without compiling.
+	UpdateTransientFrameBuffers();
+
+	for (uint32_t passIndex : m_compiler.GetPassOrder())
+	{
+		Renderer* pRenderer = m_pPasses[passIndex].get();
+		pRenderer->UpdateView(pViewMatrix, pProjectionMatrix);
+		pRenderer->Render(deltaTime);
+	}
+}
+
+uint32_t RenderGraph::GetResourceIndex(StringCrc resourceCrc)
+{
+	auto itResource = m_resourceIndices.find(resourceCrc.Value());
+	if (itResource != m_resourceIndices.end())
+	{
+		return itResource->second;
+	}
+
+	uint32_t resourceIndex = m_compiler.AddResource();
+	m_resourceIndices[resourceCrc.Value()] = resourceIndex;
+	return resourceIndex;
+}
+
+bool RenderGraph::UpdatePassEnables()
+{
+	bool isChanged = false;
+	for (uint32_t passIndex = 0; passIndex < m_pPasses.size(); ++passIndex)
+	{
+		bool isEnable = m_pPasses[passIndex]->IsEnable();
+		if (m_compiler.IsPassEnable(passIndex) != isEnable)
+		{
+			m_compiler.SetPassEnable(passIndex, isEnable);
+			isChanged = true;
+		}
+	}
+
+	return isChanged;
+}
+
+void RenderGraph::UpdateTransientFrameBuffers()
+{
+	uint32_t physicalCount = m_compiler.GetPhysicalCount();
+	for (uint32_t physicalIndex = physicalCount; physicalIndex < m_physicalFrameBuffers.size(); ++physicalIndex)
+	{
+		m_pRenderContext->ReleaseFrameBuffer(m_physicalFrameBuffers[physicalIndex].handle);
+	}
+	m_physicalFrameBuffers.resize(physicalCount);
+
+	for (uint32_t physicalIndex = 0; physicalIndex < physicalCount; ++physicalIndex)
+	{
+		uint64_t aliasKey = m_compiler.GetPhysicalAliasKey(physicalIndex);
+		const FrameBufferDescriptor& descriptor = m_frameBufferDescriptors[aliasKey - 1U];
+
+		uint16_t width = m_pRenderContext->GetBackBufferWidth();
+		uint16_t height = m_pRenderContext->GetBackBufferHeight();
+		if (const RenderTarget* pSizeSource = m_pRenderContext->GetRenderTarget(descriptor.sizeSource))
+		{
+			width = pSizeSource->GetWidth();
+			height = pSizeSource->GetHeight();
+		}
+		width = std::max<uint16_t>(width >> descriptor.sizeShift, 1U);
+		height = std::max<uint16_t>(height >> descriptor.sizeShift, 1U);
+
+		PhysicalFrameBuffer& physicalFrameBuffer = m_physicalFrameBuffers[physicalIndex];
+		if (bgfx::isValid(physicalFrameBuffer.handle) && physicalFrameBuffer.aliasKey == aliasKey &&
+			physicalFrameBuffer.width == width && physicalFrameBuffer.height == height)
+		{
+			continue;
+		}
+
+		// Frame buffers of the old size stay in the pool for a few frames, so resizing back and forth reuses them.
+		m_pRenderContext->ReleaseFrameBuffer(physicalFrameBuffer.handle);
+		physicalFrameBuffer.handle = m_pRenderContext->AcquireFrameBuffer(width, height, descriptor.format, descriptor.flags);
+		physicalFrameBuffer.aliasKey = aliasKey;
+		physicalFrameBuffer.width = width;
+		physicalFrameBuffer.height = height;
+	}
+
+	for (const TransientFrameBuffer& transientFrameBuffer : m_transientFrameBuffers)
+	{
+		uint32_t physicalIndex = m_compiler.GetPhysicalIndex(transientFrameBuffer.resourceIndex);
+		bgfx::FrameBufferHandle frameBufferHandle = RenderGraphCompiler::InvalidIndex == physicalIndex ?
+			bgfx::FrameBufferHandle{ bgfx::kInvalidHandle } : m_physicalFrameBuffers[physicalIndex].handle;
+		m_pRenderContext->SetFrameBuffer(transientFrameBuffer.resourceCrc, frameBufferHandle);
+	}
+}
+
+void RenderGraph::UpdateViewOrder()
+{
+	// bgfx sorts submitted draws by the remapped view id.
+	m_compiler.BuildViewRemap(m_pRenderContext->GetCurrentViewCount(), m_nextViewRemap);
+	if (m_nextViewRemap != m_viewRemap)
+	{
+		std::swap(m_viewRemap, m_nextViewRemap);
+		bgfx::setViewOrder(0, static_cast<uint16_t>(m_viewRemap.size()), m_viewRemap.data());
+	}
+}
+
+}
\ No newline at end of file
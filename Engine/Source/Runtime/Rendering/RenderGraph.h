@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Core/StringCrc.h"
+#include "RenderGraphCompiler.hpp"
+
+#include <bgfx/bgfx.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace engine
+{
+
+class RenderContext;
+class Renderer;
+
+// RenderGraph runs renderers as passes which declare resources they read and write.
+// It skips passes whose outputs are not used, orders bgfx views as passes execute
+// and lets transient render targets whose lifetimes don't overlap share one frame buffer.
+// The graph is compiled again only when passes are enabled or disabled, or views are added.
+class RenderGraph final
+{
+public:
+	// Write it from passes drawing to the back buffer.
+	static constexpr StringCrc BackBuffer = StringCrc("BackBuffer");
+
+	// Attachments of the scene render target. Sky passes clear all of them and passes testing depth read SceneDepth.
+	static constexpr StringCrc SceneColor = StringCrc("SceneColor");
+	static constexpr StringCrc SceneEmissive = StringCrc("SceneEmissive");
+	static constexpr StringCrc SceneDepth = StringCrc("SceneDepth");
+
+public:
+	RenderGraph() = delete;
+	explicit RenderGraph(RenderContext* pRenderContext);
+	RenderGraph(const RenderGraph&) = delete;
+	RenderGraph& operator=(const RenderGraph&) = delete;
+	RenderGraph(RenderGraph&&) = delete;
+	RenderGraph& operator=(RenderGraph&&) = delete;
+	~RenderGraph();
+
+	// Declares a render target owned by the graph with one color attachment. Its size is the size of sizeSource
+	// render target shifted right by sizeShift, e.g. 1 for half size, so mip chains are able to use it. It only exists
+	// while a live pass uses it and comes from the RenderContext pool. Passes get it by RenderContext::GetFrameBuffer,
+	// which is invalid when it is not created.
+	void CreateFrameBuffer(StringCrc resourceCrc, StringCrc sizeSource, uint8_t sizeShift, bgfx::TextureFormat::Enum format, uint64_t flags = 0UL);
+	void MarkOutput(StringCrc resourceCrc);
+
+	// Resources which are not created by CreateFrameBuffer are imported, e.g. render targets of RenderContext.
+	// Calls Renderer::Init and views created in Init belong to the pass too.
+	Renderer* AddPass(std::unique_ptr<Renderer> pRenderer, const std::vector<StringCrc>& reads, const std::vector<StringCrc>& writes);
+
+	void Compile();
+	void Execute(float deltaTime, const float* pViewMatrix, const float* pProjectionMatrix);
+
+	const RenderGraphCompiler& GetCompiler() const { return m_compiler; }
+
+private:
+	struct FrameBufferDescriptor
+	{
+		StringCrc sizeSource;
+		uint8_t sizeShift;
+		bgfx::TextureFormat::Enum format;
+		uint64_t flags;
+	};
+
+	struct TransientFrameBuffer
+	{
+		StringCrc resourceCrc;
+		uint32_t resourceIndex;
+	};
+
+	struct PhysicalFrameBuffer
+	{
+		bgfx::FrameBufferHandle handle = BGFX_INVALID_HANDLE;
+		uint64_t aliasKey = RenderGraphCompiler::ImportedAliasKey;
+		uint16_t width = 0;
+		uint16_t height = 0;
+	};
+
+	uint32_t GetResourceIndex(StringCrc resourceCrc);
+	bool UpdatePassEnables();
+	void UpdateTransientFrameBuffers();
+	void UpdateViewOrder();
+
+private:
+	RenderContext* m_pRenderContext = nullptr;
+	RenderGraphCompiler m_compiler;
+
+	std::vector<std::unique_ptr<Renderer>> m_pPasses;
+	std::vector<uint32_t> m_lastPassOrder;
+	std::unordered_map<uint32_t, uint32_t> m_resourceIndices;
+
+	// Alias key of a transient frame buffer is its descriptor index + 1.
+	std::vector<FrameBufferDescriptor> m_frameBufferDescriptors;
+	std::vector<TransientFrameBuffer> m_transientFrameBuffers;
+	std::vector<PhysicalFrameBuffer> m_physicalFrameBuffers;
+
+	bool m_isCompileNeeded = true;
+	uint16_t m_compiledViewCount = 0;
+
+	std::vector<uint16_t> m_viewRemap;
+	std::vector<uint16_t> m_nextViewRemap;
+};
+
+}
\ No newline at end of file
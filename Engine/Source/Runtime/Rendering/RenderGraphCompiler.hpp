@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace engine
+{
+
+// RenderGraphCompiler works out which passes run, in which order their views execute and which transient resources
+// can share one render target. It only knows indices, RenderGraph maps them to renderers and bgfx resources.
+//
+// Passes execute in declaration order and a read sees the writes declared before it, so renderers drawing on top of
+// the same render target keep their order. Resources are imported (owned outside of the graph) or transient
+// (created by the graph). Transient resources with the same alias key are able to use the same render target.
+class RenderGraphCompiler final
+{
+public:
+	static constexpr uint32_t InvalidIndex = UINT32_MAX;
+	static constexpr uint64_t ImportedAliasKey = 0U;
+
+public:
+	RenderGraphCompiler() = default;
+	RenderGraphCompiler(const RenderGraphCompiler&) = delete;
+	RenderGraphCompiler& operator=(const RenderGraphCompiler&) = delete;
+	RenderGraphCompiler(RenderGraphCompiler&&) = default;
+	RenderGraphCompiler& operator=(RenderGraphCompiler&&) = default;
+	~RenderGraphCompiler() = default;
+
+	uint32_t AddResource(uint64_t aliasKey = ImportedAliasKey)
+	{
+		m_resources.emplace_back().aliasKey = aliasKey;
+		return static_cast<uint32_t>(m_resources.size() - 1);
+	}
+
+	// Outputs are used after the graph, e.g. the render target shown by editor or the back buffer.
+	void MarkOutput(uint32_t resourceIndex) { m_resources[resourceIndex].isOutput = true; }
+
+	uint32_t AddPass(std::vector<uint16_t> views)
+	{
+		m_passes.emplace_back().views = std::move(views);
+		return static_cast<uint32_t>(m_passes.size() - 1);
+	}
+
+	void AddRead(uint32_t passIndex, uint32_t resourceIndex) { m_passes[passIndex].reads.push_back(resourceIndex); }
+	void AddWrite(uint32_t passIndex, uint32_t resourceIndex) { m_passes[passIndex].writes.push_back(resourceIndex); }
+	void SetPassEnable(uint32_t passIndex, bool enable) { m_passes[passIndex].isEnable = enable; }
+	bool IsPassEnable(uint32_t passIndex) const { return m_passes[passIndex].isEnable; }
+
+	size_t GetPassCount() const { return m_passes.size(); }
+	size_t GetResourceCount() const { return m_resources.size(); }
+
+	void Compile()
+	{
+		// Walk back from outputs. A pass is live if it writes something a later live pass reads.
+		// Writing a resource doesn't make earlier writes useless, as renderers draw on top of the render target.
+		for (Resource& resource : m_resources)
+		{
+			resource.isNeeded = resource.isOutput;
+		}
+
+		for (size_t passIndex = m_passes.size(); passIndex-- > 0;)
+		{
+			Pass& pass = m_passes[passIndex];
+			pass.isLive = pass.isEnable && std::any_of(pass.writes.begin(), pass.writes.end(), [this](uint32_t resourceIndex)
+			{
+				return m_resources[resourceIndex].isNeeded;
+			});
+
+			if (pass.isLive)
+			{
+				for (uint32_t resourceIndex : pass.reads)
+				{
+					m_resources[resourceIndex].isNeeded = true;
+				}
+			}
+		}
+
+		m_passOrder.clear();
+		m_viewOrder.clear();
+		for (uint32_t passIndex = 0; passIndex < m_passes.size(); ++passIndex)
+		{
+			if (m_passes[passIndex].isLive)
+			{
+				m_passOrder.push_back(passIndex);
+				m_viewOrder.insert(m_viewOrder.end(), m_passes[passIndex].views.begin(), m_passes[passIndex].views.end());
+			}
+		}
+
+		for (const Pass& pass : m_passes)
+		{
+			if (!pass.isLive)
+			{
+				m_viewOrder.insert(m_viewOrder.end(), pass.views.begin(), pass.views.end());
+			}
+		}
+
+		AssignPhysicalResources();
+	}
+
+	// Indices of live passes in execution order.
+	const std::vector<uint32_t>& GetPassOrder() const { return m_passOrder; }
+	bool IsPassLive(uint32_t passIndex) const { return m_passes[passIndex].isLive; }
+
+	// Views of all passes in execution order. Views of culled passes are at the end.
+	const std::vector<uint16_t>& GetViewOrder() const { return m_viewOrder; }
+
+	// Table for bgfx::setViewOrder, the entry at a position is the view submitted there. Views of passes take the
+	// positions of pass views in execution order, other views such as editor views keep their places.
+	void BuildViewRemap(uint16_t viewCount, std::vector<uint16_t>& viewRemap) const
+	{
+		viewRemap.resize(viewCount);
+		for (uint16_t viewID = 0; viewID < viewCount; ++viewID)
+		{
+			viewRemap[viewID] = viewID;
+		}
+
+		m_viewSlots = m_viewOrder;
+		std::sort(m_viewSlots.begin(), m_viewSlots.end());
+		for (size_t orderIndex = 0; orderIndex < m_viewOrder.size(); ++orderIndex)
+		{
+			viewRemap[m_viewSlots[orderIndex]] = m_viewOrder[orderIndex];
+		}
+	}
+
+	// Index of the render target used by a transient resource. InvalidIndex if it is imported or no live pass uses it.
+	uint32_t GetPhysicalIndex(uint32_t resourceIndex) const { return m_resources[resourceIndex].physicalIndex; }
+	uint32_t GetPhysicalCount() const { return static_cast<uint32_t>(m_physicalAliasKeys.size()); }
+	uint64_t GetPhysicalAliasKey(uint32_t physicalIndex) const { return m_physicalAliasKeys[physicalIndex]; }
+
+private:
+	struct Resource
+	{
+		uint64_t aliasKey = ImportedAliasKey;
+		bool isOutput = false;
+		bool isNeeded = false;
+
+		// Positions in m_passOrder.
+		uint32_t firstUse = InvalidIndex;
+		uint32_t lastUse = 0U;
+
+		uint32_t physicalIndex = InvalidIndex;
+	};
+
+	struct Pass
+	{
+		std::vector<uint16_t> views;
+		std::vector<uint32_t> reads;
+		std::vector<uint32_t> writes;
+		bool isEnable = true;
+		bool isLive = false;
+	};
+
+	void AssignPhysicalResources()
+	{
+		for (Resource& resource : m_resources)
+		{
+			resource.firstUse = InvalidIndex;
+			resource.lastUse = 0U;
+			resource.physicalIndex = InvalidIndex;
+		}
+
+		for (uint32_t orderIndex = 0; orderIndex < m_passOrder.size(); ++orderIndex)
+		{
+			const Pass& pass = m_passes[m_passOrder[orderIndex]];
+			for (const std::vector<uint32_t>* pAccesses : { &pass.reads, &pass.writes })
+			{
+				for (uint32_t resourceIndex : *pAccesses)
+				{
+					Resource& resource = m_resources[resourceIndex];
+					resource.firstUse = std::min(resource.firstUse, orderIndex);
+					resource.lastUse = std::max(resource.lastUse, orderIndex);
+				}
+			}
+		}
+
+		// A live pass may write a transient which no later pass reads, e.g. a chain it only uses inside, so it still
+		// needs a render target.
+		m_sortedTransients.clear();
+		for (uint32_t resourceIndex = 0; resourceIndex < m_resources.size(); ++resourceIndex)
+		{
+			const Resource& resource = m_resources[resourceIndex];
+			if (ImportedAliasKey != resource.aliasKey && InvalidIndex != resource.firstUse)
+			{
+				m_sortedTransients.push_back(resourceIndex);
+			}
+		}
+
+		std::stable_sort(m_sortedTransients.begin(), m_sortedTransients.end(), [this](uint32_t lhs, uint32_t rhs)
+		{
+			return m_resources[lhs].firstUse < m_resources[rhs].firstUse;
+		});
+
+		// Take the first render target with the same key which is free before the resource is first used.
+		// A pass reading one resource and writing another one never gets the same render target for both.
+		m_physicalAliasKeys.clear();
+		m_physicalLastUses.clear();
+		for (uint32_t resourceIndex : m_sortedTransients)
+		{
+			Resource& resource = m_resources[resourceIndex];
+			for (uint32_t physicalIndex = 0; physicalIndex < m_physicalAliasKeys.size(); ++physicalIndex)
+			{
+				if (m_physicalAliasKeys[physicalIndex] == resource.aliasKey && m_physicalLastUses[physicalIndex] < resource.firstUse)
+				{
+					resource.physicalIndex = physicalIndex;
+					break;
+				}
+			}
+
+			if (InvalidIndex == resource.physicalIndex)
+			{
+				resource.physicalIndex = static_cast<uint32_t>(m_physicalAliasKeys.size());
+				m_physicalAliasKeys.push_back(resource.aliasKey);
+				m_physicalLastUses.push_back(0U);
+			}
+
+			m_physicalLastUses[resource.physicalIndex] = resource.lastUse;
+		}
+	}
+
+private:
+	std::vector<Resource> m_resources;
+	std::vector<Pass> m_passes;
+
+	std::vector<uint32_t> m_passOrder;
+	std::vector<uint16_t> m_viewOrder;
+	mutable std::vector<uint16_t> m_viewSlots;
+
+	std::vector<uint32_t> m_sortedTransients;
+	std::vector<uint64_t> m_physicalAliasKeys;
+	std::vector<uint32_t> m_physicalLastUses;
+};
+
+}
\ No newline at end of file
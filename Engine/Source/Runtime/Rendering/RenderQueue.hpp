@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace engine
+{
+
+// RenderQueue collects draw items of one view and orders them by 64 bits sort keys.
+// Key layout from high to low bits : program (16) | render state (4) | material (20) | depth (24),
+// so draws sharing a program, render state and material textures are adjacent and each group is drawn front to back.
+class RenderQueue final
+{
+public:
+	struct DrawItem
+	{
+		uint64_t key;
+
+		// Index of the draw data owned by the renderer.
+		uint32_t index;
+	};
+
+	static constexpr uint32_t StateBitCount = 4U;
+	static constexpr uint32_t MaterialBitCount = 20U;
+	static constexpr uint32_t DepthBitCount = 24U;
+
+	// materialKey is any hash of material resources, only its high bits are kept.
+	// depth is view space distance, negative values are clamped to 0.
+	static uint64_t MakeKey(uint16_t program, uint8_t renderState, uint64_t materialKey, float depth)
+	{
+		return static_cast<uint64_t>(program) << (StateBitCount + MaterialBitCount + DepthBitCount) |
+			static_cast<uint64_t>(renderState & ((1U << StateBitCount) - 1U)) << (MaterialBitCount + DepthBitCount) |
+			(materialKey >> (64U - MaterialBitCount)) << DepthBitCount |
+			EncodeDepth(depth);
+	}
+
+	// Bits of non negative floats are ordered as unsigned integers. Keep the exponent and high mantissa bits.
+	static uint64_t EncodeDepth(float depth)
+	{
+		if (!(depth > 0.0f))
+		{
+			return 0U;
+		}
+
+		uint32_t bits;
+		std::memcpy(&bits, &depth, sizeof(bits));
+		return bits >> (31U - DepthBitCount);
+	}
+
+public:
+	RenderQueue() = default;
+	RenderQueue(const RenderQueue&) = delete;
+	RenderQueue& operator=(const RenderQueue&) = delete;
+	RenderQueue(RenderQueue&&) = default;
+	RenderQueue& operator=(RenderQueue&&) = default;
+	~RenderQueue() = default;
+
+	void Clear() { m_items.clear(); }
+	void Add(uint64_t key, uint32_t index) { m_items.push_back(DrawItem{ key, index }); }
+
+	size_t GetCount() const { return m_items.size(); }
+	const std::vector<DrawItem>& GetItems() const { return m_items; }
+
+	// Stable LSD radix sort on 8 bits digits. Digits which are the same for all keys are skipped,
+	// so keys using few programs and materials usually take 4 or 5 passes instead of 8.
+	void Sort()
+	{
+		size_t count = m_items.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		uint32_t histograms[DigitCount][BucketCount] = {};
+		for (const DrawItem& item : m_items)
+		{
+			for (uint32_t digit = 0; digit < DigitCount; ++digit)
+			{
+				++histograms[digit][(item.key >> (digit * 8U)) & 0xFFU];
+			}
+		}
+
+		m_sortBuffer.resize(count);
+		for (uint32_t digit = 0; digit < DigitCount; ++digit)
+		{
+			uint32_t* pHistogram = histograms[digit];
+			if (pHistogram[(m_items[0].key >> (digit * 8U)) & 0xFFU] == count)
+			{
+				continue;
+			}
+
+			uint32_t offset = 0U;
+			for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+			{
+				uint32_t bucketCount = pHistogram[bucket];
+				pHistogram[bucket] = offset;
+				offset += bucketCount;
+			}
+
+			for (const DrawItem& item : m_items)
+			{
+				m_sortBuffer[pHistogram[(item.key >> (digit * 8U)) & 0xFFU]++] = item;
+			}
+			m_items.swap(m_sortBuffer);
+		}
+	}
+
+private:
+	static constexpr uint32_t DigitCount = 8U;
+	static constexpr uint32_t BucketCount = 256U;
+
+	std::vector<DrawItem> m_items;
+	std::vector<DrawItem> m_sortBuffer;
+};
+
+}
\ No newline at end of file
@@ -2,26 +2,66 @@
 
 #include <bgfx/bgfx.h>
 
+#include <cassert>
+
 namespace engine
 {
 
+namespace
+{
+
+bgfx::TextureFormat::Enum ToBGFXTextureFormat(TextureFormat textureFormat)
+{
+	switch (textureFormat)
+	{
+	case TextureFormat::RGBA16F:
+		return bgfx::TextureFormat::RGBA16F;
+	case TextureFormat::R11G11B10F:
+		return bgfx::TextureFormat::RG11B10F;
+	case TextureFormat::D32F:
+		return bgfx::TextureFormat::D32F;
+	case TextureFormat::RGBA32F:
+	default:
+		return bgfx::TextureFormat::RGBA32F;
+	}
+}
+
+}
+
 RenderTarget::RenderTarget(uint16_t width, uint16_t height, void* hwnd) :
 	m_hwnd(hwnd)
 {
 	Resize(width, height);
 }
 
-RenderTarget::RenderTarget(uint16_t width, uint16_t height, std::vector<AttachmentDescriptor> attachmentDescs) :
-	m_attachmentDescriptors(std::move(attachmentDescs))
+RenderTarget::RenderTarget(uint16_t width, uint16_t height, std::vector<AttachmentDescriptor> attachmentDescs, bool isPingPong) :
+	m_attachmentDescriptors(std::move(attachmentDescs)),
+	m_isPingPong(isPingPong)
 {
 	Resize(width, height);
 }
 
+RenderTarget::~RenderTarget()
+{
+	// Ping-pong frame buffers were created without owning their textures.
+	if (m_isPingPong && m_pFrameBufferHandle)
+	{
+		DestroyPingPongResources();
+	}
+}
+
 bgfx::TextureHandle RenderTarget::GetTextureHandle(int index) const
 {
 	return bgfx::getTexture(*m_pFrameBufferHandle.get(), index);
 }
 
+void RenderTarget::SwapColor()
+{
+	assert(m_isPingPong && "Only ping-pong render targets have two colors.");
+	m_colorIndex ^= 1U;
+	*m_pFrameBufferHandle = m_frameBufferHandles[m_colorIndex];
+}
+
 void RenderTarget::Resize(uint16_t width, uint16_t height)
 {
 	if (width == m_width && height == m_height)
@@ -36,6 +76,10 @@ void RenderTarget::Resize(uint16_t width, uint16_t height)
 	{
 		m_pFrameBufferHandle = std::make_unique<bgfx::FrameBufferHandle>();
 	}
+	else if (m_isPingPong)
+	{
+		DestroyPingPongResources();
+	}
 	else
 	{
 		// When creating the frame buffer, we specified the flag to auto release textures.
@@ -53,23 +97,49 @@ void RenderTarget::Resize(uint16_t width, uint16_t height)
 		for (const auto& attachmentDescriptor : m_attachmentDescriptors)
 		{
 			const uint64_t tsFlags = BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
-			bgfx::TextureFormat::Enum textureFormat;
-			switch (attachmentDescriptor.textureFormat)
+			textureHandles.push_back(bgfx::createTexture2D(width, height, false, 1, ToBGFXTextureFormat(attachmentDescriptor.textureFormat), tsFlags));
+		}
+
+		if (m_isPingPong)
+		{
+			const uint64_t tsFlags = BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
+			bgfx::TextureHandle colorHandles[2] = { textureHandles[0],
+				bgfx::createTexture2D(width, height, false, 1, ToBGFXTextureFormat(m_attachmentDescriptors[0].textureFormat), tsFlags) };
+			m_pingPongTextureHandles = textureHandles;
+			m_pingPongTextureHandles.push_back(colorHandles[1]);
+
+			for (int index = 0; index < 2; ++index)
 			{
-			case TextureFormat::D32F:
-				textureFormat = bgfx::TextureFormat::D32F;
-				break;
-			case TextureFormat::RGBA32F:
-			default:
-				textureFormat = bgfx::TextureFormat::RGBA32F;
-				break;
-			};
-			textureHandles.push_back(bgfx::createTexture2D(width, height, false, 1, textureFormat, tsFlags));
+				textureHandles[0] = colorHandles[index];
+				m_frameBufferHandles[index] = bgfx::createFrameBuffer(static_cast<uint8_t>(textureHandles.size()), textureHandles.data(), false);
+				m_colorFrameBufferHandles[index] = bgfx::createFrameBuffer(1, &colorHandles[index], false);
+			}
+			*m_pFrameBufferHandle = m_frameBufferHandles[m_colorIndex];
+		}
+		else
+		{
+			*m_pFrameBufferHandle = bgfx::createFrameBuffer(static_cast<uint8_t>(textureHandles.size()), textureHandles.data(), true);
 		}
-		*m_pFrameBufferHandle = bgfx::createFrameBuffer(static_cast<uint8_t>(textureHandles.size()), textureHandles.data(), true);
 	}
 
 	OnResize.Invoke(m_width, m_height);
 }
 
+void RenderTarget::DestroyPingPongResources()
+{
+	for (int index = 0; index < 2; ++index)
+	{
+		bgfx::destroy(m_frameBufferHandles[index]);
+		bgfx::destroy(m_colorFrameBufferHandles[index]);
+		m_frameBufferHandles[index] = BGFX_INVALID_HANDLE;
+		m_colorFrameBufferHandles[index] = BGFX_INVALID_HANDLE;
+	}
+
+	for (bgfx::TextureHandle textureHandle : m_pingPongTextureHandles)
+	{
+		bgfx::destroy(textureHandle);
+	}
+	m_pingPongTextureHandles.clear();
+}
+
 }
\ No newline at end of file
@@ -21,6 +21,10 @@ namespace engine
 enum class TextureFormat
 {
 	RGBA32F,
+	// Half of RGBA32F size, enough for HDR scene colors.
+	RGBA16F,
+	// 32 bits HDR color without alpha.
+	R11G11B10F,
 	D32F
 };
 
@@ -34,14 +38,16 @@ class RenderTarget
 public:
 	RenderTarget() = delete;
 	explicit RenderTarget(uint16_t width, uint16_t height, void* hwnd);
-	explicit RenderTarget(uint16_t width, uint16_t height, std::vector<AttachmentDescriptor> attachmentDescs);
+	// A ping-pong render target has two color textures for the first attachment and shares the other attachments.
+	explicit RenderTarget(uint16_t width, uint16_t height, std::vector<AttachmentDescriptor> attachmentDescs, bool isPingPong = false);
 	RenderTarget(const RenderTarget&) = delete;
 	RenderTarget& operator=(const RenderTarget&) = delete;
 	RenderTarget(RenderTarget&&) = delete;
 	RenderTarget& operator=(RenderTarget&&) = delete;
-	~RenderTarget() = default;
+	~RenderTarget();
 
 	bool IsSwapChainTarget() const { return m_hwnd != nullptr && m_attachmentDescriptors.empty(); }
+	bool IsPingPong() const { return m_isPingPong; }
 	uint16_t GetWidth() const { return m_width; }
 	uint16_t GetHeight() const { return m_height; }
 	void Resize(uint16_t width, uint16_t height);
@@ -50,9 +56,18 @@ public:
 	const bgfx::FrameBufferHandle* GetFrameBufferHandle() const { return m_pFrameBufferHandle.get(); }
 	bgfx::TextureHandle GetTextureHandle(int index) const;
 
+	// Post processing passes sample the current color, then swap and draw to the color only frame buffer,
+	// so they don't copy the scene color and don't bind other attachments they may sample.
+	// GetFrameBufferHandle and GetTextureHandle follow the current color.
+	void SwapColor();
+	const bgfx::FrameBufferHandle* GetColorFrameBufferHandle() const { return &m_colorFrameBufferHandles[m_colorIndex]; }
+
 public:
 	MulticastDelegate<void(uint16_t, uint16_t)> OnResize;
 
+private:
+	void DestroyPingPongResources();
+
 private:
 	uint16_t m_width = 0;
 	uint16_t m_height = 0;
@@ -60,6 +75,13 @@ private:
 	std::vector<AttachmentDescriptor> m_attachmentDescriptors;
 
 	std::unique_ptr<bgfx::FrameBufferHandle> m_pFrameBufferHandle;
+
+	// Ping-pong frame buffers don't own their textures as attachments are shared.
+	bool m_isPingPong = false;
+	uint8_t m_colorIndex = 0;
+	bgfx::FrameBufferHandle m_frameBufferHandles[2] = { BGFX_INVALID_HANDLE, BGFX_INVALID_HANDLE };
+	bgfx::FrameBufferHandle m_colorFrameBufferHandles[2] = { BGFX_INVALID_HANDLE, BGFX_INVALID_HANDLE };
+	std::vector<bgfx::TextureHandle> m_pingPongTextureHandles;
 };
 
 }
\ No newline at end of file
@@ -40,6 +40,15 @@ void Renderer::UpdateViewRenderTarget()
 	}
 }
 
+bgfx::TextureHandle Renderer::SwapViewRenderTargetColor(uint16_t viewID)
+{
+	assert(m_pRenderTarget && m_pRenderTarget->IsPingPong());
+	bgfx::TextureHandle colorTextureHandle = m_pRenderTarget->GetTextureHandle(0);
+	m_pRenderTarget->SwapColor();
+	bgfx::setViewFrameBuffer(viewID, *m_pRenderTarget->GetColorFrameBufferHandle());
+	return colorTextureHandle;
+}
+
 struct PosColorTexCoord0Vertex
 {
 	float m_x;
@@ -141,19 +150,31 @@ void Renderer::ScreenSpaceQuad(const RenderTarget* pRenderTarget, bool _originBo
 
 void Renderer::UpdateStaticMeshComponent(StaticMeshComponent* pMeshComponent)
 {
-	bgfx::setVertexBuffer(0, bgfx::VertexBufferHandle{pMeshComponent->GetVertexBuffer()}, pMeshComponent->GetStartVertex(), pMeshComponent->GetVertexCount());
 #ifdef EDITOR_MODE
 	if (pMeshComponent->IsProgressiveMeshValid())
 	{
 		pMeshComponent->UpdateProgressiveMeshData();
-		bgfx::setIndexBuffer(bgfx::DynamicIndexBufferHandle{pMeshComponent->GetIndexBuffer()}, pMeshComponent->GetStartIndex(), pMeshComponent->GetIndexCount());
+	}
+#endif
+
+	// bgfx::begin returns the main thread encoder.
+	SetStaticMeshBuffers(bgfx::begin(), pMeshComponent);
+}
+
+void Renderer::SetStaticMeshBuffers(bgfx::Encoder* pEncoder, const StaticMeshComponent* pMeshComponent)
+{
+	pEncoder->setVertexBuffer(0, bgfx::VertexBufferHandle{pMeshComponent->GetVertexBuffer()}, pMeshComponent->GetStartVertex(), pMeshComponent->GetVertexCount());
+#ifdef EDITOR_MODE
+	if (pMeshComponent->IsProgressiveMeshValid())
+	{
+		pEncoder->setIndexBuffer(bgfx::DynamicIndexBufferHandle{pMeshComponent->GetIndexBuffer()}, pMeshComponent->GetStartIndex(), pMeshComponent->GetIndexCount());
 	}
 	else
 	{
-		bgfx::setIndexBuffer(bgfx::IndexBufferHandle{pMeshComponent->GetIndexBuffer()}, pMeshComponent->GetStartIndex(), pMeshComponent->GetIndexCount());
+		pEncoder->setIndexBuffer(bgfx::IndexBufferHandle{pMeshComponent->GetIndexBuffer()}, pMeshComponent->GetStartIndex(), pMeshComponent->GetIndexCount());
 	}
 #else
-	bgfx::setIndexBuffer(bgfx::IndexBufferHandle{pMeshComponent->GetIndexBuffer()}, pMeshComponent->GetStartIndex(), pMeshComponent->GetIndexCount());
+	pEncoder->setIndexBuffer(bgfx::IndexBufferHandle{pMeshComponent->GetIndexBuffer()}, pMeshComponent->GetStartIndex(), pMeshComponent->GetIndexCount());
 #endif
 }
 
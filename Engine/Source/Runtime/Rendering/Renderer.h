@@ -2,6 +2,14 @@
 
 #include <cstdint>
 
+namespace bgfx
+{
+
+struct Encoder;
+struct TextureHandle;
+
+}
+
 namespace engine
 {
 
@@ -31,14 +39,25 @@ public:
 	uint16_t GetViewID() const { return m_viewID; }
 	
 	void UpdateViewRenderTarget();
+
+	// For post processing passes drawing to a ping-pong render target. Returns the current color to sample,
+	// then swaps colors and binds the other one to the view.
+	bgfx::TextureHandle SwapViewRenderTargetColor(uint16_t viewID);
 	void SetRenderTarget(RenderTarget* pRenderTarget) { m_pRenderTarget = pRenderTarget; }
 	const RenderTarget* GetRenderTarget() const { return m_pRenderTarget; }
 
 	virtual void SetEnable(bool value) { m_isEnable = value; }
 	virtual bool IsEnable() const { return m_isEnable; }
 
+	// Called by RenderGraph when a live pass is culled. UpdateView and Render are not called until it is live again,
+	// so pooled render targets should go back to the pool here.
+	virtual void OnCulled() {}
+
 	void UpdateStaticMeshComponent(StaticMeshComponent* pMeshComponent);
 
+	// Only sets vertex and index buffers, so it is safe on submit threads. Progressive mesh data should be updated before.
+	static void SetStaticMeshBuffers(bgfx::Encoder* pEncoder, const StaticMeshComponent* pMeshComponent);
+
 public:
 	static void ScreenSpaceQuad(const RenderTarget* pRenderTarget, bool _originBottomLeft = false, float _width = 1.0f, float _height = 1.0f);
 
@@ -6,12 +6,10 @@
 #include "ECWorld/SkyComponent.h"
 #include "ECWorld/StaticMeshComponent.h"
 #include "ECWorld/TransformComponent.h"
-#include "LightUniforms.h"
 #include "Material/ShaderSchema.h"
 #include "Math/Transform.hpp"
 #include "RenderContext.h"
 #include "Scene/Texture.h"
-#include "U_IBL.sh"
 #include "U_Terrain.sh"
 
 namespace engine
@@ -30,23 +28,6 @@ constexpr const char* rockTexture = "Textures/terrain/rock_baseColor.dds";
 constexpr const char* grassTexture = "Textures/terrain/grass_baseColor.dds";
 constexpr const char* elevationTexture = "Terrain";
 
-constexpr const char* lutSampler = "s_texLUT";
-constexpr const char* cubeIrradianceSampler = "s_texCubeIrr";
-constexpr const char* cubeRadianceSampler = "s_texCubeRad";
-
-constexpr const char* lutTexture = "Textures/lut/ibl_brdf_lut.dds";
-
-constexpr const char* cameraPos = "u_cameraPos";
-
-constexpr const char* albedoColor = "u_albedoColor";
-constexpr const char* metallicRoughnessFactor = "u_metallicRoughnessFactor";
-constexpr const char* albedoUVOffsetAndScale = "u_albedoUVOffsetAndScale";
-constexpr const char* alphaCutOff = "u_alphaCutOff";
-constexpr const char* emissiveColor = "u_emissiveColor";
-
-constexpr const char* lightCountAndStride = "u_lightCountAndStride";
-constexpr const char* lightParams = "u_lightParams";
-
 constexpr uint64_t samplerFlags = BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP | BGFX_SAMPLER_W_CLAMP;
 constexpr uint64_t defaultRenderingState = BGFX_STATE_WRITE_MASK | BGFX_STATE_MSAA | BGFX_STATE_DEPTH_TEST_LESS;
 
@@ -54,34 +35,15 @@ constexpr uint64_t defaultRenderingState = BGFX_STATE_WRITE_MASK | BGFX_STATE_MS
 
 void TerrainRenderer::Init()
 {
-	SkyComponent* pSkyComponent = m_pCurrentSceneWorld->GetSkyComponent(m_pCurrentSceneWorld->GetSkyEntity());
-	
-	GetRenderContext()->CreateProgram("TerrainProgram", "vs_terrain.bin", "fs_terrain.bin");
-	GetRenderContext()->CreateUniform(snowSampler, bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(rockSampler, bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(grassSampler, bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(elevationSampler, bgfx::UniformType::Sampler);
-
-	GetRenderContext()->CreateTexture(snowTexture);
-	GetRenderContext()->CreateTexture(rockTexture);
-	GetRenderContext()->CreateTexture(grassTexture);
-	GetRenderContext()->CreateTexture(elevationTexture);
-
-	GetRenderContext()->CreateTexture(lutTexture);
-	GetRenderContext()->CreateTexture(pSkyComponent->GetIrradianceTexturePath().c_str(), samplerFlags);
-	GetRenderContext()->CreateTexture(pSkyComponent->GetRadianceTexturePath().c_str(), samplerFlags);
-
-	GetRenderContext()->CreateUniform(cameraPos, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(albedoColor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(emissiveColor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(metallicRoughnessFactor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(albedoUVOffsetAndScale, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(alphaCutOff, bgfx::UniformType::Vec4, 1);
-
-	GetRenderContext()->CreateUniform(lightCountAndStride, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(lightParams, bgfx::UniformType::Vec4, LightUniform::VEC4_COUNT);
-
-	GetRenderContext()->CreateTexture(elevationTexture, 129U, 129U, 1, bgfx::TextureFormat::Enum::R32F, samplerFlags, nullptr, 0);
+	// Handles are resolved once here so draws don't look them up by name. Sky textures are bound from FrameConstants.
+	m_terrainProgram = GetRenderContext()->CreateProgram("TerrainProgram", "vs_terrain.bin", "fs_terrain.bin");
+	m_snowTexture = TextureBinding{ GetRenderContext()->CreateUniform(snowSampler, bgfx::UniformType::Sampler), GetRenderContext()->CreateTexture(snowTexture) };
+	m_rockTexture = TextureBinding{ GetRenderContext()->CreateUniform(rockSampler, bgfx::UniformType::Sampler), GetRenderContext()->CreateTexture(rockTexture) };
+	m_grassTexture = TextureBinding{ GetRenderContext()->CreateUniform(grassSampler, bgfx::UniformType::Sampler), GetRenderContext()->CreateTexture(grassTexture) };
+	m_elevationTexture = TextureBinding{ GetRenderContext()->CreateUniform(elevationSampler, bgfx::UniformType::Sampler),
+		GetRenderContext()->CreateTexture(elevationTexture, 129U, 129U, 1, bgfx::TextureFormat::Enum::R32F, samplerFlags, nullptr, 0) };
+
+	m_materialUniforms.Init(GetRenderContext());
 
 	bgfx::setViewName(GetViewID(), "TerrainRenderer");
 }
@@ -94,113 +56,65 @@ void TerrainRenderer::UpdateView(const float* pViewMatrix, const float* pProject
 
 void TerrainRenderer::Render(float deltaTime)
 {
-	// TODO : Remove it. If every renderer need to submit camera related uniform, it should be done not inside Renderer class.
-	const cd::Transform& cameraTransform = m_pCurrentSceneWorld->GetTransformComponent(m_pCurrentSceneWorld->GetMainCameraEntity())->GetTransform();
-	for (Entity entity : m_pCurrentSceneWorld->GetTerrainEntities())
-	{		
-		MaterialComponent* pMaterialComponent = m_pCurrentSceneWorld->GetMaterialComponent(entity);
-		if (!pMaterialComponent ||
-			pMaterialComponent->GetMaterialType() != m_pCurrentSceneWorld->GetTerrainMaterialType())
+	// Camera and light uniforms are shared by all draws.
+	const FrameConstants& frameConstants = GetRenderContext()->GetFrameConstants();
+	frameConstants.Submit();
+
+	auto terrainView = m_pCurrentSceneWorld->GetWorld()->View<TerrainComponent, MaterialComponent, StaticMeshComponent, TransformComponent>();
+	const ComponentsStorage<TerrainComponent>* pTerrainStorage = m_pCurrentSceneWorld->GetWorld()->GetComponents<TerrainComponent>();
+	const CullingSystem* pCullingSystem = m_pCurrentSceneWorld->GetCullingSystem();
+	terrainView.Each([&](Entity entity, TerrainComponent& terrainComponent, MaterialComponent& materialComponent,
+		StaticMeshComponent& meshComponent, TransformComponent& transformComponent)
+	{
+		if (!pCullingSystem->IsVisible(entity))
 		{
-			// TODO : improve this condition. As we want to skip some feature-specified entities to render.
-			// For example, terrain/particle/...
-			continue;
+			return;
 		}
 
-		// No mesh attached?
-		StaticMeshComponent* pMeshComponent = m_pCurrentSceneWorld->GetStaticMeshComponent(entity);
-		if (!pMeshComponent)
+		MaterialComponent* pMaterialComponent = &materialComponent;
+		if (pMaterialComponent->GetMaterialType() != m_pCurrentSceneWorld->GetTerrainMaterialType())
 		{
-			continue;
+			// TODO : improve this condition. As we want to skip some feature-specified entities to render.
+			// For example, terrain/particle/...
+			return;
 		}
 
+		StaticMeshComponent* pMeshComponent = &meshComponent;
+
 		// Transform
-		if (TransformComponent* pTransformComponent = m_pCurrentSceneWorld->GetTransformComponent(entity))
-		{
-			bgfx::setTransform(pTransformComponent->GetWorldMatrix().Begin());
-		}
+		bgfx::setTransform(transformComponent.GetWorldMatrix().Begin());
 
 		// Mesh
 		bgfx::setVertexBuffer(0, bgfx::VertexBufferHandle{pMeshComponent->GetVertexBuffer()});
 		bgfx::setIndexBuffer(bgfx::IndexBufferHandle{pMeshComponent->GetIndexBuffer()});
 
 		// Material
-		bgfx::setTexture(TERRAIN_TOP_ALBEDO_MAP_SLOT,
-			GetRenderContext()->GetUniform(StringCrc(snowSampler)),
-			GetRenderContext()->GetTexture(StringCrc(snowTexture)));
-
-		bgfx::setTexture(TERRAIN_MEDIUM_ALBEDO_MAP_SLOT,
-			GetRenderContext()->GetUniform(StringCrc(rockSampler)),
-			GetRenderContext()->GetTexture(StringCrc(rockTexture)));
-
-		bgfx::setTexture(TERRAIN_BOTTOM_ALBEDO_MAP_SLOT,
-			GetRenderContext()->GetUniform(StringCrc(grassSampler)),
-			GetRenderContext()->GetTexture(StringCrc(grassTexture)));
-
-		TerrainComponent* pTerrainComponent = m_pCurrentSceneWorld->GetTerrainComponent(entity);
-		GetRenderContext()->UpdateTexture(elevationTexture, 0, 0, 0, 0, 0, pTerrainComponent->GetTexWidth(), pTerrainComponent->GetTexDepth(),
-			1, pTerrainComponent->GetElevationRawData(), pTerrainComponent->GetElevationRawDataSize());
+		bgfx::setTexture(TERRAIN_TOP_ALBEDO_MAP_SLOT, m_snowTexture.sampler, m_snowTexture.texture);
+		bgfx::setTexture(TERRAIN_MEDIUM_ALBEDO_MAP_SLOT, m_rockTexture.sampler, m_rockTexture.texture);
+		bgfx::setTexture(TERRAIN_BOTTOM_ALBEDO_MAP_SLOT, m_grassTexture.sampler, m_grassTexture.texture);
+
+		// Upload elevation only when another terrain is drawn or its data changed.
+		TerrainComponent* pTerrainComponent = &terrainComponent;
+		uint32_t elevationVersion = pTerrainStorage->GetVersion(entity);
+		if (entity != m_elevationEntity || elevationVersion != m_elevationVersion)
+		{
+			GetRenderContext()->UpdateTexture(elevationTexture, 0, 0, 0, 0, 0, pTerrainComponent->GetTexWidth(), pTerrainComponent->GetTexDepth(),
+				1, pTerrainComponent->GetElevationRawData(), pTerrainComponent->GetElevationRawDataSize());
+			m_elevationEntity = entity;
+			m_elevationVersion = elevationVersion;
+		}
 
-		bgfx::setTexture(TERRAIN_ELEVATION_MAP_SLOT,
-			GetRenderContext()->GetUniform(StringCrc(elevationSampler)),
-			GetRenderContext()->GetTexture(StringCrc(elevationTexture)));
+		bgfx::setTexture(TERRAIN_ELEVATION_MAP_SLOT, m_elevationTexture.sampler, m_elevationTexture.texture);
 
 		// Sky
-		SkyComponent* pSkyComponent = m_pCurrentSceneWorld->GetSkyComponent(m_pCurrentSceneWorld->GetSkyEntity());
-		SkyType crtSkyType = pSkyComponent->GetSkyType();
-		pMaterialComponent->SetSkyType(crtSkyType);
-
-		if (crtSkyType == SkyType::SkyBox)
+		pMaterialComponent->SetSkyType(frameConstants.GetSkyType());
+		if (SkyType::SkyBox == frameConstants.GetSkyType())
 		{
-			// Create a new TextureHandle each frame if the skybox texture path has been updated,
-			// otherwise RenderContext::CreateTexture will automatically skip it.
-
-			constexpr StringCrc irrSamplerCrc(cubeIrradianceSampler);
-			GetRenderContext()->CreateTexture(pSkyComponent->GetIrradianceTexturePath().c_str(), samplerFlags);
-			bgfx::setTexture(IBL_IRRADIANCE_SLOT,
-				GetRenderContext()->GetUniform(irrSamplerCrc),
-				GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetIrradianceTexturePath())));
-
-			constexpr StringCrc radSamplerCrc(cubeRadianceSampler);
-			GetRenderContext()->CreateTexture(pSkyComponent->GetRadianceTexturePath().c_str(), samplerFlags);
-			bgfx::setTexture(IBL_RADIANCE_SLOT,
-				GetRenderContext()->GetUniform(radSamplerCrc),
-				GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetRadianceTexturePath())));
-
-			constexpr StringCrc lutsamplerCrc(lutSampler);
-			constexpr StringCrc luttextureCrc(lutTexture);
-			bgfx::setTexture(BRDF_LUT_SLOT, GetRenderContext()->GetUniform(lutsamplerCrc), GetRenderContext()->GetTexture(luttextureCrc));
+			frameConstants.SubmitSkyTextures();
 		}
 
-		// Submit uniform values : camera settings
-		constexpr StringCrc cameraPosCrc(cameraPos);
-		GetRenderContext()->FillUniform(cameraPosCrc, &cameraTransform.GetTranslation().x(), 1);
-
 		// Submit uniform values : material settings
-		constexpr StringCrc albedoColorCrc(albedoColor);
-		GetRenderContext()->FillUniform(albedoColorCrc, pMaterialComponent->GetAlbedoColor().Begin(), 1);
-
-		constexpr StringCrc mrFactorCrc(metallicRoughnessFactor);
-		cd::Vec4f metallicRoughnessFactorData(pMaterialComponent->GetMetallicFactor(), pMaterialComponent->GetRoughnessFactor(), 1.0f, 1.0f);
-		GetRenderContext()->FillUniform(mrFactorCrc, metallicRoughnessFactorData.Begin(), 1);
-
-		constexpr StringCrc emissiveColorCrc(emissiveColor);
-		GetRenderContext()->FillUniform(emissiveColorCrc, pMaterialComponent->GetEmissiveColor().Begin(), 1);
-
-		// Submit uniform values : light settings
-		auto lightEntities = m_pCurrentSceneWorld->GetLightEntities();
-		size_t lightEntityCount = lightEntities.size();
-		constexpr engine::StringCrc lightCountAndStrideCrc(lightCountAndStride);
-		static cd::Vec4f lightInfoData(0, LightUniform::LIGHT_STRIDE, 0.0f, 0.0f);
-		lightInfoData.x() = static_cast<float>(lightEntityCount);
-		GetRenderContext()->FillUniform(lightCountAndStrideCrc, lightInfoData.Begin(), 1);
-		if (lightEntityCount > 0)
-		{
-			// Light component storage has continus memory address and layout.
-			float* pLightDataBegin = reinterpret_cast<float*>(m_pCurrentSceneWorld->GetLightComponent(lightEntities[0]));
-			constexpr engine::StringCrc lightParamsCrc(lightParams);
-			GetRenderContext()->FillUniform(lightParamsCrc, pLightDataBegin, static_cast<uint16_t>(lightEntityCount * LightUniform::LIGHT_STRIDE));
-		}
+		m_materialUniforms.Submit(*pMaterialComponent);
 
 		uint64_t state = defaultRenderingState;
 		if (!pMaterialComponent->GetTwoSided())
@@ -210,9 +124,8 @@ void TerrainRenderer::Render(float deltaTime)
 
 		bgfx::setState(state);
 
-		constexpr StringCrc terrainProgram("TerrainProgram");
-		bgfx::submit(GetViewID(), GetRenderContext()->GetProgram(terrainProgram));
-	}
+		bgfx::submit(GetViewID(), m_terrainProgram);
+	});
 }
 
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "ECWorld/Entity.h"
+#include "MaterialDrawPacket.h"
 #include "Renderer.h"
 
 namespace engine
@@ -19,7 +21,25 @@ public:
 	void SetSceneWorld(SceneWorld* pSceneWorld) { m_pCurrentSceneWorld = pSceneWorld; }
 
 private:
+	struct TextureBinding
+	{
+		bgfx::UniformHandle sampler = BGFX_INVALID_HANDLE;
+		bgfx::TextureHandle texture = BGFX_INVALID_HANDLE;
+	};
+
 	SceneWorld* m_pCurrentSceneWorld = nullptr;
+
+	// Resolved once in Init.
+	bgfx::ProgramHandle m_terrainProgram = BGFX_INVALID_HANDLE;
+	TextureBinding m_snowTexture;
+	TextureBinding m_rockTexture;
+	TextureBinding m_grassTexture;
+	TextureBinding m_elevationTexture;
+	MaterialUniforms m_materialUniforms;
+
+	// Which terrain data the elevation texture holds now.
+	Entity m_elevationEntity = INVALID_ENTITY;
+	uint32_t m_elevationVersion = 0U;
 };
 
 }
\ No newline at end of file
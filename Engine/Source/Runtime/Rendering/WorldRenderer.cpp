@@ -1,18 +1,22 @@
 #include "WorldRenderer.h"
 
+#include "Base/Template.h"
 #include "ECWorld/CameraComponent.h"
 #include "ECWorld/MaterialComponent.h"
 #include "ECWorld/SceneWorld.h"
 #include "ECWorld/SkyComponent.h"
 #include "ECWorld/StaticMeshComponent.h"
 #include "ECWorld/TransformComponent.h"
-#include "LightUniforms.h"
 #include "Material/ShaderSchema.h"
 #include "Math/Transform.hpp"
 #include "RenderContext.h"
 #include "Scene/Texture.h"
-#include "U_IBL.sh"
-#include "U_AtmophericScattering.sh"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <execution>
+#include <thread>
 
 namespace engine
 {
@@ -20,57 +24,64 @@ namespace engine
 namespace
 {
 
-constexpr const char* lutSampler                  = "s_texLUT";
-constexpr const char* cubeIrradianceSampler       = "s_texCubeIrr";
-constexpr const char* cubeRadianceSampler         = "s_texCubeRad";
-											      
-constexpr const char* lutTexture                  = "Textures/lut/ibl_brdf_lut.dds";
-											      
-constexpr const char* cameraPos                   = "u_cameraPos";
-constexpr const char* albedoColor                 = "u_albedoColor";
-constexpr const char* emissiveColor               = "u_emissiveColor";
-constexpr const char* metallicRoughnessFactor     = "u_metallicRoughnessFactor";
-											      
-constexpr const char* albedoUVOffsetAndScale      = "u_albedoUVOffsetAndScale";
-constexpr const char* alphaCutOff                 = "u_alphaCutOff";
-											      
-constexpr const char* lightCountAndStride         = "u_lightCountAndStride";
-constexpr const char* lightParams                 = "u_lightParams";
-											      
-constexpr const char* LightDir                    = "u_LightDir";
-constexpr const char* HeightOffsetAndshadowLength = "u_HeightOffsetAndshadowLength";
-
-constexpr uint64_t samplerFlags = BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP | BGFX_SAMPLER_W_CLAMP;
 constexpr uint64_t defaultRenderingState = BGFX_STATE_WRITE_MASK | BGFX_STATE_MSAA | BGFX_STATE_DEPTH_TEST_LESS;
 
-}
+// One column major world matrix per instance.
+constexpr uint16_t instanceStride = 64U;
+constexpr uint32_t minInstanceCount = 2U;
 
-void WorldRenderer::Init()
-{
-	SkyComponent* pSkyComponent = m_pCurrentSceneWorld->GetSkyComponent(m_pCurrentSceneWorld->GetSkyEntity());
+// Fewer draws per submit thread don't pay for the task dispatch and the extra encoder.
+constexpr size_t minSubmitThreadDrawCount = 1024U;
 
-	GetRenderContext()->CreateUniform(lutSampler, bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(cubeIrradianceSampler, bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(cubeRadianceSampler, bgfx::UniformType::Sampler);
+constexpr uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t fnvPrime = 1099511628211ULL;
 
-	GetRenderContext()->CreateTexture(lutTexture);
-	GetRenderContext()->CreateTexture(pSkyComponent->GetIrradianceTexturePath().c_str(), samplerFlags);
-	GetRenderContext()->CreateTexture(pSkyComponent->GetRadianceTexturePath().c_str(), samplerFlags);
+CD_FORCEINLINE uint64_t HashCombine(uint64_t hash, uint64_t value)
+{
+	return (hash ^ value) * fnvPrime;
+}
 
-	GetRenderContext()->CreateUniform(cameraPos, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(albedoColor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(emissiveColor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(metallicRoughnessFactor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(albedoUVOffsetAndScale, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(alphaCutOff, bgfx::UniformType::Vec4, 1);
+// Values of per draw material uniforms. Entities can share one instanced draw only if these are equal.
+using MaterialParameters = std::array<float, 15>;
 
-	GetRenderContext()->CreateUniform(lightCountAndStride, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(lightParams, bgfx::UniformType::Vec4, LightUniform::VEC4_COUNT);
+MaterialParameters GetMaterialParameters(const MaterialComponent& materialComponent)
+{
+	MaterialParameters parameters = {};
+	const cd::Vec3f& albedo = materialComponent.GetAlbedoColor();
+	const cd::Vec3f& emissive = materialComponent.GetEmissiveColor();
+	parameters[0] = albedo.x();
+	parameters[1] = albedo.y();
+	parameters[2] = albedo.z();
+	parameters[3] = emissive.x();
+	parameters[4] = emissive.y();
+	parameters[5] = emissive.z();
+	parameters[6] = materialComponent.GetMetallicFactor();
+	parameters[7] = materialComponent.GetRoughnessFactor();
+	parameters[8] = cd::BlendMode::Mask == materialComponent.GetBlendMode() ? materialComponent.GetAlphaCutOff() : 0.0f;
+	if (const MaterialComponent::TextureInfo* pTextureInfo = materialComponent.GetTextureInfo(cd::MaterialTextureType::BaseColor))
+	{
+		parameters[9] = pTextureInfo->GetUVOffset().x();
+		parameters[10] = pTextureInfo->GetUVOffset().y();
+		parameters[11] = pTextureInfo->GetUVScale().x();
+		parameters[12] = pTextureInfo->GetUVScale().y();
+	}
+	parameters[13] = static_cast<float>(materialComponent.GetBlendMode());
+	parameters[14] = materialComponent.GetTwoSided() ? 1.0f : 0.0f;
+	return parameters;
+}
 
-	GetRenderContext()->CreateUniform(LightDir, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(HeightOffsetAndshadowLength, bgfx::UniformType::Vec4, 1);
+}
+
+void WorldRenderer::Init()
+{
+	// Sky textures are bound from FrameConstants.
+	m_materialUniforms.Init(GetRenderContext());
 
 	bgfx::setViewName(GetViewID(), "WorldRenderer");
+
+	// Draws are already sorted by RenderQueue and submitted with their rank as depth.
+	// Unlike ViewMode::Sequential, this keeps the order when submit threads record in parallel.
+	bgfx::setViewMode(GetViewID(), bgfx::ViewMode::DepthAscending);
 }
 
 void WorldRenderer::UpdateView(const float* pViewMatrix, const float* pProjectionMatrix)
@@ -81,151 +92,268 @@ void WorldRenderer::UpdateView(const float* pViewMatrix, const float* pProjectio
 
 void WorldRenderer::Render(float deltaTime)
 {
-	// TODO : Remove it. If every renderer need to submit camera related uniform, it should be done not inside Renderer class.
-	const cd::Transform& cameraTransform = m_pCurrentSceneWorld->GetTransformComponent(m_pCurrentSceneWorld->GetMainCameraEntity())->GetTransform();
-	SkyComponent* pSkyComponent = m_pCurrentSceneWorld->GetSkyComponent(m_pCurrentSceneWorld->GetSkyEntity());
-
-	for (Entity entity : m_pCurrentSceneWorld->GetMaterialEntities())
+	const float* pViewMatrix = m_pCurrentSceneWorld->GetCameraComponent(m_pCurrentSceneWorld->GetMainCameraEntity())->GetViewMatrix().Begin();
+	const FrameConstants& frameConstants = GetRenderContext()->GetFrameConstants();
+	SkyType crtSkyType = frameConstants.GetSkyType();
+
+	// Collect visible draws. Copies of a mesh with equal materials are merged into one instanced draw.
+	m_renderQueue.Clear();
+	m_drawData.clear();
+	m_instanceGroups.clear();
+	m_instanceEntries.clear();
+
+	const bool isInstancingSupported = 0 != (bgfx::getCaps()->supported & BGFX_CAPS_INSTANCING);
+
+	// Blend shape and skin mesh entities are drawn by their own renderers.
+	auto pbrMeshView = m_pCurrentSceneWorld->GetWorld()->View<MaterialComponent, StaticMeshComponent, TransformComponent>(
+		Exclude<BlendShapeComponent, AnimationComponent>{});
+	const CullingSystem* pCullingSystem = m_pCurrentSceneWorld->GetCullingSystem();
+	pbrMeshView.Each([&](Entity entity, MaterialComponent& materialComponent, StaticMeshComponent& meshComponent, TransformComponent& transformComponent)
 	{
-		MaterialComponent* pMaterialComponent = m_pCurrentSceneWorld->GetMaterialComponent(entity);
-		if (!pMaterialComponent ||
-			pMaterialComponent->GetMaterialType() != m_pCurrentSceneWorld->GetPBRMaterialType())
+		if (!pCullingSystem->IsVisible(entity))
+		{
+			return;
+		}
+
+		MaterialComponent* pMaterialComponent = &materialComponent;
+		if (pMaterialComponent->GetMaterialType() != m_pCurrentSceneWorld->GetPBRMaterialType())
 		{
 			// TODO : improve this condition. As we want to skip some feature-specified entities to render.
 			// For example, terrain/particle/...
-			continue;
+			return;
 		}
 
-		// No mesh attached?
-		StaticMeshComponent* pMeshComponent = m_pCurrentSceneWorld->GetStaticMeshComponent(entity);
-		if (!pMeshComponent)
+		// Sky type selects the shader variant so it goes before resolving the packet.
+		pMaterialComponent->SetSkyType(crtSkyType);
+		uint32_t packetIndex = m_drawPackets.Resolve(entity, materialComponent);
+		const MaterialDrawPacket& drawPacket = m_drawPackets.GetPacket(packetIndex);
+		uint64_t textureKey = drawPacket.textureKey;
+
+		uint64_t renderState = defaultRenderingState;
+		if (!pMaterialComponent->GetTwoSided())
 		{
-			continue;
+			renderState |= BGFX_STATE_CULL_CCW;
 		}
 
-		BlendShapeComponent* pBlendShapeComponent = m_pCurrentSceneWorld->GetBlendShapeComponent(entity);
-		if (pBlendShapeComponent)
+		const float* pWorldMatrix = transformComponent.GetWorldMatrix().Begin();
+		float viewDepth = pViewMatrix[2] * pWorldMatrix[12] + pViewMatrix[6] * pWorldMatrix[13] + pViewMatrix[10] * pWorldMatrix[14] + pViewMatrix[14];
+
+		uint16_t program = drawPacket.program;
+		uint16_t instanceProgram = isInstancingSupported ? drawPacket.instanceProgram : ShaderSchema::InvalidProgramHandle;
+#ifdef EDITOR_MODE
+		// Progressive mesh rebuilds index buffers per component. Update them here as submit threads only read meshes.
+		if (meshComponent.IsProgressiveMeshValid())
 		{
-			continue;
+			meshComponent.UpdateProgressiveMeshData();
+			instanceProgram = ShaderSchema::InvalidProgramHandle;
 		}
+#endif
 
-		// SkinMesh
-		if(m_pCurrentSceneWorld->GetAnimationComponent(entity))
+		// Components built from the same mesh data have identical vertex and index buffers.
+		MaterialParameters materialParameters = GetMaterialParameters(materialComponent);
+		uint32_t drawIndex = static_cast<uint32_t>(m_drawData.size());
+		if (instanceProgram != ShaderSchema::InvalidProgramHandle)
 		{
-			continue;
+			uint64_t groupKey = HashCombine(HashCombine(HashCombine(fnvOffsetBasis, reinterpret_cast<uintptr_t>(meshComponent.GetMeshData())), textureKey), program);
+			for (float value : materialParameters)
+			{
+				uint32_t bits;
+				std::memcpy(&bits, &value, sizeof(bits));
+				groupKey = HashCombine(groupKey, bits);
+			}
+
+			auto [itGroup, isNewGroup] = m_instanceGroups.try_emplace(groupKey, drawIndex);
+			if (!isNewGroup)
+			{
+				// Hash collisions fall back to a draw of their own.
+				DrawData& groupDrawData = m_drawData[itGroup->second];
+				if (groupDrawData.pMeshComponent->GetMeshData() == meshComponent.GetMeshData() && groupDrawData.program == program &&
+					groupDrawData.textureKey == textureKey && GetMaterialParameters(*groupDrawData.pMaterialComponent) == materialParameters)
+				{
+					groupDrawData.depth = std::min(groupDrawData.depth, viewDepth);
+					++groupDrawData.instanceCount;
+					m_instanceEntries.push_back(InstanceEntry{ itGroup->second, pWorldMatrix });
+					return;
+				}
+			}
 		}
 
-		// Transform
-		if (TransformComponent* pTransformComponent = m_pCurrentSceneWorld->GetTransformComponent(entity))
+		m_drawData.push_back(DrawData{ pMaterialComponent, &meshComponent, textureKey, renderState, viewDepth, 0U, 1U, packetIndex, program, instanceProgram, 0U, 0U });
+		m_instanceEntries.push_back(InstanceEntry{ drawIndex, pWorldMatrix });
+	});
+
+	// Place world matrices of every draw next to each other, then sort draws.
+	uint32_t instanceOffset = 0U;
+	for (uint32_t drawIndex = 0; drawIndex < m_drawData.size(); ++drawIndex)
+	{
+		DrawData& drawData = m_drawData[drawIndex];
+		if (drawData.instanceCount < minInstanceCount)
 		{
-			bgfx::setTransform(pTransformComponent->GetWorldMatrix().Begin());
+			drawData.instanceProgram = ShaderSchema::InvalidProgramHandle;
 		}
 
-		// Mesh
-		UpdateStaticMeshComponent(pMeshComponent);
+		// Counts are restored by the scatter loop below.
+		drawData.firstInstance = instanceOffset;
+		instanceOffset += drawData.instanceCount;
+		drawData.instanceCount = 0U;
+	}
+	m_instanceMatrices.resize(instanceOffset);
+	for (const InstanceEntry& instanceEntry : m_instanceEntries)
+	{
+		DrawData& drawData = m_drawData[instanceEntry.drawIndex];
+		m_instanceMatrices[drawData.firstInstance + drawData.instanceCount++] = instanceEntry.pWorldMatrix;
+	}
+
+	for (uint32_t drawIndex = 0; drawIndex < m_drawData.size(); ++drawIndex)
+	{
+		const DrawData& drawData = m_drawData[drawIndex];
+		const MaterialComponent* pMaterialComponent = drawData.pMaterialComponent;
+		uint8_t stateKey = (pMaterialComponent->GetTwoSided() ? 1U : 0U) | (cd::BlendMode::Mask == pMaterialComponent->GetBlendMode() ? 2U : 0U);
+		m_renderQueue.Add(RenderQueue::MakeKey(drawData.GetProgram(), stateKey, drawData.textureKey, drawData.depth), drawIndex);
+	}
+	m_renderQueue.Sort();
 
-		// Material
-		for (const auto& [textureType, _] : pMaterialComponent->GetTextureResources())
+	// Transient instance data buffers are allocated on the main thread, submit threads only fill them.
+	// A buffer can hold less than requested, the rest goes to the next buffers.
+	// Instances beyond the transient budget of the frame are drawn one by one without instancing.
+	m_instanceDataBuffers.clear();
+	for (DrawData& drawData : m_drawData)
+	{
+		drawData.firstInstanceBuffer = static_cast<uint32_t>(m_instanceDataBuffers.size());
+		drawData.instanceBufferCount = 0U;
+		if (!drawData.IsInstanced())
 		{
-			if (const MaterialComponent::TextureInfo* pTextureInfo = pMaterialComponent->GetTextureInfo(textureType))
-			{
-				if (cd::MaterialTextureType::BaseColor == textureType)
-				{
-					constexpr StringCrc albedoUVOffsetAndScaleCrc(albedoUVOffsetAndScale);
-					cd::Vec4f uvOffsetAndScaleData(pTextureInfo->GetUVOffset().x(), pTextureInfo->GetUVOffset().y(),
-						pTextureInfo->GetUVScale().x(), pTextureInfo->GetUVScale().y());
-					GetRenderContext()->FillUniform(albedoUVOffsetAndScaleCrc, &uvOffsetAndScaleData, 1);
-				}
+			continue;
+		}
 
-				bgfx::setTexture(pTextureInfo->slot, bgfx::UniformHandle{pTextureInfo->samplerHandle}, bgfx::TextureHandle{pTextureInfo->textureHandle});
+		uint32_t allocatedCount = 0U;
+		while (allocatedCount < drawData.instanceCount)
+		{
+			uint32_t instanceCount = bgfx::getAvailInstanceDataBuffer(drawData.instanceCount - allocatedCount, instanceStride);
+			if (0U == instanceCount)
+			{
+				break;
 			}
-		}
 
-		// Sky
-		SkyType crtSkyType = pSkyComponent->GetSkyType();
-		pMaterialComponent->SetSkyType(crtSkyType);
+			bgfx::allocInstanceDataBuffer(&m_instanceDataBuffers.emplace_back(), instanceCount, instanceStride);
+			allocatedCount += instanceCount;
+			++drawData.instanceBufferCount;
+		}
+	}
 
-		if (SkyType::SkyBox == crtSkyType)
+	// Split the sorted draws into contiguous ranges recorded by submit threads with their own encoders.
+	size_t itemCount = m_renderQueue.GetCount();
+	size_t submitThreadCount = std::min<size_t>(GetRenderContext()->GetSubmitThreadCount(), itemCount / minSubmitThreadDrawCount);
+	uint32_t stateChangeCount = 0U;
+	if (submitThreadCount <= 1U)
+	{
+		// bgfx::begin returns the main thread encoder.
+		stateChangeCount = EncodeDraws(bgfx::begin(), 0U, itemCount);
+	}
+	else
+	{
+		m_submitRanges.resize(submitThreadCount);
+		for (size_t rangeIndex = 0; rangeIndex < submitThreadCount; ++rangeIndex)
 		{
-			// Create a new TextureHandle each frame if the skybox texture path has been updated,
-			// otherwise RenderContext::CreateTexture will automatically skip it.
-
-			constexpr StringCrc irrSamplerCrc(cubeIrradianceSampler);
-			GetRenderContext()->CreateTexture(pSkyComponent->GetIrradianceTexturePath().c_str(), samplerFlags);
-			bgfx::setTexture(IBL_IRRADIANCE_SLOT,
-				GetRenderContext()->GetUniform(irrSamplerCrc),
-				GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetIrradianceTexturePath())));
-
-			constexpr StringCrc radSamplerCrc(cubeRadianceSampler);
-			GetRenderContext()->CreateTexture(pSkyComponent->GetRadianceTexturePath().c_str(), samplerFlags);
-			bgfx::setTexture(IBL_RADIANCE_SLOT,
-				GetRenderContext()->GetUniform(radSamplerCrc),
-				GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetRadianceTexturePath())));
-
-			constexpr StringCrc lutsamplerCrc(lutSampler);
-			constexpr StringCrc luttextureCrc(lutTexture);
-			bgfx::setTexture(BRDF_LUT_SLOT, GetRenderContext()->GetUniform(lutsamplerCrc), GetRenderContext()->GetTexture(luttextureCrc));
+			m_submitRanges[rangeIndex] = SubmitRange{ itemCount * rangeIndex / submitThreadCount, itemCount * (rangeIndex + 1U) / submitThreadCount, 0U };
 		}
-		else if (SkyType::AtmosphericScattering == crtSkyType)
+
+		std::for_each(std::execution::par, m_submitRanges.begin(), m_submitRanges.end(), [this](SubmitRange& submitRange)
 		{
-			bgfx::setImage(ATM_TRANSMITTANCE_SLOT, GetRenderContext()->GetTexture(pSkyComponent->GetATMTransmittanceCrc()), 0, bgfx::Access::Read, bgfx::TextureFormat::RGBA32F);
-			bgfx::setImage(ATM_IRRADIANCE_SLOT, GetRenderContext()->GetTexture(pSkyComponent->GetATMIrradianceCrc()), 0, bgfx::Access::Read, bgfx::TextureFormat::RGBA32F);
-			bgfx::setImage(ATM_SCATTERING_SLOT, GetRenderContext()->GetTexture(pSkyComponent->GetATMScatteringCrc()), 0, bgfx::Access::Read, bgfx::TextureFormat::RGBA32F);
+			// RenderContext limits submit threads to the free encoder count, so waiting only happens while another range ends.
+			bgfx::Encoder* pEncoder = bgfx::begin(true);
+			while (!pEncoder)
+			{
+				std::this_thread::yield();
+				pEncoder = bgfx::begin(true);
+			}
 
-			constexpr StringCrc LightDirCrc(LightDir);
-			GetRenderContext()->FillUniform(LightDirCrc, &(pSkyComponent->GetSunDirection().x()), 1);
+			submitRange.stateChangeCount = EncodeDraws(pEncoder, submitRange.beginItem, submitRange.endItem);
+			bgfx::end(pEncoder);
+		});
 
-			constexpr StringCrc HeightOffsetAndshadowLengthCrc(HeightOffsetAndshadowLength);
-			cd::Vec4f tmpHeightOffsetAndshadowLength = cd::Vec4f(pSkyComponent->GetHeightOffset(), pSkyComponent->GetShadowLength(), 0.0f, 0.0f);
-			GetRenderContext()->FillUniform(HeightOffsetAndshadowLengthCrc, &(tmpHeightOffsetAndshadowLength.x()), 1);
+		for (const SubmitRange& submitRange : m_submitRanges)
+		{
+			stateChangeCount += submitRange.stateChangeCount;
 		}
+	}
 
-		// Submit uniform values : camera settings
-		constexpr StringCrc cameraPosCrc(cameraPos);
-		GetRenderContext()->FillUniform(cameraPosCrc, &cameraTransform.GetTranslation().x(), 1);
+	GetRenderContext()->AddStateChangeCount(stateChangeCount);
+}
 
-		// Submit uniform values : material settings
-		constexpr StringCrc albedoColorCrc(albedoColor);
-		GetRenderContext()->FillUniform(albedoColorCrc, pMaterialComponent->GetAlbedoColor().Begin(), 1);
-
-		constexpr StringCrc mrFactorCrc(metallicRoughnessFactor);
-		cd::Vec4f metallicRoughnessFactorData(pMaterialComponent->GetMetallicFactor(), pMaterialComponent->GetRoughnessFactor(), 1.0f, 1.0f);
-		GetRenderContext()->FillUniform(mrFactorCrc, metallicRoughnessFactorData.Begin(), 1);
-
-		constexpr StringCrc emissiveColorCrc(emissiveColor);
-		GetRenderContext()->FillUniform(emissiveColorCrc, pMaterialComponent->GetEmissiveColor().Begin(), 1);
-
-		// Submit uniform values : light settings
-		auto lightEntities = m_pCurrentSceneWorld->GetLightEntities();
-		size_t lightEntityCount = lightEntities.size();
-		constexpr engine::StringCrc lightCountAndStrideCrc(lightCountAndStride);
-		static cd::Vec4f lightInfoData(0, LightUniform::LIGHT_STRIDE, 0.0f, 0.0f);
-		lightInfoData.x() = static_cast<float>(lightEntityCount);
-		GetRenderContext()->FillUniform(lightCountAndStrideCrc, lightInfoData.Begin(), 1);
-		if (lightEntityCount > 0)
+uint32_t WorldRenderer::EncodeDraws(bgfx::Encoder* pEncoder, size_t beginItem, size_t endItem) const
+{
+	// Camera, sky and light uniforms are shared by all draws. Every encoder sets them before its first draw.
+	const FrameConstants& frameConstants = GetRenderContext()->GetFrameConstants();
+	frameConstants.Submit(pEncoder);
+
+	// Draws with the same program, textures and render state form a batch which keeps bindings and state between submits.
+	// The last draw of a batch discards everything. A range always starts a new batch as encoders don't share state.
+	constexpr uint8_t keepBatchFlags = BGFX_DISCARD_ALL & ~(BGFX_DISCARD_BINDINGS | BGFX_DISCARD_STATE);
+
+	uint32_t stateChangeCount = 0U;
+	const std::vector<RenderQueue::DrawItem>& drawItems = m_renderQueue.GetItems();
+	for (size_t itemIndex = beginItem; itemIndex < endItem; ++itemIndex)
+	{
+		const DrawData& drawData = m_drawData[drawItems[itemIndex].index];
+		if (beginItem == itemIndex || !drawData.IsSameBatch(m_drawData[drawItems[itemIndex - 1].index]))
 		{
-			// Light component storage has continus memory address and layout.
-			float* pLightDataBegin = reinterpret_cast<float*>(m_pCurrentSceneWorld->GetLightComponent(lightEntities[0]));
-			constexpr engine::StringCrc lightParamsCrc(lightParams);
-			GetRenderContext()->FillUniform(lightParamsCrc, pLightDataBegin, static_cast<uint16_t>(lightEntityCount * LightUniform::LIGHT_STRIDE));
+			++stateChangeCount;
+
+			// Material and sky textures are plain handle copies.
+			m_drawPackets.GetPacket(drawData.packetIndex).SubmitTextures(pEncoder);
+			frameConstants.SubmitSkyTextures(pEncoder);
+
+			pEncoder->setState(drawData.renderState);
 		}
 
-		uint64_t state = defaultRenderingState;
-		if (!pMaterialComponent->GetTwoSided())
+		// Submit uniform values : material settings
+		m_materialUniforms.Submit(*drawData.pMaterialComponent, pEncoder);
+
+		// Encoders of submit threads are merged by bgfx sorting, so the rank in the queue goes to the depth of the view sort key.
+		uint32_t rank = static_cast<uint32_t>(itemIndex);
+		bool isBatchEnd = itemIndex + 1 == endItem || !drawData.IsSameBatch(m_drawData[drawItems[itemIndex + 1].index]);
+		if (!drawData.IsInstanced())
 		{
-			state |= BGFX_STATE_CULL_CCW;
+			// Transform
+			pEncoder->setTransform(m_instanceMatrices[drawData.firstInstance]);
+
+			// Mesh
+			SetStaticMeshBuffers(pEncoder, drawData.pMeshComponent);
+
+			pEncoder->submit(GetViewID(), bgfx::ProgramHandle{drawData.program}, rank, isBatchEnd ? BGFX_DISCARD_ALL : keepBatchFlags);
+			continue;
 		}
 
-		if (cd::BlendMode::Mask == pMaterialComponent->GetBlendMode())
+		uint32_t submittedCount = 0U;
+		for (uint32_t bufferIndex = 0; bufferIndex < drawData.instanceBufferCount; ++bufferIndex)
 		{
-			constexpr StringCrc alphaCutOffCrc(alphaCutOff);
-			GetRenderContext()->FillUniform(alphaCutOffCrc, &pMaterialComponent->GetAlphaCutOff(), 1);
+			const bgfx::InstanceDataBuffer& instanceDataBuffer = m_instanceDataBuffers[drawData.firstInstanceBuffer + bufferIndex];
+			const float* const* ppWorldMatrices = &m_instanceMatrices[drawData.firstInstance + submittedCount];
+			for (uint32_t instanceIndex = 0; instanceIndex < instanceDataBuffer.num; ++instanceIndex)
+			{
+				std::memcpy(instanceDataBuffer.data + instanceIndex * instanceStride, ppWorldMatrices[instanceIndex], instanceStride);
+			}
+			submittedCount += instanceDataBuffer.num;
+
+			pEncoder->setInstanceDataBuffer(&instanceDataBuffer);
+			SetStaticMeshBuffers(pEncoder, drawData.pMeshComponent);
+
+			bool isLastSubmit = isBatchEnd && submittedCount == drawData.instanceCount;
+			pEncoder->submit(GetViewID(), bgfx::ProgramHandle{drawData.instanceProgram}, rank, isLastSubmit ? BGFX_DISCARD_ALL : keepBatchFlags);
 		}
 
-		bgfx::setState(state);
+		for (; submittedCount < drawData.instanceCount; ++submittedCount)
+		{
+			pEncoder->setTransform(m_instanceMatrices[drawData.firstInstance + submittedCount]);
+			SetStaticMeshBuffers(pEncoder, drawData.pMeshComponent);
 
-		bgfx::submit(GetViewID(), bgfx::ProgramHandle{pMaterialComponent->GetShadreProgram()});
+			bool isLastSubmit = isBatchEnd && submittedCount + 1 == drawData.instanceCount;
+			pEncoder->submit(GetViewID(), bgfx::ProgramHandle{drawData.program}, rank, isLastSubmit ? BGFX_DISCARD_ALL : keepBatchFlags);
+		}
 	}
+
+	return stateChangeCount;
 }
 
 }
\ No newline at end of file
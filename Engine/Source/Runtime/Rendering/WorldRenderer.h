@@ -1,11 +1,18 @@
 #pragma once
 
+#include "MaterialDrawPacket.h"
 #include "Renderer.h"
+#include "RenderQueue.hpp"
+
+#include <unordered_map>
+#include <vector>
 
 namespace engine
 {
 
+class MaterialComponent;
 class SceneWorld;
+class StaticMeshComponent;
 
 class WorldRenderer final : public Renderer
 {
@@ -19,7 +26,73 @@ public:
 	void SetSceneWorld(SceneWorld* pSceneWorld) { m_pCurrentSceneWorld = pSceneWorld; }
 
 private:
+	// One draw call, or one instanced draw call for copies of a mesh with equal materials.
+	struct DrawData
+	{
+		MaterialComponent* pMaterialComponent;
+		StaticMeshComponent* pMeshComponent;
+		uint64_t textureKey;
+		uint64_t renderState;
+		// Nearest view space depth of all instances.
+		float depth;
+		// Range of world matrices in m_instanceMatrices.
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+		// Index in m_drawPackets.
+		uint32_t packetIndex;
+		uint16_t program;
+		// Valid when instances are submitted with one instanced draw call.
+		uint16_t instanceProgram;
+
+		// Range of transient buffers in m_instanceDataBuffers.
+		uint32_t firstInstanceBuffer;
+		uint32_t instanceBufferCount;
+
+		bool IsInstanced() const { return instanceProgram != UINT16_MAX; }
+		uint16_t GetProgram() const { return IsInstanced() ? instanceProgram : program; }
+
+		// Draws with the same program, textures and render state keep bindings and state between submits.
+		bool IsSameBatch(const DrawData& other) const
+		{
+			return GetProgram() == other.GetProgram() && textureKey == other.textureKey && renderState == other.renderState;
+		}
+	};
+
+	struct InstanceEntry
+	{
+		uint32_t drawIndex;
+		const float* pWorldMatrix;
+	};
+
+	// Items of m_renderQueue recorded by one submit thread.
+	struct SubmitRange
+	{
+		size_t beginItem;
+		size_t endItem;
+		uint32_t stateChangeCount;
+	};
+
+	// Records sorted draws [beginItem, endItem). Ranges which don't overlap can be recorded by different threads
+	// with their own encoders. Returns how many batches were started.
+	uint32_t EncodeDraws(bgfx::Encoder* pEncoder, size_t beginItem, size_t endItem) const;
+
 	SceneWorld* m_pCurrentSceneWorld = nullptr;
+
+	// Handles resolved once, or again when a material version changes.
+	MaterialUniforms m_materialUniforms;
+	MaterialDrawPacketCache m_drawPackets;
+
+	// Rebuilt every frame. Sorted draws only rebind textures and render state when they change.
+	RenderQueue m_renderQueue;
+	std::vector<DrawData> m_drawData;
+
+	// Hash of mesh data and material values -> index of the draw in m_drawData.
+	std::unordered_map<uint64_t, uint32_t> m_instanceGroups;
+	std::vector<InstanceEntry> m_instanceEntries;
+	std::vector<const float*> m_instanceMatrices;
+	std::vector<bgfx::InstanceDataBuffer> m_instanceDataBuffers;
+
+	std::vector<SubmitRange> m_submitRanges;
 };
 
 }
\ No newline at end of file
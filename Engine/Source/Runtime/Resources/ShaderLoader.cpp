@@ -26,6 +26,17 @@ void ShaderLoader::UploadUberShader(engine::MaterialType* pMaterialType)
 	bgfx::ShaderHandle vsHandle = bgfx::createShader(bgfx::makeRef(VSBlob.data(), static_cast<uint32_t>(VSBlob.size())));
 	bgfx::setName(vsHandle, outputVSFilePath.c_str());
 
+	// Instanced vertex shader shares fragment shaders with the default one.
+	bgfx::ShaderHandle instanceVSHandle = BGFX_INVALID_HANDLE;
+	if (shaderSchema.HasInstanceVertexShader())
+	{
+		std::string outputInstanceVSFilePath = engine::Path::GetShaderOutputPath(shaderSchema.GetInstanceVertexShaderPath());
+		shaderSchema.AddInstanceVSBlob(engine::ResourceLoader::LoadFile(outputInstanceVSFilePath.c_str()));
+		const auto& instanceVSBlob = shaderSchema.GetInstanceVSBlob();
+		instanceVSHandle = bgfx::createShader(bgfx::makeRef(instanceVSBlob.data(), static_cast<uint32_t>(instanceVSBlob.size())));
+		bgfx::setName(instanceVSHandle, outputInstanceVSFilePath.c_str());
+	}
+
 	// Fragment shader.
 	for (const auto& [outputFSFilePath, ShaderFeaturesCrc] : outputFSPathToShaderFeaturesCrc)
 	{
@@ -40,6 +51,15 @@ void ShaderLoader::UploadUberShader(engine::MaterialType* pMaterialType)
 		bgfx::ProgramHandle uberProgramHandle = bgfx::createProgram(vsHandle, fsHandle);
 		assert(bgfx::isValid(uberProgramHandle));
 		shaderSchema.SetCompiledProgram(ShaderFeaturesCrc, uberProgramHandle.idx);
+
+		if (bgfx::isValid(instanceVSHandle))
+		{
+			bgfx::ProgramHandle instanceProgramHandle = bgfx::createProgram(instanceVSHandle, fsHandle);
+			if (bgfx::isValid(instanceProgramHandle))
+			{
+				shaderSchema.SetCompiledInstanceProgram(ShaderFeaturesCrc, instanceProgramHandle.idx);
+			}
+		}
 	}
 }
 
@@ -0,0 +1,360 @@
+#include "Base/Template.h"
+#include "ECWorld/AnimationClip.hpp"
+
+#include <json/json.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Usage : AnimationBenchmark [output.json] [maxBoneCount]
+// Compares memory and sampling speed of raw float tracks with AnimationClip on a synthetic mocap clip.
+// Every benchmark splits its operations into chunks and times each chunk, then reports median and p95 of ns per operation.
+namespace
+{
+
+using namespace engine;
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+// Same key accessors as cd::Track, so AnimationClip::Compress reads it like imported tracks.
+template<typename T>
+struct RawKey
+{
+	float time;
+	T value;
+
+	float GetTime() const { return time; }
+	const T& GetValue() const { return value; }
+};
+
+struct RawTrack
+{
+	std::vector<RawKey<cd::Vec3f>> translationKeys;
+	std::vector<RawKey<cd::Quaternion>> rotationKeys;
+	std::vector<RawKey<cd::Vec3f>> scaleKeys;
+
+	const std::vector<RawKey<cd::Vec3f>>& GetTranslationKeys() const { return translationKeys; }
+	uint32_t GetTranslationKeyCount() const { return static_cast<uint32_t>(translationKeys.size()); }
+	const std::vector<RawKey<cd::Quaternion>>& GetRotationKeys() const { return rotationKeys; }
+	uint32_t GetRotationKeyCount() const { return static_cast<uint32_t>(rotationKeys.size()); }
+	const std::vector<RawKey<cd::Vec3f>>& GetScaleKeys() const { return scaleKeys; }
+	uint32_t GetScaleKeyCount() const { return static_cast<uint32_t>(scaleKeys.size()); }
+
+	size_t GetMemorySize() const
+	{
+		return translationKeys.size() * sizeof(RawKey<cd::Vec3f>) + rotationKeys.size() * sizeof(RawKey<cd::Quaternion>) +
+			scaleKeys.size() * sizeof(RawKey<cd::Vec3f>);
+	}
+};
+
+struct SampledTransform
+{
+	cd::Vec3f translation;
+	cd::Quaternion rotation;
+	cd::Vec3f scale;
+};
+
+// Raw sampling as AnimationSampler did before clips : seek keys by cursor, then lerp and normalized lerp.
+template<typename Keys>
+float SeekRaw(const Keys& keys, uint32_t& cursor, float time)
+{
+	cursor = AnimationClip::SeekKey(keys, static_cast<uint32_t>(keys.size()), cursor, time);
+	float deltaTime = keys[cursor + 1U].time - keys[cursor].time;
+	return std::clamp((time - keys[cursor].time) / deltaTime, 0.0f, 1.0f);
+}
+
+cd::Vec3f LerpRaw(const cd::Vec3f& from, const cd::Vec3f& to, float rate)
+{
+	return cd::Vec3f(from.x() + (to.x() - from.x()) * rate, from.y() + (to.y() - from.y()) * rate, from.z() + (to.z() - from.z()) * rate);
+}
+
+cd::Quaternion LerpRaw(const cd::Quaternion& from, const cd::Quaternion& to, float rate)
+{
+	float x = from.x() + (to.x() - from.x()) * rate;
+	float y = from.y() + (to.y() - from.y()) * rate;
+	float z = from.z() + (to.z() - from.z()) * rate;
+	float w = from.w() + (to.w() - from.w()) * rate;
+	float inverseLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+	return cd::Quaternion(x * inverseLength, y * inverseLength, z * inverseLength, w * inverseLength);
+}
+
+void SampleRaw(const RawTrack& track, float time, AnimationClip::TrackCursor& cursor, SampledTransform& result)
+{
+	float rate = SeekRaw(track.translationKeys, cursor.translation, time);
+	result.translation = LerpRaw(track.translationKeys[cursor.translation].value, track.translationKeys[cursor.translation + 1U].value, rate);
+	rate = SeekRaw(track.rotationKeys, cursor.rotation, time);
+	result.rotation = LerpRaw(track.rotationKeys[cursor.rotation].value, track.rotationKeys[cursor.rotation + 1U].value, rate);
+	rate = SeekRaw(track.scaleKeys, cursor.scale, time);
+	result.scale = LerpRaw(track.scaleKeys[cursor.scale].value, track.scaleKeys[cursor.scale + 1U].value, rate);
+}
+
+// Mocap exports a key per frame for every channel. Only the root moves, other bones rotate smoothly and no bone scales.
+std::vector<RawTrack> CreateMocapTracks(uint32_t boneCount, uint32_t frameCount, std::mt19937& randomEngine)
+{
+	std::uniform_real_distribution<float> phase(0.0f, 6.2831853f);
+	std::uniform_real_distribution<float> frequency(0.02f, 0.2f);
+	std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+
+	std::vector<RawTrack> tracks(boneCount);
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		RawTrack& track = tracks[boneIndex];
+		cd::Vec3f boneOffset(offset(randomEngine), offset(randomEngine), offset(randomEngine));
+		float phases[3] = { phase(randomEngine), phase(randomEngine), phase(randomEngine) };
+		float frequencies[3] = { frequency(randomEngine), frequency(randomEngine), frequency(randomEngine) };
+		for (uint32_t frame = 0U; frame < frameCount; ++frame)
+		{
+			float time = static_cast<float>(frame);
+			cd::Vec3f translation = 0U == boneIndex ? cd::Vec3f(time * 0.05f, std::sin(time * 0.3f) * 0.1f, 0.0f) : boneOffset;
+			track.translationKeys.push_back(RawKey<cd::Vec3f>{ time, translation });
+
+			float halfAngles[3];
+			for (uint32_t axis = 0U; axis < 3U; ++axis)
+			{
+				halfAngles[axis] = 0.4f * std::sin(time * frequencies[axis] + phases[axis]);
+			}
+			float cx = std::cos(halfAngles[0]), sx = std::sin(halfAngles[0]);
+			float cy = std::cos(halfAngles[1]), sy = std::sin(halfAngles[1]);
+			float cz = std::cos(halfAngles[2]), sz = std::sin(halfAngles[2]);
+			track.rotationKeys.push_back(RawKey<cd::Quaternion>{ time, cd::Quaternion(sx * cy * cz - cx * sy * sz, cx * sy * cz + sx * cy * sz,
+				cx * cy * sz - sx * sy * cz, cx * cy * cz + sx * sy * sz) });
+
+			track.scaleKeys.push_back(RawKey<cd::Vec3f>{ time, cd::Vec3f(1.0f, 1.0f, 1.0f) });
+		}
+	}
+	return tracks;
+}
+
+float GetMaxError(const SampledTransform& lhs, const SampledTransform& rhs)
+{
+	float error = 0.0f;
+	for (uint32_t index = 0U; index < 3U; ++index)
+	{
+		error = std::max(error, std::abs(lhs.translation[index] - rhs.translation[index]));
+		error = std::max(error, std::abs(lhs.scale[index] - rhs.scale[index]));
+	}
+
+	float dot = lhs.rotation.x() * rhs.rotation.x() + lhs.rotation.y() * rhs.rotation.y() + lhs.rotation.z() * rhs.rotation.z() + lhs.rotation.w() * rhs.rotation.w();
+	float sign = dot < 0.0f ? -1.0f : 1.0f;
+	error = std::max(error, std::abs(lhs.rotation.x() - rhs.rotation.x() * sign));
+	error = std::max(error, std::abs(lhs.rotation.y() - rhs.rotation.y() * sign));
+	error = std::max(error, std::abs(lhs.rotation.z() - rhs.rotation.z() * sign));
+	error = std::max(error, std::abs(lhs.rotation.w() - rhs.rotation.w() * sign));
+	return error;
+}
+
+constexpr size_t ChunkOperationCount = 1024;
+
+class Samples
+{
+public:
+	void Add(Clock::duration duration, size_t operationCount)
+	{
+		double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+		m_nsPerOperation.push_back(ns / static_cast<double>(operationCount));
+		m_operationCount += operationCount;
+	}
+
+	double GetPercentile(double percentile)
+	{
+		if (m_nsPerOperation.empty())
+		{
+			return 0.0;
+		}
+
+		std::sort(m_nsPerOperation.begin(), m_nsPerOperation.end());
+		size_t index = static_cast<size_t>(percentile * static_cast<double>(m_nsPerOperation.size() - 1) + 0.5);
+		return m_nsPerOperation[index];
+	}
+
+	size_t GetOperationCount() const { return m_operationCount; }
+
+private:
+	std::vector<double> m_nsPerOperation;
+	size_t m_operationCount = 0;
+};
+
+// Keep results observable so that the compiler can't drop measured loops.
+volatile float g_sink = 0.0f;
+
+class Benchmark
+{
+public:
+	explicit Benchmark(uint32_t boneCount) : m_boneCount(boneCount), m_randomEngine(boneCount) {}
+
+	void Run(json& results)
+	{
+		// One minute at 30 ticks per second.
+		constexpr uint32_t frameCount = 1800U;
+		constexpr float duration = static_cast<float>(frameCount - 1U);
+		std::vector<RawTrack> tracks = CreateMocapTracks(m_boneCount, frameCount, m_randomEngine);
+		AnimationClip clip = AnimationClip::Compress(tracks.data(), m_boneCount, duration);
+		assert(m_boneCount == clip.GetTrackCount());
+
+		size_t rawMemorySize = 0U;
+		size_t rawKeyCount = 0U;
+		for (const RawTrack& track : tracks)
+		{
+			rawMemorySize += track.GetMemorySize();
+			rawKeyCount += track.GetTranslationKeyCount() + track.GetRotationKeyCount() + track.GetScaleKeyCount();
+		}
+
+		// Random times, including times between keys and at both ends.
+		std::uniform_real_distribution<float> sampleTime(0.0f, duration);
+		std::vector<float> seekTimes(4096U);
+		std::generate(seekTimes.begin(), seekTimes.end(), [&]() { return sampleTime(m_randomEngine); });
+		seekTimes[0] = 0.0f;
+		seekTimes[1] = duration;
+
+		float maxError = 0.0f;
+		std::vector<AnimationClip::TrackCursor> rawCursors(m_boneCount);
+		std::vector<AnimationClip::TrackCursor> clipCursors(m_boneCount);
+		for (float time : seekTimes)
+		{
+			for (uint32_t trackIndex = 0U; trackIndex < m_boneCount; ++trackIndex)
+			{
+				SampledTransform raw;
+				SampledTransform compressed;
+				SampleRaw(tracks[trackIndex], time, rawCursors[trackIndex], raw);
+				clip.Sample(trackIndex, time, clipCursors[trackIndex], compressed.translation, compressed.rotation, compressed.scale);
+				maxError = std::max(maxError, GetMaxError(raw, compressed));
+			}
+		}
+		assert(maxError < 0.005f);
+
+		printf("%-24s %6u bones : raw %10zu bytes %8zu keys, clip %10zu bytes %8zu keys, ratio %6.2f, max error %.6f\n", "Memory",
+			m_boneCount, rawMemorySize, rawKeyCount, clip.GetMemorySize(), clip.GetKeyCount(),
+			static_cast<double>(rawMemorySize) / static_cast<double>(clip.GetMemorySize()), maxError);
+
+		json memory;
+		memory["name"] = "Memory";
+		memory["boneCount"] = m_boneCount;
+		memory["rawBytes"] = rawMemorySize;
+		memory["rawKeyCount"] = rawKeyCount;
+		memory["clipBytes"] = clip.GetMemorySize();
+		memory["clipKeyCount"] = clip.GetKeyCount();
+		memory["maxError"] = maxError;
+		results.push_back(cd::MoveTemp(memory));
+
+		// Playback at 60 frames per second moves cursors forward. One operation samples one track.
+		std::vector<float> playbackTimes;
+		for (float time = 0.0f; time < duration; time += 0.5f)
+		{
+			playbackTimes.push_back(time);
+		}
+
+		Report(results, "RawPlayback", Measure(playbackTimes, rawCursors, [&](float time, uint32_t trackIndex, AnimationClip::TrackCursor& cursor)
+		{
+			SampledTransform raw;
+			SampleRaw(tracks[trackIndex], time, cursor, raw);
+			return raw.rotation.w();
+		}));
+		Report(results, "ClipPlayback", Measure(playbackTimes, clipCursors, [&](float time, uint32_t trackIndex, AnimationClip::TrackCursor& cursor)
+		{
+			SampledTransform compressed;
+			clip.Sample(trackIndex, time, cursor, compressed.translation, compressed.rotation, compressed.scale);
+			return compressed.rotation.w();
+		}));
+		Report(results, "RawSeek", Measure(seekTimes, rawCursors, [&](float time, uint32_t trackIndex, AnimationClip::TrackCursor& cursor)
+		{
+			SampledTransform raw;
+			SampleRaw(tracks[trackIndex], time, cursor, raw);
+			return raw.rotation.w();
+		}));
+		Report(results, "ClipSeek", Measure(seekTimes, clipCursors, [&](float time, uint32_t trackIndex, AnimationClip::TrackCursor& cursor)
+		{
+			SampledTransform compressed;
+			clip.Sample(trackIndex, time, cursor, compressed.translation, compressed.rotation, compressed.scale);
+			return compressed.rotation.w();
+		}));
+	}
+
+private:
+	// func(time, trackIndex, cursor) samples one track and returns a value of the result.
+	template<typename Func>
+	Samples Measure(const std::vector<float>& times, std::vector<AnimationClip::TrackCursor>& cursors, Func&& func)
+	{
+		std::fill(cursors.begin(), cursors.end(), AnimationClip::TrackCursor());
+
+		Samples samples;
+		float sum = 0.0f;
+		size_t pendingCount = 0U;
+		Clock::time_point startTime = Clock::now();
+		for (float time : times)
+		{
+			for (uint32_t trackIndex = 0U; trackIndex < m_boneCount; ++trackIndex)
+			{
+				sum += func(time, trackIndex, cursors[trackIndex]);
+			}
+
+			pendingCount += m_boneCount;
+			if (pendingCount >= ChunkOperationCount)
+			{
+				Clock::time_point endTime = Clock::now();
+				samples.Add(endTime - startTime, pendingCount);
+				pendingCount = 0U;
+				startTime = endTime;
+			}
+		}
+		g_sink = g_sink + sum;
+		return samples;
+	}
+
+	void Report(json& results, const char* pName, Samples samples)
+	{
+		double median = samples.GetPercentile(0.5);
+		double p95 = samples.GetPercentile(0.95);
+		printf("%-24s %6u bones : median %10.2f ns/op, p95 %10.2f ns/op\n", pName, m_boneCount, median, p95);
+
+		json result;
+		result["name"] = pName;
+		result["boneCount"] = m_boneCount;
+		result["operationCount"] = samples.GetOperationCount();
+		result["medianNsPerOp"] = median;
+		result["p95NsPerOp"] = p95;
+		results.push_back(cd::MoveTemp(result));
+	}
+
+private:
+	uint32_t m_boneCount;
+	std::mt19937 m_randomEngine;
+};
+
+}
+
+int main(int argc, char** argv)
+{
+	const char* pOutputPath = argc > 1 ? argv[1] : "AnimationBenchmark.json";
+	uint32_t maxBoneCount = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 256U;
+
+	json results = json::array();
+	for (uint32_t boneCount : { 32U, 64U, 256U })
+	{
+		if (boneCount <= maxBoneCount)
+		{
+			Benchmark(boneCount).Run(results);
+		}
+	}
+
+	json output;
+	output["benchmark"] = "Animation";
+	output["results"] = cd::MoveTemp(results);
+
+	std::ofstream outputFile(pOutputPath);
+	if (!outputFile.is_open())
+	{
+		printf("Failed to write %s\n", pOutputPath);
+		return 1;
+	}
+	outputFile << output.dump(4);
+	printf("Results are written to %s\n", pOutputPath);
+
+	return 0;
+}
\ No newline at end of file
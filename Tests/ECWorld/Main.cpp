@@ -1,14 +1,24 @@
 #include "Core/StringCrc.h"
+#include "ECWorld/AnimationClip.hpp"
 #include "ECWorld/CameraComponent.h"
+#include "ECWorld/DynamicAABBTree.hpp"
+#include "ECWorld/EntityCommandBuffer.hpp"
+#include "ECWorld/FrustumCuller.hpp"
 #include "ECWorld/LightComponent.h"
 #include "ECWorld/MaterialComponent.h"
 #include "ECWorld/HierarchyComponent.h"
+#include "ECWorld/SkinningKernel.hpp"
 #include "ECWorld/World.h"
 #include "ECWorld/StaticMeshComponent.h"
+#include "ECWorld/TransformBatch.hpp"
 #include "ECWorld/TransformComponent.h"
+#include "ECWorld/TransformSystem.hpp"
 #include "Utilities/PerformanceProfiler.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cfloat>
+#include <cmath>
 #include <random>
 #include <set>
 
@@ -184,6 +194,1052 @@ void Test_RemoveEntityComponentsByOrder(Factory& factory, const std::vector<Enti
 	printf("\n[Success] Test_RemoveEntityComponentsByOrder\n");
 }
 
+void Test_View(World& world, Factory& factory)
+{
+	cdtools::PerformanceProfiler perf("Test_View");
+
+	// Level entity only has a HierarchyComponent so the smallest storage drives iteration.
+	size_t meshCount = 0;
+	world.View<HierarchyComponent, TransformComponent, StaticMeshComponent>().Each(
+		[&meshCount](Entity, HierarchyComponent&, TransformComponent&, StaticMeshComponent&) { ++meshCount; });
+	assert(meshCount == factory.pStaticMesh->GetCount());
+
+	size_t excludedCount = 0;
+	world.View<HierarchyComponent, TransformComponent>(Exclude<MaterialComponent>{}).Each(
+		[&excludedCount](Entity, HierarchyComponent&, TransformComponent&) { ++excludedCount; });
+	assert(0 == excludedCount);
+
+	auto hierarchyView = world.View<HierarchyComponent>(Exclude<StaticMeshComponent>{});
+	assert(hierarchyView.GetCandidateCount() == factory.pHierarchy->GetCount());
+	assert(1 == hierarchyView.GetEntities().size());
+
+	printf("\n[Success] Test_View\n");
+}
+
+void Test_RecycleEntity()
+{
+	cdtools::PerformanceProfiler perf("Test_RecycleEntity");
+
+	World world;
+	ComponentsStorage<HierarchyComponent>* pHierarchyStorage = world.Register<HierarchyComponent>();
+
+	std::vector<Entity> entities = world.CreateEntities(100);
+	assert(100 == world.GetEntityCount());
+	for (Entity entity : entities)
+	{
+		assert(world.IsAlive(entity));
+		pHierarchyStorage->CreateComponent(entity);
+	}
+
+	Entity oldEntity = entities[42];
+	pHierarchyStorage->RemoveComponent(oldEntity);
+	world.DestroyEntity(oldEntity);
+	assert(!world.IsAlive(oldEntity));
+	assert(99 == world.GetEntityCount());
+
+	// Index is reused with a new generation so the stale handle doesn't alias the new entity.
+	Entity newEntity = world.CreateEntity();
+	assert(GetEntityIndex(newEntity) == GetEntityIndex(oldEntity));
+	assert(GetEntityGeneration(newEntity) == GetEntityGeneration(oldEntity) + 1);
+	assert(world.IsAlive(newEntity) && !world.IsAlive(oldEntity));
+
+	pHierarchyStorage->CreateComponent(newEntity);
+	assert(pHierarchyStorage->Contains(newEntity));
+	assert(!pHierarchyStorage->Contains(oldEntity));
+	assert(nullptr == pHierarchyStorage->GetComponent(oldEntity));
+	assert(!world.IsAlive(INVALID_ENTITY));
+
+	// Other worlds allocate ids independently.
+	World otherWorld;
+	assert(0 == otherWorld.CreateEntity());
+
+	printf("\n[Success] Test_RecycleEntity\n");
+}
+
+void Test_ComponentSignature(World& world, Factory& factory, const std::vector<Entity>& meshEntites)
+{
+	cdtools::PerformanceProfiler perf("Test_ComponentSignature");
+
+	// Entities in the first 10% still own all mesh components.
+	Entity meshEntity = meshEntites[0];
+	assert((world.Has<HierarchyComponent, TransformComponent, StaticMeshComponent, MaterialComponent>(meshEntity)));
+	assert(!world.Has<CameraComponent>(meshEntity));
+	assert((!world.Has<TransformComponent, LightComponent>(meshEntity)));
+
+	// Entities in the second 10% had components removed from storages.
+	Entity removedEntity = meshEntites[meshEntites.size() / 10];
+	assert(!world.Has<TransformComponent>(removedEntity));
+	assert(0 == world.GetSignature(removedEntity));
+
+	size_t oldTransformCount = factory.pTransform->GetCount();
+	size_t oldMaterialCount = factory.pMaterial->GetCount();
+	world.DestroyEntity(meshEntity);
+	assert(!world.IsAlive(meshEntity));
+	assert(!factory.pTransform->Contains(meshEntity));
+	assert(oldTransformCount - 1 == factory.pTransform->GetCount());
+	assert(oldMaterialCount - 1 == factory.pMaterial->GetCount());
+	assert(0 == world.GetSignature(meshEntity));
+
+	printf("\n[Success] Test_ComponentSignature\n");
+}
+
+void Test_EntityCommandBuffer()
+{
+	cdtools::PerformanceProfiler perf("Test_EntityCommandBuffer");
+
+	World world;
+	ComponentsStorage<HierarchyComponent>* pHierarchyStorage = world.Register<HierarchyComponent>();
+	ComponentsStorage<TransformComponent>* pTransformStorage = world.Register<TransformComponent>();
+	EntityCommandBuffer commandBuffer(&world);
+
+	constexpr int allocateCount = 10000;
+	Entity entities[allocateCount];
+
+#pragma omp parallel for
+	for (int i = 0; i < allocateCount; ++i)
+	{
+		Entity entity = commandBuffer.CreateEntity();
+		commandBuffer.AddComponent<HierarchyComponent>(entity, [i](HierarchyComponent& component) { component.SetParentEntity(i); });
+		commandBuffer.AddComponent<TransformComponent>(entity);
+		entities[i] = entity;
+	}
+
+	// Nothing is applied before the sync point.
+	assert(0 == pHierarchyStorage->GetCount() && 0 == pTransformStorage->GetCount());
+	assert(2 * allocateCount == commandBuffer.GetCommandCount());
+
+	commandBuffer.Playback();
+	assert(0 == commandBuffer.GetCommandCount());
+	assert(allocateCount == pHierarchyStorage->GetCount());
+	assert(allocateCount == pTransformStorage->GetCount());
+	for (int i = 0; i < allocateCount; ++i)
+	{
+		assert(static_cast<Entity>(i) == pHierarchyStorage->GetComponent(entities[i])->GetParentEntity());
+	}
+
+#pragma omp parallel for
+	for (int i = 0; i < allocateCount; ++i)
+	{
+		if (0 == i % 2)
+		{
+			commandBuffer.RemoveComponent<TransformComponent>(entities[i]);
+		}
+		else
+		{
+			commandBuffer.DestroyEntity(entities[i]);
+			// Commands on destroyed entities are skipped.
+			commandBuffer.AddComponent<TransformComponent>(entities[i]);
+		}
+	}
+
+	commandBuffer.Playback();
+	assert(0 == pTransformStorage->GetCount());
+	assert(allocateCount / 2 == pHierarchyStorage->GetCount());
+	assert(allocateCount / 2 == world.GetEntityCount());
+	assert(world.IsAlive(entities[0]) && !world.IsAlive(entities[1]));
+
+	printf("\n[Success] Test_EntityCommandBuffer\n");
+}
+
+void Test_Hierarchy()
+{
+	cdtools::PerformanceProfiler perf("Test_Hierarchy");
+
+	World world;
+	ComponentsStorage<HierarchyComponent>* pHierarchyStorage = world.Register<HierarchyComponent>();
+	world.Register<TransformComponent>();
+	TransformSystem transformSystem(&world);
+
+	// root -> { a -> { c, d }, b }
+	std::vector<Entity> entities = world.CreateEntities(5);
+	Entity root = entities[0], a = entities[1], b = entities[2], c = entities[3], d = entities[4];
+	assert(transformSystem.SetParent(a, root));
+	assert(transformSystem.SetParent(b, root));
+	assert(transformSystem.SetParent(c, a));
+	assert(transformSystem.SetParent(d, a));
+
+	// Cycles are rejected.
+	assert(!transformSystem.SetParent(root, c));
+	assert(INVALID_ENTITY == transformSystem.GetParent(root));
+
+	assert(0 == transformSystem.GetDepth(root) && 1 == transformSystem.GetDepth(a) && 2 == transformSystem.GetDepth(d));
+	assert(transformSystem.HasChildren(a) && !transformSystem.HasChildren(b));
+
+	std::vector<Entity> children;
+	transformSystem.ForEachChild(root, [&children](Entity child) { children.push_back(child); });
+	assert(2 == children.size());
+
+	// Parents are visited before children.
+	std::vector<Entity> subtree;
+	transformSystem.ForEachInSubtree(root, [&subtree](Entity entity) { subtree.push_back(entity); });
+	assert(5 == subtree.size() && root == subtree[0]);
+	for (size_t index = 1; index < subtree.size(); ++index)
+	{
+		Entity parent = transformSystem.GetParent(subtree[index]);
+		assert(std::find(subtree.begin(), subtree.begin() + index, parent) != subtree.begin() + index);
+	}
+
+	subtree.clear();
+	transformSystem.ForEachInSubtree(a, [&subtree](Entity entity) { subtree.push_back(entity); });
+	assert(3 == subtree.size());
+
+	// Reparent a subtree and depths follow.
+	assert(transformSystem.SetParent(a, b));
+	assert(2 == transformSystem.GetDepth(a) && 3 == transformSystem.GetDepth(c));
+	assert(transformSystem.HasChildren(root) && transformSystem.HasChildren(b));
+
+	// Removed entity's children become roots.
+	transformSystem.RemoveFromHierarchy(a);
+	assert(INVALID_ENTITY == transformSystem.GetParent(a) && !transformSystem.HasChildren(a) && !transformSystem.HasChildren(b));
+	assert(INVALID_ENTITY == transformSystem.GetParent(c) && 0 == transformSystem.GetDepth(d));
+	assert(INVALID_ENTITY == pHierarchyStorage->GetComponent(c)->GetNextSiblingEntity());
+
+	printf("\n[Success] Test_Hierarchy\n");
+}
+
+bool IsTranslation(const cd::Matrix4x4& matrix, float x, float y, float z)
+{
+	const float* pMatrix = matrix.Begin();
+	return std::abs(pMatrix[12] - x) < 1e-4f && std::abs(pMatrix[13] - y) < 1e-4f && std::abs(pMatrix[14] - z) < 1e-4f;
+}
+
+void Test_HierarchyWorldMatrix()
+{
+	cdtools::PerformanceProfiler perf("Test_HierarchyWorldMatrix");
+
+	World world;
+	world.Register<HierarchyComponent>();
+	ComponentsStorage<TransformComponent>* pTransformStorage = world.Register<TransformComponent>();
+	TransformSystem transformSystem(&world);
+
+	auto SetLocal = [&](Entity entity, cd::Vec3f translation, float scale)
+	{
+		pTransformStorage->GetComponent(entity)->SetTransform(cd::Transform(translation, cd::Quaternion::Identity(), cd::Vec3f(scale, scale, scale)));
+		transformSystem.MarkDirty(entity);
+	};
+	auto GetWorld = [&](Entity entity) -> const cd::Matrix4x4& { return pTransformStorage->GetComponent(entity)->GetWorldMatrix(); };
+	auto UpdateFrame = [&]()
+	{
+		transformSystem.BuildAll();
+		transformSystem.Update();
+	};
+
+	// root -> { a -> c, b }. Scale of root tells parent * local from local * parent.
+	std::vector<Entity> entities = world.CreateEntities(4);
+	Entity root = entities[0], a = entities[1], b = entities[2], c = entities[3];
+	for (Entity entity : entities)
+	{
+		pTransformStorage->CreateComponent(entity);
+	}
+	SetLocal(root, cd::Vec3f(1.0f, 0.0f, 0.0f), 2.0f);
+	SetLocal(a, cd::Vec3f(0.0f, 2.0f, 0.0f), 1.0f);
+	SetLocal(b, cd::Vec3f(0.0f, 0.0f, 3.0f), 1.0f);
+	SetLocal(c, cd::Vec3f(1.0f, 0.0f, 0.0f), 1.0f);
+	transformSystem.SetParent(c, a);
+	transformSystem.SetParent(a, root);
+	transformSystem.SetParent(b, root);
+	UpdateFrame();
+	assert(IsTranslation(GetWorld(root), 1.0f, 0.0f, 0.0f));
+	assert(IsTranslation(GetWorld(a), 1.0f, 4.0f, 0.0f));
+	assert(IsTranslation(GetWorld(c), 3.0f, 4.0f, 0.0f));
+	assert(IsTranslation(GetWorld(b), 1.0f, 0.0f, 6.0f));
+	assert(std::abs(GetWorld(c).Begin()[0] - 2.0f) < 1e-4f);
+
+	// Editing the root moves the whole tree.
+	SetLocal(root, cd::Vec3f(5.0f, 0.0f, 0.0f), 1.0f);
+	UpdateFrame();
+	assert(IsTranslation(GetWorld(a), 5.0f, 2.0f, 0.0f));
+	assert(IsTranslation(GetWorld(c), 6.0f, 2.0f, 0.0f));
+	assert(IsTranslation(GetWorld(b), 5.0f, 0.0f, 3.0f));
+
+	// A deeper entity marked before its dirty ancestor is covered by the ancestor's subtree.
+	SetLocal(c, cd::Vec3f(2.0f, 0.0f, 0.0f), 1.0f);
+	SetLocal(a, cd::Vec3f(0.0f, 1.0f, 0.0f), 1.0f);
+	UpdateFrame();
+	assert(IsTranslation(GetWorld(a), 5.0f, 1.0f, 0.0f));
+	assert(IsTranslation(GetWorld(c), 7.0f, 1.0f, 0.0f));
+	assert(IsTranslation(GetWorld(b), 5.0f, 0.0f, 3.0f));
+
+	// Reparenting rebuilds the moved subtree under the new parent.
+	transformSystem.SetParent(a, b);
+	UpdateFrame();
+	assert(IsTranslation(GetWorld(a), 5.0f, 1.0f, 3.0f));
+	assert(IsTranslation(GetWorld(c), 7.0f, 1.0f, 3.0f));
+
+	transformSystem.SetParent(a, INVALID_ENTITY);
+	UpdateFrame();
+	assert(IsTranslation(GetWorld(a), 0.0f, 1.0f, 0.0f));
+	assert(IsTranslation(GetWorld(c), 2.0f, 1.0f, 0.0f));
+
+	// Enough independent subtrees take the parallel path.
+	constexpr uint32_t subtreeCount = 64;
+	std::vector<Entity> roots = world.CreateEntities(subtreeCount);
+	std::vector<Entity> children = world.CreateEntities(subtreeCount);
+	for (uint32_t index = 0; index < subtreeCount; ++index)
+	{
+		pTransformStorage->CreateComponent(roots[index]);
+		pTransformStorage->CreateComponent(children[index]);
+		SetLocal(roots[index], cd::Vec3f(static_cast<float>(index), 0.0f, 0.0f), 2.0f);
+		SetLocal(children[index], cd::Vec3f(0.0f, 1.0f, 0.0f), 1.0f);
+		transformSystem.SetParent(children[index], roots[index]);
+	}
+	UpdateFrame();
+	for (uint32_t index = 0; index < subtreeCount; ++index)
+	{
+		assert(IsTranslation(GetWorld(children[index]), static_cast<float>(index), 2.0f, 0.0f));
+	}
+
+	for (uint32_t index = 0; index < subtreeCount; ++index)
+	{
+		SetLocal(roots[index], cd::Vec3f(0.0f, 0.0f, static_cast<float>(index)), 1.0f);
+	}
+	UpdateFrame();
+	for (uint32_t index = 0; index < subtreeCount; ++index)
+	{
+		assert(IsTranslation(GetWorld(children[index]), 0.0f, 1.0f, static_cast<float>(index)));
+	}
+
+	printf("\n[Success] Test_HierarchyWorldMatrix\n");
+}
+
+void Test_HierarchyDestroy()
+{
+	cdtools::PerformanceProfiler perf("Test_HierarchyDestroy");
+
+	World world;
+	ComponentsStorage<HierarchyComponent>* pHierarchyStorage = world.Register<HierarchyComponent>();
+	world.Register<TransformComponent>();
+	TransformSystem transformSystem(&world);
+	EntityCommandBuffer commandBuffer(&world);
+
+	// root -> { a -> { c, d }, b }
+	std::vector<Entity> entities = world.CreateEntities(5);
+	Entity root = entities[0], a = entities[1], b = entities[2], c = entities[3], d = entities[4];
+	transformSystem.SetParent(b, root);
+	transformSystem.SetParent(a, root);
+	transformSystem.SetParent(d, a);
+	transformSystem.SetParent(c, a);
+
+	// Destroying a middle child through the command buffer unlinks it from its parent and siblings.
+	commandBuffer.DestroyEntity(a);
+	commandBuffer.Playback();
+	assert(!world.IsAlive(a) && !pHierarchyStorage->Contains(a));
+	assert(b == pHierarchyStorage->GetComponent(root)->GetFirstChildEntity());
+	assert(INVALID_ENTITY == pHierarchyStorage->GetComponent(b)->GetPrevSiblingEntity());
+	assert(INVALID_ENTITY == transformSystem.GetParent(c) && INVALID_ENTITY == transformSystem.GetParent(d));
+	assert(0 == transformSystem.GetDepth(c) && INVALID_ENTITY == pHierarchyStorage->GetComponent(c)->GetNextSiblingEntity());
+
+	// Walking the hierarchy never reaches the destroyed entity.
+	std::vector<Entity> subtree;
+	transformSystem.ForEachInSubtree(root, [&subtree](Entity entity) { subtree.push_back(entity); });
+	assert((subtree == std::vector<Entity>{ root, b }));
+
+	// Recycling the index of a destroyed parent doesn't bring the old links back.
+	commandBuffer.DestroyEntity(root);
+	commandBuffer.Playback();
+	Entity recycled = world.CreateEntity();
+	assert(GetEntityIndex(recycled) == GetEntityIndex(root));
+	assert(INVALID_ENTITY == transformSystem.GetParent(b) && !transformSystem.HasChildren(recycled));
+	assert(transformSystem.SetParent(c, recycled));
+	subtree.clear();
+	transformSystem.ForEachInSubtree(recycled, [&subtree](Entity entity) { subtree.push_back(entity); });
+	assert((subtree == std::vector<Entity>{ recycled, c }));
+
+	// Marked entities which are destroyed before Update are skipped.
+	transformSystem.Update();
+
+	printf("\n[Success] Test_HierarchyDestroy\n");
+}
+
+void Test_TransformBatch()
+{
+	cdtools::PerformanceProfiler perf("Test_TransformBatch");
+
+	// Odd count covers both SIMD lanes and the scalar tail.
+	constexpr size_t transformCount = 1003;
+	std::vector<float> matrices(transformCount * 16);
+	std::vector<float> expectedMatrices(transformCount * 16);
+
+	std::mt19937 randomEngine(0);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+	TransformBatch batch;
+	for (size_t index = 0; index < transformCount; ++index)
+	{
+		float t[3] = { distribution(randomEngine) * 100.0f, distribution(randomEngine) * 100.0f, distribution(randomEngine) * 100.0f };
+		float s[3] = { distribution(randomEngine) + 2.0f, distribution(randomEngine) + 2.0f, distribution(randomEngine) + 2.0f };
+		float q[4] = { distribution(randomEngine), distribution(randomEngine), distribution(randomEngine), distribution(randomEngine) };
+		float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+		for (float& value : q)
+		{
+			value /= length;
+		}
+		batch.Add(t[0], t[1], t[2], q[0], q[1], q[2], q[3], s[0], s[1], s[2], &matrices[index * 16]);
+
+		// Column major T * R * S by rotating axes with the quaternion.
+		float* pExpected = &expectedMatrices[index * 16];
+		const float x = q[0], y = q[1], z = q[2], w = q[3];
+		const float rotation[3][3] = {
+			{ 1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y) },
+			{ 2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x) },
+			{ 2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y) } };
+		for (size_t column = 0; column < 3; ++column)
+		{
+			for (size_t row = 0; row < 3; ++row)
+			{
+				pExpected[column * 4 + row] = rotation[column][row] * s[column];
+			}
+			pExpected[column * 4 + 3] = 0.0f;
+		}
+		pExpected[12] = t[0];
+		pExpected[13] = t[1];
+		pExpected[14] = t[2];
+		pExpected[15] = 1.0f;
+	}
+
+	batch.Build();
+	assert(transformCount == batch.GetCount());
+	for (size_t index = 0; index < matrices.size(); ++index)
+	{
+		assert(std::abs(matrices[index] - expectedMatrices[index]) < 1e-4f);
+	}
+
+	// 90 degrees around z maps x axis to y axis.
+	float matrix[16];
+	const float halfSqrt2 = std::sqrt(0.5f);
+	batch.Clear();
+	batch.Add(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, halfSqrt2, halfSqrt2, 1.0f, 1.0f, 1.0f, matrix);
+	batch.Build();
+	assert(std::abs(matrix[0]) < 1e-6f && std::abs(matrix[1] - 1.0f) < 1e-6f);
+
+	printf("\n[Success] Test_TransformBatch\n");
+}
+
+void Test_TransformBuildParity()
+{
+	cdtools::PerformanceProfiler perf("Test_TransformBuildParity");
+
+	World world;
+	world.Register<HierarchyComponent>();
+	ComponentsStorage<TransformComponent>* pTransformStorage = world.Register<TransformComponent>();
+	TransformSystem transformSystem(&world);
+
+	std::mt19937 randomEngine(1);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	auto RandomTransform = [&]()
+	{
+		float x = distribution(randomEngine), y = distribution(randomEngine), z = distribution(randomEngine), w = distribution(randomEngine);
+		float inverseLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+		return cd::Transform(cd::Vec3f(distribution(randomEngine) * 100.0f, distribution(randomEngine) * 100.0f, distribution(randomEngine) * 100.0f),
+			cd::Quaternion(x * inverseLength, y * inverseLength, z * inverseLength, w * inverseLength),
+			cd::Vec3f(distribution(randomEngine) + 2.0f, distribution(randomEngine) + 2.0f, distribution(randomEngine) + 2.0f));
+	};
+	auto IsSameMatrix = [](const cd::Matrix4x4& lhs, const cd::Matrix4x4& rhs)
+	{
+		for (size_t index = 0; index < 16; ++index)
+		{
+			if (std::abs(lhs.Begin()[index] - rhs.Begin()[index]) > 1e-3f)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// Odd root count covers SIMD lanes and the scalar tail. Every root has one child.
+	constexpr uint32_t rootCount = 101;
+	std::vector<Entity> roots = world.CreateEntities(rootCount);
+	std::vector<Entity> children = world.CreateEntities(rootCount);
+	for (uint32_t index = 0; index < rootCount; ++index)
+	{
+		pTransformStorage->CreateComponent(roots[index]).SetTransform(RandomTransform());
+		pTransformStorage->CreateComponent(children[index]).SetTransform(RandomTransform());
+		transformSystem.SetParent(children[index], roots[index]);
+		transformSystem.MarkDirty(roots[index]);
+	}
+
+	for (uint32_t round = 0; round < 2; ++round)
+	{
+		transformSystem.BuildAll();
+		transformSystem.Update();
+		for (uint32_t index = 0; index < rootCount; ++index)
+		{
+			// Batched roots match the lazy build.
+			const TransformComponent* pRoot = pTransformStorage->GetComponent(roots[index]);
+			TransformComponent lazyRoot;
+			lazyRoot.SetTransform(pRoot->GetTransform());
+			lazyRoot.Build();
+			assert(!pRoot->IsDirty());
+			assert(IsSameMatrix(pRoot->GetWorldMatrix(), lazyRoot.GetWorldMatrix()));
+			assert(IsSameMatrix(pRoot->GetWorldMatrix(), pRoot->GetTransform().GetMatrix()));
+
+			const TransformComponent* pChild = pTransformStorage->GetComponent(children[index]);
+			assert(IsSameMatrix(pChild->GetWorldMatrix(), pRoot->GetWorldMatrix() * pChild->GetTransform().GetMatrix()));
+		}
+
+		// Only marked roots are rebuilt.
+		for (uint32_t index = 0; index < rootCount; index += 2)
+		{
+			pTransformStorage->GetComponent(roots[index])->SetTransform(RandomTransform());
+			transformSystem.MarkDirty(roots[index]);
+		}
+		pTransformStorage->GetComponent(roots[1])->SetTransform(RandomTransform());
+		transformSystem.BuildAll();
+		assert(pTransformStorage->GetComponent(roots[1])->IsDirty());
+		transformSystem.MarkDirty(roots[1]);
+	}
+
+	printf("\n[Success] Test_TransformBuildParity\n");
+}
+
+void Test_ChangeTracking()
+{
+	cdtools::PerformanceProfiler perf("Test_ChangeTracking");
+
+	World world;
+	ComponentsStorage<HierarchyComponent>* pHierarchyStorage = world.Register<HierarchyComponent>();
+	pHierarchyStorage->EnableChangeTracking();
+
+	constexpr int allocateCount = 1000;
+	std::vector<Entity> entities = world.CreateEntities(allocateCount);
+	for (Entity entity : entities)
+	{
+		pHierarchyStorage->CreateComponent(entity);
+	}
+
+	// Created components count as changed.
+	size_t changedCount = 0;
+	pHierarchyStorage->ForEachChanged([&changedCount](Entity, HierarchyComponent&) { ++changedCount; });
+	assert(allocateCount == changedCount);
+
+	world.ClearChangedComponents();
+	uint32_t oldVersion = pHierarchyStorage->GetVersion(entities[10]);
+	pHierarchyStorage->GetComponent(entities[10]);
+	assert(!pHierarchyStorage->IsChanged(entities[10]));
+
+	pHierarchyStorage->ModifyComponent(entities[10])->SetParentEntity(entities[0]);
+	pHierarchyStorage->MarkChanged(entities[999]);
+	assert(pHierarchyStorage->GetVersion(entities[10]) > oldVersion);
+	assert(pHierarchyStorage->GetVersion() == pHierarchyStorage->GetVersion(entities[999]));
+
+	// Swap-remove keeps the changed mark with the moved component.
+	pHierarchyStorage->RemoveComponent(entities[20]);
+	std::vector<Entity> changedEntities;
+	pHierarchyStorage->ForEachChanged([&changedEntities](Entity entity, HierarchyComponent&) { changedEntities.push_back(entity); });
+	assert(2 == changedEntities.size());
+	assert(std::find(changedEntities.begin(), changedEntities.end(), entities[10]) != changedEntities.end());
+	assert(std::find(changedEntities.begin(), changedEntities.end(), entities[999]) != changedEntities.end());
+
+	pHierarchyStorage->ClearChanged();
+	changedCount = 0;
+	pHierarchyStorage->ForEachChanged([&changedCount](Entity, HierarchyComponent&) { ++changedCount; });
+	assert(0 == changedCount && !pHierarchyStorage->IsChanged(entities[999]));
+
+	printf("\n[Success] Test_ChangeTracking\n");
+}
+
+void Test_SparseEntityLookup()
+{
+	cdtools::PerformanceProfiler perf("Test_SparseEntityLookup");
+
+	World world;
+	ComponentsStorage<HierarchyComponent>* pHierarchyStorage = world.Register<HierarchyComponent>();
+
+	// Entities far away from each other should not allocate the whole id range.
+	constexpr Entity sparseEntities[] = { 0, 1, 4095, 4096, 1000000, INVALID_ENTITY - 1 };
+	for (Entity entity : sparseEntities)
+	{
+		pHierarchyStorage->CreateComponent(entity).SetParentEntity(entity / 2);
+	}
+
+	for (Entity entity : sparseEntities)
+	{
+		assert(pHierarchyStorage->Contains(entity));
+		assert(entity / 2 == pHierarchyStorage->GetComponent(entity)->GetParentEntity());
+	}
+	assert(!pHierarchyStorage->Contains(2));
+	assert(!pHierarchyStorage->Contains(INVALID_ENTITY));
+	assert(nullptr == pHierarchyStorage->GetComponent(999999));
+
+	// Swap-remove moves the last component into the hole and must keep its lookup valid.
+	pHierarchyStorage->RemoveComponent(1);
+	assert(!pHierarchyStorage->Contains(1));
+	assert((INVALID_ENTITY - 1) / 2 == pHierarchyStorage->GetComponent(INVALID_ENTITY - 1)->GetParentEntity());
+	assert(sizeof(sparseEntities) / sizeof(Entity) - 1 == pHierarchyStorage->GetCount());
+
+	printf("\n[Success] Test_SparseEntityLookup\n");
+}
+
+void Test_FrustumCuller()
+{
+	cdtools::PerformanceProfiler perf("Test_FrustumCuller");
+
+	// Identity view projection makes the frustum the [-1, 1] cube so that the expected result is a plain overlap test.
+	constexpr float identity[16] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+	FrustumCuller culler;
+	culler.SetViewProjection(identity, false);
+
+	// Odd count covers both SIMD lanes and the scalar tail.
+	constexpr size_t boxCount = 1003;
+	std::vector<bool> expectedVisibility(boxCount);
+
+	std::mt19937 randomEngine(0);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	for (size_t index = 0; index < boxCount; ++index)
+	{
+		float localMin[3];
+		float localMax[3];
+		float worldMatrix[16];
+		std::copy(std::begin(identity), std::end(identity), worldMatrix);
+		bool isVisible = true;
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			float center = distribution(randomEngine);
+			float extent = distribution(randomEngine) * 0.25f + 0.5f;
+			float scale = distribution(randomEngine) + 2.0f;
+			float translation = distribution(randomEngine) * 4.0f;
+			localMin[axis] = center - extent;
+			localMax[axis] = center + extent;
+			worldMatrix[axis * 4 + axis] = scale;
+			worldMatrix[12 + axis] = translation;
+
+			float worldMin = localMin[axis] * scale + translation;
+			float worldMax = localMax[axis] * scale + translation;
+			isVisible = isVisible && worldMax >= -1.0f && worldMin <= 1.0f;
+		}
+		culler.Add(localMin, localMax, worldMatrix);
+		expectedVisibility[index] = isVisible;
+	}
+	assert(boxCount == culler.GetCount());
+
+	culler.Cull();
+	size_t visibleCount = 0;
+	for (size_t index = 0; index < boxCount; ++index)
+	{
+		assert(expectedVisibility[index] == culler.IsVisible(index));
+		visibleCount += culler.IsVisible(index) ? 1 : 0;
+	}
+	assert(visibleCount > 0 && visibleCount < boxCount);
+
+	// Rotating a unit box by 45 degrees around z grows its world extent to sqrt(2).
+	culler.Clear();
+	const float halfSqrt2 = std::sqrt(0.5f);
+	const float boxMin[3] = { -1.0f, -1.0f, -1.0f };
+	const float boxMax[3] = { 1.0f, 1.0f, 1.0f };
+	float rotated[16] = { halfSqrt2, halfSqrt2, 0.0f, 0.0f, -halfSqrt2, halfSqrt2, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 2.3f, 0.0f, 0.0f, 1.0f };
+	culler.Add(boxMin, boxMax, rotated);
+	rotated[12] = 2.5f;
+	culler.Add(boxMin, boxMax, rotated);
+
+	// Box in front of the near plane of [0, 1] depth but inside [-1, 1] depth.
+	float behind[16];
+	std::copy(std::begin(identity), std::end(identity), behind);
+	behind[14] = -1.5f;
+	culler.Add(boxMin, boxMax, behind);
+
+	culler.Cull();
+	assert(culler.IsVisible(0));
+	assert(!culler.IsVisible(1));
+	assert(culler.IsVisible(2));
+
+	culler.SetViewProjection(identity, true);
+	culler.Cull();
+	assert(!culler.IsVisible(2));
+
+	printf("\n[Success] Test_FrustumCuller\n");
+}
+
+void Test_DynamicAABBTree()
+{
+	cdtools::PerformanceProfiler perf("Test_DynamicAABBTree");
+
+	struct Box
+	{
+		float min[3];
+		float max[3];
+		uint32_t proxy = DynamicAABBTree::NullNode;
+	};
+
+	std::mt19937 randomEngine(0);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	auto RandomBox = [&](Box& box)
+	{
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			float center = distribution(randomEngine) * 100.0f;
+			float extent = distribution(randomEngine) + 1.5f;
+			box.min[axis] = center - extent;
+			box.max[axis] = center + extent;
+		}
+	};
+
+	constexpr uint32_t boxCount = 4096;
+	std::vector<Box> boxes(boxCount);
+	DynamicAABBTree tree;
+	for (uint32_t index = 0; index < boxCount; ++index)
+	{
+		RandomBox(boxes[index]);
+		boxes[index].proxy = tree.CreateProxy(boxes[index].min, boxes[index].max, static_cast<Entity>(index));
+	}
+	assert(boxCount == tree.GetProxyCount());
+
+	// Move every other box far away, which reinserts it, and destroy every fourth one.
+	for (uint32_t index = 0; index < boxCount; index += 2)
+	{
+		RandomBox(boxes[index]);
+		assert(tree.MoveProxy(boxes[index].proxy, boxes[index].min, boxes[index].max));
+	}
+	for (uint32_t index = 1; index < boxCount; index += 4)
+	{
+		tree.DestroyProxy(boxes[index].proxy);
+		boxes[index].proxy = DynamicAABBTree::NullNode;
+	}
+	assert(boxCount - boxCount / 4 == tree.GetProxyCount());
+
+	// A small move stays inside the fat box.
+	Box& movedBox = boxes[0];
+	movedBox.min[0] += 0.01f;
+	movedBox.max[0] += 0.01f;
+	assert(!tree.MoveProxy(movedBox.proxy, movedBox.min, movedBox.max));
+
+	// Rotations keep the tree close to log2(3072) = 11.6 levels.
+	assert(tree.GetHeight() <= 24);
+
+	auto Overlaps = [](const float* pMinA, const float* pMaxA, const float* pMinB, const float* pMaxB)
+	{
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			if (pMaxA[axis] < pMinB[axis] || pMaxB[axis] < pMinA[axis])
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	for (uint32_t queryIndex = 0; queryIndex < 64; ++queryIndex)
+	{
+		Box queryBox;
+		RandomBox(queryBox);
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			queryBox.min[axis] -= 10.0f;
+			queryBox.max[axis] += 10.0f;
+		}
+
+		std::set<Entity> expectedEntities;
+		for (uint32_t index = 0; index < boxCount; ++index)
+		{
+			uint32_t proxy = boxes[index].proxy;
+			if (proxy != DynamicAABBTree::NullNode && Overlaps(tree.GetFatMin(proxy), tree.GetFatMax(proxy), queryBox.min, queryBox.max))
+			{
+				expectedEntities.insert(static_cast<Entity>(index));
+			}
+		}
+
+		std::set<Entity> entities;
+		tree.QueryBox(queryBox.min, queryBox.max, [&entities](Entity entity) { assert(entities.insert(entity).second); });
+		assert(expectedEntities == entities);
+	}
+
+	// Closest hit along +x from the left side of the scene. Leaves clip the ray with their exact boxes.
+	for (uint32_t queryIndex = 0; queryIndex < 64; ++queryIndex)
+	{
+		const float origin[3] = { -200.0f, distribution(randomEngine) * 100.0f, distribution(randomEngine) * 100.0f };
+		const float direction[3] = { 1.0f, 0.0f, 0.0f };
+		auto HitDistance = [&](const Box& box)
+		{
+			bool isHit = box.min[1] <= origin[1] && origin[1] <= box.max[1] && box.min[2] <= origin[2] && origin[2] <= box.max[2];
+			return isHit ? box.min[0] - origin[0] : FLT_MAX;
+		};
+
+		float expectedDistance = FLT_MAX;
+		for (const Box& box : boxes)
+		{
+			if (box.proxy != DynamicAABBTree::NullNode)
+			{
+				expectedDistance = std::min(expectedDistance, HitDistance(box));
+			}
+		}
+
+		float nearestDistance = FLT_MAX;
+		tree.QueryRay(origin, direction, FLT_MAX, [&](Entity entity, float maxDistance)
+		{
+			float distance = HitDistance(boxes[entity]);
+			nearestDistance = std::min(nearestDistance, distance);
+			return std::min(maxDistance, distance);
+		});
+		assert(expectedDistance == nearestDistance);
+	}
+
+	// Frustum is the [-50, 50] cube.
+	constexpr float scale = 1.0f / 50.0f;
+	constexpr float viewProjection[16] = { scale, 0.0f, 0.0f, 0.0f, 0.0f, scale, 0.0f, 0.0f, 0.0f, 0.0f, scale, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+	FrustumCuller frustum;
+	frustum.SetViewProjection(viewProjection, false);
+	const float frustumMin[3] = { -50.0f, -50.0f, -50.0f };
+	const float frustumMax[3] = { 50.0f, 50.0f, 50.0f };
+	std::set<Entity> expectedEntities;
+	for (uint32_t index = 0; index < boxCount; ++index)
+	{
+		uint32_t proxy = boxes[index].proxy;
+		if (proxy != DynamicAABBTree::NullNode && Overlaps(tree.GetFatMin(proxy), tree.GetFatMax(proxy), frustumMin, frustumMax))
+		{
+			expectedEntities.insert(static_cast<Entity>(index));
+		}
+	}
+	std::set<Entity> entities;
+	tree.QueryFrustum(frustum, [&entities](Entity entity) { assert(entities.insert(entity).second); });
+	assert(expectedEntities == entities);
+	assert(!entities.empty() && entities.size() < tree.GetProxyCount());
+
+	for (uint32_t index = 0; index < boxCount; ++index)
+	{
+		if (boxes[index].proxy != DynamicAABBTree::NullNode)
+		{
+			tree.DestroyProxy(boxes[index].proxy);
+		}
+	}
+	assert(0 == tree.GetProxyCount() && 0 == tree.GetHeight());
+
+	printf("\n[Success] Test_DynamicAABBTree\n");
+}
+
+void Test_AnimationKeyCursor()
+{
+	cdtools::PerformanceProfiler perf("Test_AnimationKeyCursor");
+
+	struct Key
+	{
+		float time;
+		float GetTime() const { return time; }
+	};
+
+	std::mt19937 randomEngine(42);
+	for (uint32_t keyCount = 2U; keyCount < 64U; ++keyCount)
+	{
+		std::vector<Key> keys;
+		for (uint32_t keyIndex = 0U; keyIndex < keyCount; ++keyIndex)
+		{
+			keys.push_back(Key{ static_cast<float>(keyIndex) * 0.5f });
+		}
+
+		// Mostly play forward, sometimes seek anywhere including before the first key and after the last one.
+		std::uniform_real_distribution<float> seekTime(-1.0f, static_cast<float>(keyCount) * 0.5f + 1.0f);
+		uint32_t cursor = 0U;
+		float time = 0.0f;
+		for (uint32_t frame = 0U; frame < 1000U; ++frame)
+		{
+			time = 0U == frame % 8U ? seekTime(randomEngine) : time + 0.3f;
+			cursor = AnimationClip::SeekKey(keys, keyCount, cursor, time);
+
+			uint32_t expectedCursor = 0U;
+			while (expectedCursor < keyCount - 2U && keys[expectedCursor + 1U].time <= time)
+			{
+				++expectedCursor;
+			}
+			assert(expectedCursor == cursor);
+		}
+	}
+
+	printf("\n[Success] Test_AnimationKeyCursor\n");
+}
+
+struct TestAnimationTrack
+{
+	template<typename T>
+	struct Key
+	{
+		float time;
+		T value;
+		float GetTime() const { return time; }
+		const T& GetValue() const { return value; }
+	};
+
+	std::vector<Key<cd::Vec3f>> translationKeys;
+	std::vector<Key<cd::Quaternion>> rotationKeys;
+	std::vector<Key<cd::Vec3f>> scaleKeys;
+
+	const std::vector<Key<cd::Vec3f>>& GetTranslationKeys() const { return translationKeys; }
+	uint32_t GetTranslationKeyCount() const { return static_cast<uint32_t>(translationKeys.size()); }
+	const std::vector<Key<cd::Quaternion>>& GetRotationKeys() const { return rotationKeys; }
+	uint32_t GetRotationKeyCount() const { return static_cast<uint32_t>(rotationKeys.size()); }
+	const std::vector<Key<cd::Vec3f>>& GetScaleKeys() const { return scaleKeys; }
+	uint32_t GetScaleKeyCount() const { return static_cast<uint32_t>(scaleKeys.size()); }
+};
+
+void Test_AnimationClip()
+{
+	cdtools::PerformanceProfiler perf("Test_AnimationClip");
+
+	// Track 0 : linear translation, random rotations, constant scale. Track 1 : no keys.
+	constexpr uint32_t keyCount = 100U;
+	std::mt19937 randomEngine(7);
+	std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+	TestAnimationTrack tracks[2];
+	for (uint32_t keyIndex = 0U; keyIndex < keyCount; ++keyIndex)
+	{
+		float time = static_cast<float>(keyIndex);
+		tracks[0].translationKeys.push_back({ time, cd::Vec3f(time * 2.0f, -time, 5.0f) });
+		tracks[0].scaleKeys.push_back({ time, cd::Vec3f(1.0f, 2.0f, 3.0f) });
+
+		float x = component(randomEngine), y = component(randomEngine), z = component(randomEngine), w = component(randomEngine);
+		float inverseLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+		tracks[0].rotationKeys.push_back({ time, cd::Quaternion(x * inverseLength, y * inverseLength, z * inverseLength, w * inverseLength) });
+	}
+
+	AnimationClip clip = AnimationClip::Compress(tracks, 2U, static_cast<float>(keyCount - 1U));
+	assert(2U == clip.GetTrackCount());
+
+	// Linear translation keeps both ends, constant scale keeps one key, random rotations keep all keys.
+	assert(2U + keyCount + 1U == clip.GetKeyCount());
+
+	AnimationClip::TrackCursor cursor;
+	cd::Vec3f translation;
+	cd::Quaternion rotation;
+	cd::Vec3f scale;
+	for (uint32_t keyIndex = keyCount; keyIndex-- > 0U;)
+	{
+		// Backwards, so every sample seeks.
+		clip.Sample(0U, static_cast<float>(keyIndex), cursor, translation, rotation, scale);
+		const cd::Vec3f& expectedTranslation = tracks[0].translationKeys[keyIndex].value;
+		assert(std::abs(translation.x() - expectedTranslation.x()) < 0.01f && std::abs(translation.y() - expectedTranslation.y()) < 0.01f);
+		assert(std::abs(translation.z() - 5.0f) < 0.0001f);
+		assert(std::abs(scale.x() - 1.0f) < 0.0001f && std::abs(scale.y() - 2.0f) < 0.0001f && std::abs(scale.z() - 3.0f) < 0.0001f);
+
+		const cd::Quaternion& expectedRotation = tracks[0].rotationKeys[keyIndex].value;
+		float dot = rotation.x() * expectedRotation.x() + rotation.y() * expectedRotation.y() +
+			rotation.z() * expectedRotation.z() + rotation.w() * expectedRotation.w();
+		assert(std::abs(dot) > 0.9999f);
+	}
+
+	clip.Sample(1U, 10.0f, cursor, translation, rotation, scale);
+	assert(0.0f == translation.x() && 1.0f == rotation.w() && 1.0f == scale.y());
+
+	printf("\n[Success] Test_AnimationClip\n");
+}
+
+void Test_SkinningKernel()
+{
+	cdtools::PerformanceProfiler perf("Test_SkinningKernel");
+
+	// Rigid bones with a uniform scale, so skinned normals only need to be normalized.
+	constexpr uint32_t boneCount = 8U;
+	std::mt19937 randomEngine(3);
+	std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+	std::vector<float> palette(boneCount * 16U);
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		float x = component(randomEngine), y = component(randomEngine), z = component(randomEngine), w = component(randomEngine);
+		float inverseLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+		x *= inverseLength; y *= inverseLength; z *= inverseLength; w *= inverseLength;
+		float scale = 1.0f + 0.5f * component(randomEngine);
+
+		float* pMatrix = &palette[boneIndex * 16U];
+		const float rotation[9] = {
+			1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y),
+			2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x),
+			2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y) };
+		for (uint32_t column = 0U; column < 3U; ++column)
+		{
+			for (uint32_t row = 0U; row < 3U; ++row)
+			{
+				pMatrix[column * 4U + row] = rotation[column * 3U + row] * scale;
+			}
+			pMatrix[column * 4U + 3U] = 0.0f;
+		}
+		pMatrix[12] = 5.0f * component(randomEngine);
+		pMatrix[13] = 5.0f * component(randomEngine);
+		pMatrix[14] = 5.0f * component(randomEngine);
+		pMatrix[15] = 1.0f;
+	}
+
+	// More than one vertex range. Unused influences point to a bone out of the palette.
+	constexpr uint32_t vertexCount = SkinningKernel::VertexRangeSize * 2U + 17U;
+	constexpr uint32_t influenceCount = SkinningKernel::InfluenceCount;
+	std::uniform_int_distribution<uint32_t> boneDistribution(0U, boneCount - 1U);
+	std::vector<float> positions(vertexCount * 3U);
+	std::vector<float> normals(vertexCount * 3U);
+	std::vector<uint16_t> boneIndices(vertexCount * influenceCount);
+	std::vector<float> boneWeights(vertexCount * influenceCount);
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		for (uint32_t axis = 0U; axis < 3U; ++axis)
+		{
+			positions[vertexIndex * 3U + axis] = 2.0f * component(randomEngine);
+			normals[vertexIndex * 3U + axis] = component(randomEngine);
+		}
+
+		uint32_t usedInfluenceCount = 1U + vertexIndex % influenceCount;
+		float weightSum = 0.0f;
+		for (uint32_t influence = 0U; influence < influenceCount; ++influence)
+		{
+			bool isUsed = influence < usedInfluenceCount;
+			boneIndices[vertexIndex * influenceCount + influence] = static_cast<uint16_t>(isUsed ? boneDistribution(randomEngine) : 127U);
+			boneWeights[vertexIndex * influenceCount + influence] = isUsed ? 1.5f + component(randomEngine) : 0.0f;
+			weightSum += boneWeights[vertexIndex * influenceCount + influence];
+		}
+		for (uint32_t influence = 0U; influence < influenceCount; ++influence)
+		{
+			boneWeights[vertexIndex * influenceCount + influence] /= weightSum;
+		}
+	}
+
+	SkinningKernel skinning;
+	skinning.Build(positions, normals, boneIndices, boneWeights);
+	assert(skinning.IsValid() && skinning.HasNormals());
+	assert(vertexCount == skinning.GetVertexCount() && 3U == skinning.GetVertexRangeCount());
+	assert(boneCount == skinning.GetPaletteSize());
+	skinning.Skin(palette.data());
+
+	float boundsMin[3];
+	float boundsMax[3];
+	bool hasBounds = skinning.ComputeBounds(palette.data(), boundsMin, boundsMax);
+	assert(hasBounds);
+
+	const std::vector<float>& skinnedPositions = skinning.GetSkinnedPositions();
+	const std::vector<float>& skinnedNormals = skinning.GetSkinnedNormals();
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		// Blend transformed vertices instead of matrices.
+		double expectedPosition[3] = {};
+		double expectedNormal[3] = {};
+		for (uint32_t influence = 0U; influence < influenceCount; ++influence)
+		{
+			double weight = boneWeights[vertexIndex * influenceCount + influence];
+			if (0.0 == weight)
+			{
+				continue;
+			}
+
+			const float* pMatrix = &palette[boneIndices[vertexIndex * influenceCount + influence] * 16U];
+			for (uint32_t row = 0U; row < 3U; ++row)
+			{
+				double position = pMatrix[12U + row];
+				double normal = 0.0;
+				for (uint32_t column = 0U; column < 3U; ++column)
+				{
+					position += static_cast<double>(pMatrix[column * 4U + row]) * positions[vertexIndex * 3U + column];
+					normal += static_cast<double>(pMatrix[column * 4U + row]) * normals[vertexIndex * 3U + column];
+				}
+				expectedPosition[row] += weight * position;
+				expectedNormal[row] += weight * normal;
+			}
+		}
+
+		double normalLength = std::sqrt(expectedNormal[0] * expectedNormal[0] + expectedNormal[1] * expectedNormal[1] + expectedNormal[2] * expectedNormal[2]);
+		for (uint32_t axis = 0U; axis < 3U; ++axis)
+		{
+			float position = skinnedPositions[vertexIndex * 3U + axis];
+			assert(std::abs(position - expectedPosition[axis]) < 0.001);
+			assert(position >= boundsMin[axis] - 0.001f && position <= boundsMax[axis] + 0.001f);
+			assert(normalLength < 0.001 || std::abs(skinnedNormals[vertexIndex * 3U + axis] - expectedNormal[axis] / normalLength) < 0.001);
+		}
+	}
+
+	printf("\n[Success] Test_SkinningKernel\n");
+}
+
 }
 
 int main()
@@ -195,6 +1251,22 @@ int main()
 	std::vector<Entity> meshEntites = Test_CreateEntityComponents(world, factory);
 	Test_RemoveEntityComponentsRandly(factory, meshEntites);
 	Test_RemoveEntityComponentsByOrder(factory, meshEntites);
+	Test_View(world, factory);
+	Test_ComponentSignature(world, factory, meshEntites);
+	Test_RecycleEntity();
+	Test_EntityCommandBuffer();
+	Test_Hierarchy();
+	Test_HierarchyDestroy();
+	Test_HierarchyWorldMatrix();
+	Test_TransformBatch();
+	Test_TransformBuildParity();
+	Test_ChangeTracking();
+	Test_SparseEntityLookup();
+	Test_FrustumCuller();
+	Test_DynamicAABBTree();
+	Test_AnimationKeyCursor();
+	Test_AnimationClip();
+	Test_SkinningKernel();
 
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,281 @@
+#include "ECWorld/HierarchyComponent.h"
+#include "ECWorld/TransformComponent.h"
+#include "ECWorld/TransformSystem.hpp"
+#include "ECWorld/World.h"
+
+#include <json/json.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Usage : ECWorldBenchmark [output.json] [maxEntityCount]
+// Every benchmark splits its operations into chunks and times each chunk, then reports median and p95 of ns per operation.
+namespace
+{
+
+using namespace engine;
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+// Small plain component so that iteration measures storage overhead instead of component copies.
+struct VelocityComponent
+{
+	float x = 0.0f;
+	float y = 0.0f;
+	float z = 0.0f;
+};
+
+constexpr size_t ChunkOperationCount = 1024;
+constexpr uint32_t UpdateRoundCount = 16;
+
+class Samples
+{
+public:
+	void Add(Clock::duration duration, size_t operationCount)
+	{
+		double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+		m_nsPerOperation.push_back(ns / static_cast<double>(operationCount));
+		m_operationCount += operationCount;
+	}
+
+	double GetPercentile(double percentile)
+	{
+		if (m_nsPerOperation.empty())
+		{
+			return 0.0;
+		}
+
+		std::sort(m_nsPerOperation.begin(), m_nsPerOperation.end());
+		size_t index = static_cast<size_t>(percentile * static_cast<double>(m_nsPerOperation.size() - 1) + 0.5);
+		return m_nsPerOperation[index];
+	}
+
+	size_t GetOperationCount() const { return m_operationCount; }
+	size_t GetChunkCount() const { return m_nsPerOperation.size(); }
+
+private:
+	std::vector<double> m_nsPerOperation;
+	size_t m_operationCount = 0;
+};
+
+// func(beginIndex, endIndex) runs operations in the range.
+template<typename Func>
+Samples Measure(size_t operationCount, Func&& func)
+{
+	Samples samples;
+	for (size_t beginIndex = 0; beginIndex < operationCount; beginIndex += ChunkOperationCount)
+	{
+		size_t endIndex = std::min(beginIndex + ChunkOperationCount, operationCount);
+		Clock::time_point startTime = Clock::now();
+		func(beginIndex, endIndex);
+		samples.Add(Clock::now() - startTime, endIndex - beginIndex);
+	}
+	return samples;
+}
+
+// Keep results observable so that the compiler can't drop measured loops.
+volatile uint64_t g_sink = 0;
+
+class Benchmark
+{
+public:
+	explicit Benchmark(size_t entityCount) : m_entityCount(entityCount), m_randomEngine(static_cast<uint32_t>(entityCount)) {}
+
+	void Run(json& results)
+	{
+		World world;
+		ComponentsStorage<HierarchyComponent>* pHierarchyStorage = world.Register<HierarchyComponent>();
+		ComponentsStorage<TransformComponent>* pTransformStorage = world.Register<TransformComponent>();
+		ComponentsStorage<VelocityComponent>* pVelocityStorage = world.Register<VelocityComponent>();
+
+		std::vector<Entity> entities(m_entityCount);
+		Report(results, "CreateEntity", Measure(m_entityCount, [&](size_t beginIndex, size_t endIndex)
+		{
+			for (size_t index = beginIndex; index < endIndex; ++index)
+			{
+				Entity entity = world.CreateEntity();
+				pTransformStorage->CreateComponent(entity);
+				pVelocityStorage->CreateComponent(entity).x = static_cast<float>(index);
+				entities[index] = entity;
+			}
+		}));
+
+		// Destroy a random half and create them again, which recycles ids and swap-removes components.
+		std::vector<Entity> shuffledEntities = entities;
+		std::shuffle(shuffledEntities.begin(), shuffledEntities.end(), m_randomEngine);
+		shuffledEntities.resize(m_entityCount / 2);
+		Report(results, "CreateDestroyChurn", Measure(shuffledEntities.size(), [&](size_t beginIndex, size_t endIndex)
+		{
+			for (size_t index = beginIndex; index < endIndex; ++index)
+			{
+				world.DestroyEntity(shuffledEntities[index]);
+				Entity entity = world.CreateEntity();
+				pTransformStorage->CreateComponent(entity);
+				pVelocityStorage->CreateComponent(entity);
+				shuffledEntities[index] = entity;
+			}
+		}));
+		entities = pVelocityStorage->GetEntities();
+
+		shuffledEntities = entities;
+		std::shuffle(shuffledEntities.begin(), shuffledEntities.end(), m_randomEngine);
+		Report(results, "RandomGetComponent", Measure(m_entityCount, [&](size_t beginIndex, size_t endIndex)
+		{
+			float sum = 0.0f;
+			for (size_t index = beginIndex; index < endIndex; ++index)
+			{
+				sum += pVelocityStorage->GetComponent(shuffledEntities[index])->x;
+			}
+			g_sink = g_sink + static_cast<uint64_t>(sum);
+		}));
+
+		// Every other entity has a HierarchyComponent so the View filters half of candidates.
+		// Hierarchy links : entity i is a child of entity (i - 1) / 4, which builds a 4-ary tree.
+		TransformSystem transformSystem(&world);
+		for (size_t index = 0; index < m_entityCount; index += 2)
+		{
+			pHierarchyStorage->CreateComponent(entities[index]);
+		}
+
+		auto view = world.View<VelocityComponent, TransformComponent, HierarchyComponent>();
+		Report(results, "View3Iteration", Measure(view.GetCandidateCount(), [&](size_t beginIndex, size_t endIndex)
+		{
+			view.Each(beginIndex, endIndex, [](Entity, VelocityComponent& velocity, TransformComponent&, HierarchyComponent&)
+			{
+				velocity.y += velocity.x;
+			});
+		}));
+
+		Report(results, "HierarchySetParent", Measure(m_entityCount - 1, [&](size_t beginIndex, size_t endIndex)
+		{
+			for (size_t index = beginIndex + 1; index < endIndex + 1; ++index)
+			{
+				transformSystem.SetParent(entities[index], entities[(index - 1) / 4]);
+			}
+		}));
+
+		// Walk whole subtrees of depth 2 nodes, which covers all entities below them in pre-order.
+		std::vector<Entity> subtreeRoots;
+		transformSystem.ForEachChild(entities[0], [&](Entity child)
+		{
+			transformSystem.ForEachChild(child, [&subtreeRoots](Entity grandChild) { subtreeRoots.push_back(grandChild); });
+		});
+		Samples walkSamples;
+		for (Entity subtreeRoot : subtreeRoots)
+		{
+			size_t visitedCount = 0;
+			Clock::time_point startTime = Clock::now();
+			transformSystem.ForEachInSubtree(subtreeRoot, [&visitedCount](Entity) { ++visitedCount; });
+			walkSamples.Add(Clock::now() - startTime, visitedCount);
+		}
+		Report(results, "HierarchySubtreeWalk", walkSamples);
+
+		// SetParent marked every child dirty, rebuild all world matrices once before timing partial updates.
+		transformSystem.BuildAll();
+		transformSystem.Update();
+
+		// Depth 2 subtrees together cover almost the whole tree and are built in parallel.
+		Samples subtreeUpdateSamples;
+		for (uint32_t round = 0; round < UpdateRoundCount; ++round)
+		{
+			for (Entity subtreeRoot : subtreeRoots)
+			{
+				transformSystem.MarkDirty(subtreeRoot);
+			}
+
+			Clock::time_point startTime = Clock::now();
+			transformSystem.BuildAll();
+			transformSystem.Update();
+			subtreeUpdateSamples.Add(Clock::now() - startTime, m_entityCount);
+		}
+		Report(results, "TransformUpdateSubtrees", subtreeUpdateSamples);
+
+		// Random edits may be nested, a dirty ancestor covers dirty descendants.
+		std::uniform_int_distribution<size_t> entityDistribution(0, m_entityCount - 1);
+		Samples randomUpdateSamples;
+		for (uint32_t round = 0; round < UpdateRoundCount; ++round)
+		{
+			for (size_t index = 0; index < ChunkOperationCount; ++index)
+			{
+				transformSystem.MarkDirty(entities[entityDistribution(m_randomEngine)]);
+			}
+
+			Clock::time_point startTime = Clock::now();
+			transformSystem.BuildAll();
+			transformSystem.Update();
+			randomUpdateSamples.Add(Clock::now() - startTime, ChunkOperationCount);
+		}
+		Report(results, "TransformRandomDirty", randomUpdateSamples);
+		g_sink = g_sink + static_cast<uint64_t>(pTransformStorage->GetComponent(entities[m_entityCount - 1])->GetWorldMatrix().Begin()[12]);
+
+		// World destroy callbacks unlink the hierarchy.
+		std::shuffle(entities.begin(), entities.end(), m_randomEngine);
+		Report(results, "DestroyEntity", Measure(m_entityCount, [&](size_t beginIndex, size_t endIndex)
+		{
+			for (size_t index = beginIndex; index < endIndex; ++index)
+			{
+				world.DestroyEntity(entities[index]);
+			}
+		}));
+		assert(0 == world.GetEntityCount());
+	}
+
+private:
+	void Report(json& results, const char* pName, Samples samples)
+	{
+		double median = samples.GetPercentile(0.5);
+		double p95 = samples.GetPercentile(0.95);
+		printf("%-24s %10zu entities : median %10.2f ns/op, p95 %10.2f ns/op\n", pName, m_entityCount, median, p95);
+
+		json result;
+		result["name"] = pName;
+		result["entityCount"] = m_entityCount;
+		result["operationCount"] = samples.GetOperationCount();
+		result["chunkCount"] = samples.GetChunkCount();
+		result["medianNsPerOp"] = median;
+		result["p95NsPerOp"] = p95;
+		results.push_back(cd::MoveTemp(result));
+	}
+
+private:
+	size_t m_entityCount;
+	std::mt19937 m_randomEngine;
+};
+
+}
+
+int main(int argc, char** argv)
+{
+	const char* pOutputPath = argc > 1 ? argv[1] : "ECWorldBenchmark.json";
+	size_t maxEntityCount = argc > 2 ? std::stoul(argv[2]) : 1000000;
+
+	json results = json::array();
+	for (size_t entityCount : { 10000, 100000, 1000000 })
+	{
+		if (entityCount <= maxEntityCount)
+		{
+			Benchmark(entityCount).Run(results);
+		}
+	}
+
+	json output;
+	output["benchmark"] = "ECWorld";
+	output["results"] = cd::MoveTemp(results);
+
+	std::ofstream outputFile(pOutputPath);
+	if (!outputFile.is_open())
+	{
+		printf("Failed to write %s\n", pOutputPath);
+		return 1;
+	}
+	outputFile << output.dump(4);
+	printf("Results are written to %s\n", pOutputPath);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,427 @@
+#include "Rendering/RenderGraphCompiler.hpp"
+#include "Rendering/RenderQueue.hpp"
+#include "Utilities/PerformanceProfiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using namespace engine;
+
+void Test_RenderQueueKey()
+{
+	cdtools::PerformanceProfiler perf("Test_RenderQueueKey");
+
+	// Depth encoding keeps the order of non negative distances.
+	assert(RenderQueue::EncodeDepth(-1.0f) == 0U);
+	assert(RenderQueue::EncodeDepth(0.0f) == 0U);
+	assert(RenderQueue::EncodeDepth(0.5f) < RenderQueue::EncodeDepth(1.0f));
+	assert(RenderQueue::EncodeDepth(1.0f) < RenderQueue::EncodeDepth(1000.0f));
+	assert(RenderQueue::EncodeDepth(1.0e30f) < (1ULL << RenderQueue::DepthBitCount));
+
+	// Program has the highest priority, then render state, then material, then depth.
+	constexpr uint64_t materialA = 0x1000000000000000ULL;
+	constexpr uint64_t materialB = 0x2000000000000000ULL;
+	assert(RenderQueue::MakeKey(1, 0, materialB, 100.0f) < RenderQueue::MakeKey(2, 0, materialA, 1.0f));
+	assert(RenderQueue::MakeKey(1, 0, materialB, 100.0f) < RenderQueue::MakeKey(1, 1, materialA, 1.0f));
+	assert(RenderQueue::MakeKey(1, 1, materialA, 100.0f) < RenderQueue::MakeKey(1, 1, materialB, 1.0f));
+	assert(RenderQueue::MakeKey(1, 1, materialA, 1.0f) < RenderQueue::MakeKey(1, 1, materialA, 2.0f));
+
+	// Out of range state bits don't leak into the program.
+	assert(RenderQueue::MakeKey(1, 0xFF, 0, 0.0f) >> (64U - 16U) == 1U);
+
+	printf("\n[Success] Test_RenderQueueKey\n");
+}
+
+void Test_RenderQueueSort()
+{
+	cdtools::PerformanceProfiler perf("Test_RenderQueueSort");
+
+	std::mt19937 generator(7);
+	std::uniform_int_distribution<uint32_t> programDistribution(0, 7);
+	std::uniform_int_distribution<uint32_t> stateDistribution(0, 3);
+	std::uniform_int_distribution<uint64_t> materialDistribution(0, 31);
+	std::uniform_real_distribution<float> depthDistribution(-10.0f, 1000.0f);
+
+	RenderQueue queue;
+	for (uint32_t round = 0; round < 3; ++round)
+	{
+		queue.Clear();
+		assert(queue.GetCount() == 0);
+
+		constexpr uint32_t drawCount = 10000;
+		std::vector<RenderQueue::DrawItem> expected;
+		for (uint32_t index = 0; index < drawCount; ++index)
+		{
+			uint64_t key = RenderQueue::MakeKey(static_cast<uint16_t>(programDistribution(generator)),
+				static_cast<uint8_t>(stateDistribution(generator)),
+				materialDistribution(generator) << 59U, depthDistribution(generator));
+			queue.Add(key, index);
+			expected.push_back(RenderQueue::DrawItem{ key, index });
+		}
+		assert(queue.GetCount() == drawCount);
+
+		queue.Sort();
+		std::stable_sort(expected.begin(), expected.end(), [](const RenderQueue::DrawItem& lhs, const RenderQueue::DrawItem& rhs)
+		{
+			return lhs.key < rhs.key;
+		});
+
+		const std::vector<RenderQueue::DrawItem>& items = queue.GetItems();
+		for (uint32_t index = 0; index < drawCount; ++index)
+		{
+			assert(items[index].key == expected[index].key);
+			assert(items[index].index == expected[index].index);
+		}
+	}
+
+	// Same keys keep insertion order.
+	queue.Clear();
+	for (uint32_t index = 0; index < 100; ++index)
+	{
+		queue.Add(42U, index);
+	}
+	queue.Sort();
+	for (uint32_t index = 0; index < 100; ++index)
+	{
+		assert(queue.GetItems()[index].index == index);
+	}
+
+	printf("\n[Success] Test_RenderQueueSort\n");
+}
+
+void Test_RenderGraphCull()
+{
+	cdtools::PerformanceProfiler perf("Test_RenderGraphCull");
+
+	// Scene passes draw to one render target, a copy of it is read by post process and bloom.
+	RenderGraphCompiler graph;
+	uint32_t sceneTarget = graph.AddResource();
+	uint32_t sceneCopy = graph.AddResource();
+	uint32_t emissiveCopy = graph.AddResource();
+	uint32_t debugTarget = graph.AddResource();
+	graph.MarkOutput(sceneTarget);
+
+	uint32_t skyPass = graph.AddPass({ 0 });
+	graph.AddWrite(skyPass, sceneTarget);
+	uint32_t worldPass = graph.AddPass({ 1 });
+	graph.AddWrite(worldPass, sceneTarget);
+	uint32_t debugPass = graph.AddPass({ 2 });
+	graph.AddWrite(debugPass, debugTarget);
+	uint32_t blitPass = graph.AddPass({ 3 });
+	graph.AddRead(blitPass, sceneTarget);
+	graph.AddWrite(blitPass, sceneCopy);
+	graph.AddWrite(blitPass, emissiveCopy);
+	uint32_t bloomPass = graph.AddPass({ 4, 7, 8 });
+	graph.AddRead(bloomPass, sceneCopy);
+	graph.AddRead(bloomPass, emissiveCopy);
+	graph.AddWrite(bloomPass, sceneTarget);
+	uint32_t postProcessPass = graph.AddPass({ 5 });
+	graph.AddRead(postProcessPass, sceneCopy);
+	graph.AddWrite(postProcessPass, sceneTarget);
+
+	// Debug output is never read and bloom is disabled.
+	graph.SetPassEnable(bloomPass, false);
+	graph.Compile();
+	assert((graph.GetPassOrder() == std::vector<uint32_t>{ skyPass, worldPass, blitPass, postProcessPass }));
+	assert(!graph.IsPassLive(debugPass));
+	assert(!graph.IsPassLive(bloomPass));
+	assert(!graph.IsPassEnable(bloomPass));
+
+	// Views of culled passes are moved after live ones.
+	assert((graph.GetViewOrder() == std::vector<uint16_t>{ 0, 1, 3, 5, 2, 4, 7, 8 }));
+
+	graph.SetPassEnable(bloomPass, true);
+	graph.Compile();
+	assert((graph.GetPassOrder() == std::vector<uint32_t>{ skyPass, worldPass, blitPass, bloomPass, postProcessPass }));
+	assert((graph.GetViewOrder() == std::vector<uint16_t>{ 0, 1, 3, 4, 7, 8, 5, 2 }));
+
+	// Copies are not needed without post process and bloom.
+	graph.SetPassEnable(bloomPass, false);
+	graph.SetPassEnable(postProcessPass, false);
+	graph.Compile();
+	assert((graph.GetPassOrder() == std::vector<uint32_t>{ skyPass, worldPass }));
+	assert(!graph.IsPassLive(blitPass));
+
+	printf("\n[Success] Test_RenderGraphCull\n");
+}
+
+void Test_RenderGraphAlias()
+{
+	cdtools::PerformanceProfiler perf("Test_RenderGraphAlias");
+
+	// A chain of full screen passes : output <- c <- b <- a. The output pass also uses its own scratch target.
+	RenderGraphCompiler graph;
+	uint32_t output = graph.AddResource();
+	uint32_t a = graph.AddResource(1U);
+	uint32_t b = graph.AddResource(1U);
+	uint32_t c = graph.AddResource(1U);
+	uint32_t d = graph.AddResource(2U);
+	uint32_t scratch = graph.AddResource(1U);
+	graph.MarkOutput(output);
+
+	uint32_t passA = graph.AddPass({ 0 });
+	graph.AddWrite(passA, a);
+	uint32_t passB = graph.AddPass({ 1 });
+	graph.AddRead(passB, a);
+	graph.AddWrite(passB, b);
+	uint32_t passC = graph.AddPass({ 2 });
+	graph.AddRead(passC, b);
+	graph.AddWrite(passC, c);
+	uint32_t passD = graph.AddPass({ 3 });
+	graph.AddRead(passD, c);
+	graph.AddWrite(passD, d);
+	uint32_t passOutput = graph.AddPass({ 4 });
+	graph.AddRead(passOutput, d);
+	graph.AddWrite(passOutput, output);
+	graph.AddWrite(passOutput, scratch);
+	graph.Compile();
+	assert(graph.GetPassOrder().size() == 5);
+
+	// a is dead when c is written, resources read and written by one pass never alias.
+	assert(graph.GetPhysicalIndex(a) != graph.GetPhysicalIndex(b));
+	assert(graph.GetPhysicalIndex(b) != graph.GetPhysicalIndex(c));
+	assert(graph.GetPhysicalIndex(a) == graph.GetPhysicalIndex(c));
+
+	// Different descriptions never alias.
+	assert(graph.GetPhysicalIndex(d) != graph.GetPhysicalIndex(a));
+	assert(graph.GetPhysicalIndex(d) != graph.GetPhysicalIndex(b));
+	assert(graph.GetPhysicalAliasKey(graph.GetPhysicalIndex(d)) == 2U);
+
+	// Nothing reads the scratch target, but the live pass writing it needs a render target. c is dead by then.
+	assert(graph.GetPhysicalIndex(scratch) != RenderGraphCompiler::InvalidIndex);
+	assert(graph.GetPhysicalIndex(scratch) == graph.GetPhysicalIndex(c));
+	assert(graph.GetPhysicalCount() == 3U);
+
+	printf("\n[Success] Test_RenderGraphAlias\n");
+}
+
+void Test_RenderGraphViewOrder()
+{
+	cdtools::PerformanceProfiler perf("Test_RenderGraphViewOrder");
+
+	// View 1 belongs to editor and is not a pass view. Bloom in the middle uses two views.
+	RenderGraphCompiler graph;
+	uint32_t sceneTarget = graph.AddResource();
+	uint32_t bloomTarget = graph.AddResource();
+	graph.MarkOutput(sceneTarget);
+
+	uint32_t worldPass = graph.AddPass({ 0 });
+	graph.AddWrite(worldPass, sceneTarget);
+	uint32_t bloomPass = graph.AddPass({ 2, 5 });
+	graph.AddWrite(bloomPass, bloomTarget);
+	uint32_t postProcessPass = graph.AddPass({ 3 });
+	graph.AddRead(postProcessPass, sceneTarget);
+	graph.AddWrite(postProcessPass, sceneTarget);
+	uint32_t debugPass = graph.AddPass({ 4 });
+	graph.AddWrite(debugPass, sceneTarget);
+
+	// Nothing reads the bloom target, so the middle pass is culled and its views go last.
+	graph.Compile();
+	assert(!graph.IsPassLive(bloomPass));
+	assert((graph.GetViewOrder() == std::vector<uint16_t>{ 0, 3, 4, 2, 5 }));
+
+	std::vector<uint16_t> viewRemap;
+	graph.BuildViewRemap(6, viewRemap);
+	assert((viewRemap == std::vector<uint16_t>{ 0, 1, 3, 4, 2, 5 }));
+
+	// Walking the table gives the submission order, pass views follow execution order.
+	std::vector<uint16_t> passSubmitOrder;
+	for (uint16_t viewID : viewRemap)
+	{
+		if (viewID != 1)
+		{
+			passSubmitOrder.push_back(viewID);
+		}
+	}
+	assert(passSubmitOrder == graph.GetViewOrder());
+
+	// The table is a permutation of all views.
+	std::vector<uint16_t> sortedRemap = viewRemap;
+	std::sort(sortedRemap.begin(), sortedRemap.end());
+	assert((sortedRemap == std::vector<uint16_t>{ 0, 1, 2, 3, 4, 5 }));
+
+	// Reading the bloom target brings it back between world and post process.
+	graph.AddRead(postProcessPass, bloomTarget);
+	graph.Compile();
+	graph.BuildViewRemap(6, viewRemap);
+	assert((viewRemap == std::vector<uint16_t>{ 0, 1, 2, 5, 3, 4 }));
+
+	printf("\n[Success] Test_RenderGraphViewOrder\n");
+}
+
+void Test_RenderGraphEditorPasses()
+{
+	cdtools::PerformanceProfiler perf("Test_RenderGraphEditorPasses");
+
+	// Passes of EditorApp::InitEngineRenderers without DDGI. View 0 belongs to the editor ImGui renderer.
+	RenderGraphCompiler graph;
+	uint32_t sceneColor = graph.AddResource();
+	uint32_t sceneEmissive = graph.AddResource();
+	uint32_t sceneDepth = graph.AddResource();
+	graph.MarkOutput(sceneColor);
+
+	// Levels of bloom's sample chain have different sizes, so each one has its own alias key.
+	constexpr uint32_t sampleChainLength = 9U;
+	std::vector<uint32_t> sampleChain;
+	for (uint32_t level = 0; level < sampleChainLength; ++level)
+	{
+		sampleChain.push_back(graph.AddResource(level + 1U));
+	}
+
+	auto addPass = [&graph](std::vector<uint16_t> views, const std::vector<uint32_t>& reads, const std::vector<uint32_t>& writes)
+	{
+		uint32_t passIndex = graph.AddPass(std::move(views));
+		for (uint32_t resourceIndex : reads)
+		{
+			graph.AddRead(passIndex, resourceIndex);
+		}
+		for (uint32_t resourceIndex : writes)
+		{
+			graph.AddWrite(passIndex, resourceIndex);
+		}
+		return passIndex;
+	};
+
+	std::vector<uint32_t> scenePasses;
+	scenePasses.push_back(addPass({ 1 }, {}, { sceneColor, sceneEmissive, sceneDepth }));
+	scenePasses.push_back(addPass({ 2 }, {}, { sceneColor, sceneEmissive, sceneDepth }));
+	scenePasses.push_back(addPass({ 3 }, { sceneDepth }, { sceneColor, sceneEmissive, sceneDepth }));
+	scenePasses.push_back(addPass({ 4 }, { sceneDepth }, { sceneColor, sceneEmissive, sceneDepth }));
+	for (uint16_t viewID = 5; viewID <= 11; ++viewID)
+	{
+		scenePasses.push_back(addPass({ viewID }, { sceneDepth }, { sceneColor, sceneDepth }));
+	}
+	uint32_t whiteModelPass = scenePasses[7];
+
+	// Bloom creates 57 views in Init for its chain.
+	std::vector<uint16_t> bloomViews;
+	for (uint16_t viewID = 12; viewID <= 69; ++viewID)
+	{
+		bloomViews.push_back(viewID);
+	}
+	std::vector<uint32_t> bloomWrites = sampleChain;
+	bloomWrites.push_back(sceneColor);
+	uint32_t bloomPass = addPass(bloomViews, { sceneColor, sceneEmissive }, bloomWrites);
+	uint32_t postProcessPass = addPass({ 70 }, { sceneColor }, { sceneColor });
+	uint32_t imguiPass = addPass({ 71 }, {}, { sceneColor });
+
+	// White model and bloom are disabled by default. Bloom's chain doesn't get render targets.
+	graph.SetPassEnable(whiteModelPass, false);
+	graph.SetPassEnable(bloomPass, false);
+	graph.Compile();
+	assert(graph.GetPassOrder().size() == scenePasses.size() + 1U);
+	assert(!graph.IsPassLive(whiteModelPass));
+	assert(!graph.IsPassLive(bloomPass));
+	assert(graph.GetPassOrder().back() == imguiPass);
+	assert(graph.GetPhysicalCount() == 0U);
+	for (uint32_t resourceIndex : sampleChain)
+	{
+		assert(graph.GetPhysicalIndex(resourceIndex) == RenderGraphCompiler::InvalidIndex);
+	}
+
+	// Post process and the engine ImGui overlay are submitted right after wireframe, before culled views.
+	std::vector<uint16_t> viewRemap;
+	graph.BuildViewRemap(72, viewRemap);
+	assert(0 == viewRemap[0]);
+	assert(7 == viewRemap[7] && 9 == viewRemap[8] && 11 == viewRemap[10]);
+	assert(70 == viewRemap[11] && 71 == viewRemap[12]);
+	assert(8 == viewRemap[13] && 12 == viewRemap[14] && 69 == viewRemap[71]);
+
+	// Enabled bloom runs before post process with all its views, and every chain level gets its own render target.
+	graph.SetPassEnable(bloomPass, true);
+	graph.Compile();
+	assert(graph.IsPassLive(bloomPass));
+	assert(graph.GetPassOrder()[graph.GetPassOrder().size() - 3U] == bloomPass);
+	assert(graph.GetPhysicalCount() == sampleChainLength);
+	for (uint32_t level = 0; level < sampleChainLength; ++level)
+	{
+		uint32_t physicalIndex = graph.GetPhysicalIndex(sampleChain[level]);
+		assert(physicalIndex != RenderGraphCompiler::InvalidIndex);
+		assert(graph.GetPhysicalAliasKey(physicalIndex) == level + 1U);
+	}
+
+	graph.BuildViewRemap(72, viewRemap);
+	assert(11 == viewRemap[10]);
+	for (uint16_t position = 11; position <= 68; ++position)
+	{
+		assert(position + 1 == viewRemap[position]);
+	}
+	assert(70 == viewRemap[69] && 71 == viewRemap[70] && 8 == viewRemap[71]);
+
+	// Scene passes draw the scene color shown by SceneView, so they stay without bloom, post process and the overlay.
+	graph.SetPassEnable(bloomPass, false);
+	graph.SetPassEnable(postProcessPass, false);
+	graph.SetPassEnable(imguiPass, false);
+	graph.Compile();
+	assert(graph.GetPassOrder().size() == scenePasses.size() - 1U);
+
+	printf("\n[Success] Test_RenderGraphEditorPasses\n");
+}
+
+void Test_RenderGraphGamePasses()
+{
+	cdtools::PerformanceProfiler perf("Test_RenderGraphGamePasses");
+
+	// Passes of GameApp::InitEngineRenderers without DDGI. Post process draws the scene color to the back buffer.
+	RenderGraphCompiler graph;
+	uint32_t backBuffer = graph.AddResource();
+	uint32_t sceneColor = graph.AddResource();
+	uint32_t sceneEmissive = graph.AddResource();
+	uint32_t sceneDepth = graph.AddResource();
+	graph.MarkOutput(backBuffer);
+
+	uint32_t skyboxPass = graph.AddPass({ 0 });
+	uint32_t pbrSkyPass = graph.AddPass({ 1 });
+	for (uint32_t passIndex : { skyboxPass, pbrSkyPass })
+	{
+		graph.AddWrite(passIndex, sceneColor);
+		graph.AddWrite(passIndex, sceneEmissive);
+		graph.AddWrite(passIndex, sceneDepth);
+	}
+	uint32_t worldPass = graph.AddPass({ 2 });
+	graph.AddRead(worldPass, sceneDepth);
+	graph.AddWrite(worldPass, sceneColor);
+	graph.AddWrite(worldPass, sceneEmissive);
+	graph.AddWrite(worldPass, sceneDepth);
+	uint32_t animationPass = graph.AddPass({ 3 });
+	graph.AddRead(animationPass, sceneDepth);
+	graph.AddWrite(animationPass, sceneColor);
+	graph.AddWrite(animationPass, sceneDepth);
+	uint32_t postProcessPass = graph.AddPass({ 4 });
+	graph.AddRead(postProcessPass, sceneColor);
+	graph.AddWrite(postProcessPass, backBuffer);
+	uint32_t imguiPass = graph.AddPass({ 5 });
+	graph.AddWrite(imguiPass, backBuffer);
+
+	graph.Compile();
+	assert((graph.GetPassOrder() == std::vector<uint32_t>{ skyboxPass, pbrSkyPass, worldPass, animationPass, postProcessPass, imguiPass }));
+
+	// Nothing shows the scene color without post process, so every scene pass is culled.
+	graph.SetPassEnable(postProcessPass, false);
+	graph.Compile();
+	assert((graph.GetPassOrder() == std::vector<uint32_t>{ imguiPass }));
+	assert((graph.GetViewOrder() == std::vector<uint16_t>{ 5, 0, 1, 2, 3, 4 }));
+
+	printf("\n[Success] Test_RenderGraphGamePasses\n");
+}
+
+}
+
+int main()
+{
+	Test_RenderQueueKey();
+	Test_RenderQueueSort();
+	Test_RenderGraphCull();
+	Test_RenderGraphAlias();
+	Test_RenderGraphViewOrder();
+	Test_RenderGraphEditorPasses();
+	Test_RenderGraphGamePasses();
+
+	return 0;
+}
\ No newline at end of file